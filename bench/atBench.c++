@@ -0,0 +1,146 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdio.h>
+#include <string.h>
+#include "atBench.h++"
+
+
+atBench::atBench(int argc, char ** argv)
+{
+   int   i;
+
+   // Defaults are the full sizes, no metrics dump and everything runs
+   quick_mode = false;
+   dump_metrics = false;
+   name_filters = new char *[argc];
+   num_filters = 0;
+   start_time = 0;
+
+   // Options start with dashes; anything else selects benchmarks
+   for (i = 1; i < argc; i++)
+   {
+      if (strcmp(argv[i], "--quick") == 0)
+         quick_mode = true;
+      else if (strcmp(argv[i], "--metrics") == 0)
+         dump_metrics = true;
+      else if (argv[i][0] == '-')
+         notify(AT_WARN, "Unknown option %s (ignored).\n", argv[i]);
+      else
+      {
+         name_filters[num_filters] = argv[i];
+         num_filters++;
+      }
+   }
+}
+
+
+atBench::~atBench()
+{
+   delete [] name_filters;
+}
+
+
+bool atBench::isQuick()
+{
+   return quick_mode;
+}
+
+
+bool atBench::isDumpingMetrics()
+{
+   return dump_metrics;
+}
+
+
+u_long atBench::getSize(u_long fullSize)
+{
+   // Quick runs use a tenth of the work (but always do something)
+   if ((quick_mode) && (fullSize >= 10))
+      return fullSize / 10;
+   else
+      return fullSize;
+}
+
+
+bool atBench::shouldRun(const char * name)
+{
+   int   i;
+
+   // Everything runs if nothing was picked
+   if (num_filters == 0)
+      return true;
+
+   // Otherwise the name has to start with one of the filters
+   for (i = 0; i < num_filters; i++)
+   {
+      if (strncmp(name, name_filters[i], strlen(name_filters[i])) == 0)
+         return true;
+   }
+   return false;
+}
+
+
+void atBench::start()
+{
+   start_time = getMonotonicTime();
+}
+
+
+double atBench::stop()
+{
+   // Return the time since start() in seconds
+   return (double ) (getMonotonicTime() - start_time) / 1.0E9;
+}
+
+
+void atBench::report(const char * name, u_long operations, double seconds)
+{
+   report(name, operations, seconds, "");
+}
+
+
+void atBench::report(const char * name, u_long operations, double seconds,
+                     const char * note)
+{
+   double   nanosPerOp;
+   double   millionsPerSec;
+
+   // Don't divide by zero on a really fast (or empty) run
+   if ((operations == 0) || (seconds <= 0.0))
+   {
+      printf("%-44s %12lu ops %12s %12s  %s\n", name, operations, "-", "-",
+             note);
+      return;
+   }
+
+   // Print the time per operation and the rate
+   nanosPerOp = seconds * 1.0E9 / (double ) operations;
+   millionsPerSec = (double ) operations / seconds / 1.0E6;
+   printf("%-44s %12lu ops %9.1f ns/op %8.3f M/s  %s\n", name, operations,
+          nanosPerOp, millionsPerSec, note);
+   fflush(stdout);
+}
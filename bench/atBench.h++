@@ -0,0 +1,81 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AT_BENCH_HPP
+#define AT_BENCH_HPP
+
+
+#include "atNotifier.h++"
+#include "atOSDefs.h++"
+
+
+// Runs and reports the microbenchmarks.  Each benchmark has a dotted name
+// (e.g. "container.hashmap.insert"); names given on the command line
+// select the benchmarks to run by prefix (with none, everything runs).
+// In quick mode, benchmarks shrink their sizes to keep the run short.
+class atBench : public atNotifier
+{
+   protected:
+      bool       quick_mode;
+      bool       dump_metrics;
+
+      char **    name_filters;
+      int        num_filters;
+
+      uint64_t   start_time;
+
+   public:
+      atBench(int argc, char ** argv);
+      virtual ~atBench();
+
+      bool       isQuick();
+      bool       isDumpingMetrics();
+      u_long     getSize(u_long fullSize);
+
+      bool       shouldRun(const char * name);
+
+      void       start();
+      double     stop();
+
+      void       report(const char * name, u_long operations,
+                        double seconds);
+      void       report(const char * name, u_long operations,
+                        double seconds, const char * note);
+};
+
+
+// The benchmark suites
+void   runMathBenchmarks(atBench * bench);
+void   runContainerBenchmarks(atBench * bench);
+void   runQueueBenchmarks(atBench * bench);
+void   runNetworkBenchmarks(atBench * bench);
+void   runXMLBenchmarks(atBench * bench);
+void   runMetricsBenchmarks(atBench * bench);
+void   runTaskBenchmarks(atBench * bench);
+void   runConfigBenchmarks(atBench * bench);
+
+
+#endif
@@ -0,0 +1,201 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <stdio.h>
+#include <string.h>
+#include "atBench.h++"
+#include "atConfigFile.h++"
+
+
+#define BENCH_CONFIG_FILENAME      "atlasBench.cfg"
+#define BENCH_CONFIG_NUM_TUPLES    8
+#define BENCH_CONFIG_MAX_ARGS      16
+
+
+static void makeConfig(u_long numKeys)
+{
+   FILE *   outfile;
+   u_long   i;
+   u_long   j;
+
+   // Write a large configuration file with the usual mix of comments,
+   // plain arguments, and quoted strings, with each key's tuples spread
+   // through the file
+   outfile = fopen(BENCH_CONFIG_FILENAME, "w");
+   if (outfile == NULL)
+      return;
+   fprintf(outfile, "# Generated by atlasBench\n");
+   for (j = 0; j < BENCH_CONFIG_NUM_TUPLES; j++)
+   {
+      fprintf(outfile, "\n# Pass %lu\n", j);
+      for (i = 0; i < numKeys; i++)
+      {
+         fprintf(outfile, "entity.%lu.setting%lu\t%lu %lu.5 \"name %lu\" "
+                 "on\n", i, i % 7, j, i, i);
+      }
+   }
+   fclose(outfile);
+}
+
+
+static void makeKey(u_long i, char * key)
+{
+   // Build the key for the given entity (matching the generated file)
+   sprintf(key, "entity.%lu.setting%lu", i, i % 7);
+}
+
+
+static u_long readAll(atConfigFile * config, u_long numKeys)
+{
+   char     key[64];
+   int      argc;
+   char *   argv[BENCH_CONFIG_MAX_ARGS];
+   u_long   numTuples;
+   u_long   i;
+
+   // Read every tuple of every key, the way an application does at
+   // startup
+   numTuples = 0;
+   for (i = 0; i < numKeys; i++)
+   {
+      makeKey(i, key);
+      while (config->getNextTuple(key, &argc, argv))
+         numTuples++;
+      config->resetTupleList(key);
+   }
+
+   return numTuples;
+}
+
+
+static bool compareConfigs(atConfigFile * stream, atConfigFile * mapped,
+                           u_long numKeys)
+{
+   char     key[64];
+   int      streamArgc;
+   char *   streamArgv[BENCH_CONFIG_MAX_ARGS];
+   int      mappedArgc;
+   char *   mappedArgv[BENCH_CONFIG_MAX_ARGS];
+   bool     streamMore;
+   bool     mappedMore;
+   u_long   i;
+   int      j;
+
+   // Both modes must hand back exactly the same tuples for every key
+   for (i = 0; i < numKeys; i++)
+   {
+      makeKey(i, key);
+      do
+      {
+         streamMore = stream->getNextTuple(key, &streamArgc, streamArgv);
+         mappedMore = mapped->getNextTuple(key, &mappedArgc, mappedArgv);
+         if (streamMore != mappedMore)
+            return false;
+         if (streamMore)
+         {
+            if (streamArgc != mappedArgc)
+               return false;
+            for (j = 0; j < streamArgc; j++)
+               if (strcmp(streamArgv[j], mappedArgv[j]) != 0)
+                  return false;
+         }
+      }
+      while (streamMore);
+      stream->resetTupleList(key);
+      mapped->resetTupleList(key);
+   }
+
+   return true;
+}
+
+
+static atConfigFile * benchLoad(atBench * bench, const char * name,
+                                atConfigFileMode mode, u_long numKeys)
+{
+   atConfigFile *   config;
+   double           seconds;
+
+   // Time loading the file (reported per line)
+   bench->start();
+   config = new atConfigFile((char *) BENCH_CONFIG_FILENAME, mode);
+   seconds = bench->stop();
+   bench->report(name, numKeys * BENCH_CONFIG_NUM_TUPLES, seconds);
+
+   return config;
+}
+
+
+static void benchLookup(atBench * bench, const char * name,
+                        atConfigFile * config, u_long numKeys)
+{
+   u_long   numTuples;
+   double   seconds;
+
+   // Time reading everything back (reported per tuple)
+   bench->start();
+   numTuples = readAll(config, numKeys);
+   seconds = bench->stop();
+   bench->report(name, numTuples, seconds);
+}
+
+
+void runConfigBenchmarks(atBench * bench)
+{
+   atConfigFile *   stream;
+   atConfigFile *   mapped;
+   u_long           numKeys;
+
+   // See if there's anything to do (the file takes a while to write)
+   if ((!bench->shouldRun("config.load")) &&
+       (!bench->shouldRun("config.lookup")))
+      return;
+
+   // The streaming mode's key search is a linear list, so keep the full
+   // size to something that finishes
+   numKeys = bench->getSize(5000);
+   makeConfig(numKeys);
+
+   // Load the file both ways and make sure they agree
+   stream = benchLoad(bench, "config.load.stream", AT_CONFIG_FILE_STREAM,
+                      numKeys);
+   mapped = benchLoad(bench, "config.load.mapped", AT_CONFIG_FILE_MAPPED,
+                      numKeys);
+   if (!compareConfigs(stream, mapped, numKeys))
+      bench->notify(AT_WARN, "Mapped configuration doesn't match the "
+                    "streamed one.\n");
+
+   // Then time the lookups
+   if (bench->shouldRun("config.lookup.stream"))
+      benchLookup(bench, "config.lookup.stream", stream, numKeys);
+   if (bench->shouldRun("config.lookup.mapped"))
+      benchLookup(bench, "config.lookup.mapped", mapped, numKeys);
+
+   // Clean up
+   delete stream;
+   delete mapped;
+   remove(BENCH_CONFIG_FILENAME);
+}
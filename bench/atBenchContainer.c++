@@ -0,0 +1,349 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "atBench.h++"
+#include "atHashMap.h++"
+#include "atInt.h++"
+#include "atList.h++"
+#include "atListIterator.h++"
+#include "atMap.h++"
+#include "atNodePool.h++"
+#include "atPriorityQueue.h++"
+
+
+#define BENCH_LIST_BLOCK_SIZE   1024
+
+
+static int * getShuffledValues(u_long count)
+{
+   int *    values;
+   u_long   i;
+   u_long   j;
+   int      swap;
+
+   // Make the numbers 0 to count-1 in a random order
+   values = new int[count];
+   for (i = 0; i < count; i++)
+      values[i] = (int ) i;
+   for (i = count - 1; i > 0; i--)
+   {
+      j = (u_long ) rand() % (i + 1);
+      swap = values[i];
+      values[i] = values[j];
+      values[j] = swap;
+   }
+   return values;
+}
+
+
+static void benchMapType(atBench * bench, const char * type, u_long count,
+                         atMap * treeMap, atHashMap * hashMap)
+{
+   char       name[64];
+   int *      values;
+   int *      lookups;
+   atInt **   keys;
+   atInt      probe(0);
+   u_long     found;
+   u_long     i;
+   double     seconds;
+
+   // Build the keys ahead of time so only the map work is timed (the
+   // maps own the keys, so deleting the entries deletes them)
+   values = getShuffledValues(count);
+   lookups = getShuffledValues(count);
+   keys = new atInt *[count];
+   for (i = 0; i < count; i++)
+      keys[i] = new atInt(values[i]);
+
+   // Insert everything
+   sprintf(name, "container.%s.insert.%lu", type, count);
+   bench->start();
+   for (i = 0; i < count; i++)
+   {
+      if (treeMap != NULL)
+         treeMap->addEntry(keys[i], NULL);
+      else
+         hashMap->addEntry(keys[i], NULL);
+   }
+   seconds = bench->stop();
+   bench->report(name, count, seconds);
+
+   // Look everything up in a different order
+   sprintf(name, "container.%s.lookup.%lu", type, count);
+   found = 0;
+   bench->start();
+   for (i = 0; i < count; i++)
+   {
+      probe.setValue(lookups[i]);
+      if (treeMap != NULL)
+         found += treeMap->containsKey(&probe);
+      else
+         found += hashMap->containsKey(&probe);
+   }
+   seconds = bench->stop();
+   bench->report(name, count, seconds, (found == count) ? "" : "MISSING");
+
+   // And take it all out again
+   sprintf(name, "container.%s.remove.%lu", type, count);
+   bench->start();
+   for (i = 0; i < count; i++)
+   {
+      probe.setValue(lookups[i]);
+      if (treeMap != NULL)
+         treeMap->deleteEntry(&probe);
+      else
+         hashMap->deleteEntry(&probe);
+   }
+   seconds = bench->stop();
+   bench->report(name, count, seconds);
+
+   // Clean up
+   delete [] keys;
+   delete [] values;
+   delete [] lookups;
+}
+
+
+static void benchMaps(atBench * bench)
+{
+   u_long        maxCount;
+   u_long        count;
+   atMap *       treeMap;
+   atHashMap *   hashMap;
+
+   // The sorted tree against the hash table from a thousand entries up
+   // to a million (a hundred thousand for quick runs)
+   if (bench->isQuick())
+      maxCount = 100000;
+   else
+      maxCount = 1000000;
+   for (count = 1000; count <= maxCount; count *= 10)
+   {
+      // The red-black tree, with its nodes from the heap
+      if (bench->shouldRun("container.map."))
+      {
+         treeMap = new atMap();
+         benchMapType(bench, "map", count, treeMap, NULL);
+         delete treeMap;
+      }
+
+      // The red-black tree, with its nodes from a pool
+      if (bench->shouldRun("container.map_pooled."))
+      {
+         treeMap = new atMap(BENCH_LIST_BLOCK_SIZE);
+         benchMapType(bench, "map_pooled", count, treeMap, NULL);
+         delete treeMap;
+      }
+
+      // The open-addressing hash table
+      if (bench->shouldRun("container.hashmap."))
+      {
+         hashMap = new atHashMap();
+         benchMapType(bench, "hashmap", count, NULL, hashMap);
+         delete hashMap;
+      }
+   }
+}
+
+
+static void benchListChurn(atBench * bench, const char * name,
+                           atList * list, u_long count, u_long cycles)
+{
+   atNodePool *   pool;
+   u_long         startBlocks;
+   u_long         heapAllocations;
+   char           note[64];
+   u_long         c;
+   u_long         i;
+   double         seconds;
+
+   // A pooled list goes to the heap once per block, so see how many
+   // blocks the pool has to start with
+   pool = list->getNodePool();
+   startBlocks = 0;
+   if (pool != NULL)
+      startBlocks = pool->getNumBlocks();
+   heapAllocations = 0;
+
+   // Fill the list up and empty it again a few times (the entries don't
+   // hold items, so only the list's own allocations are measured)
+   bench->start();
+   for (c = 0; c < cycles; c++)
+   {
+      for (i = 0; i < count; i++)
+         list->addEntry(NULL);
+
+      // Without a pool, every entry in the list was its own allocation
+      if (pool == NULL)
+         heapAllocations += list->getNumEntries();
+
+      list->removeAllEntries();
+   }
+   seconds = bench->stop();
+
+   // Add up the blocks the pool allocated along the way
+   if (pool != NULL)
+      heapAllocations = pool->getNumBlocks() - startBlocks;
+
+   // Report along with how many times the list went to the heap
+   sprintf(note, "heap allocations %lu", heapAllocations);
+   bench->report(name, count * cycles, seconds, note);
+}
+
+
+static void benchLists(atBench * bench)
+{
+   atList *           list;
+   atNodePool *       pool;
+   atListIterator *   iterator;
+   u_long             count;
+   u_long             cycles;
+   u_long             i;
+   double             seconds;
+
+   // Churn through entries with each kind of allocation
+   count = bench->getSize(1000000);
+   cycles = 5;
+   if (bench->shouldRun("container.list.churn.heap"))
+   {
+      // Every entry is a separate allocation
+      list = new atList();
+      benchListChurn(bench, "container.list.churn.heap", list, count,
+                     cycles);
+      delete list;
+   }
+   if (bench->shouldRun("container.list.churn.private_pool"))
+   {
+      // The list's own pool, freed in bulk by removeAllEntries() (the
+      // blocks are allocated during the first cycle and reused after)
+      list = new atList(BENCH_LIST_BLOCK_SIZE);
+      benchListChurn(bench, "container.list.churn.private_pool", list,
+                     count, cycles);
+      delete list;
+   }
+   if (bench->shouldRun("container.list.churn.shared_pool"))
+   {
+      // A pool that could be shared with other lists (entries go back
+      // one at a time)
+      pool = new atNodePool(sizeof(atListEntry), BENCH_LIST_BLOCK_SIZE);
+      list = new atList(pool);
+      benchListChurn(bench, "container.list.churn.shared_pool", list,
+                     count, cycles);
+      delete list;
+      delete pool;
+   }
+
+   // Walk a list by index (each getNthEntry() used to start over from
+   // the head, which made this quadratic)
+   count = bench->getSize(100000);
+   list = new atList(BENCH_LIST_BLOCK_SIZE);
+   for (i = 0; i < count; i++)
+      list->addEntry(NULL);
+   if (bench->shouldRun("container.list.index_walk"))
+   {
+      bench->start();
+      for (i = 0; i < count; i++)
+         list->getNthEntry(i);
+      seconds = bench->stop();
+      bench->report("container.list.index_walk", count, seconds);
+   }
+
+   // Random positions (these walk from the closest known position)
+   if (bench->shouldRun("container.list.index_random"))
+   {
+      bench->start();
+      for (i = 0; i < 10000; i++)
+         list->getNthEntry((u_long ) rand() % count);
+      seconds = bench->stop();
+      bench->report("container.list.index_random", 10000, seconds);
+   }
+
+   // Walking with an iterator
+   if (bench->shouldRun("container.list.iterator_walk"))
+   {
+      iterator = new atListIterator(list);
+      bench->start();
+      for (i = 0; i < 10; i++)
+      {
+         iterator->getFirstEntry();
+         while (iterator->getCurrentIndex() + 1 < count)
+            iterator->getNextEntry();
+      }
+      seconds = bench->stop();
+      bench->report("container.list.iterator_walk", count * 10, seconds);
+      delete iterator;
+   }
+   delete list;
+}
+
+
+static void benchPriorityQueue(atBench * bench)
+{
+   atPriorityQueue *   queue;
+   atInt **            items;
+   u_long              count;
+   u_long              i;
+   double              seconds;
+
+   if (!bench->shouldRun("container.priority_queue"))
+      return;
+
+   // Make up the items ahead of time (the queue doesn't own them)
+   count = bench->getSize(1000000);
+   items = new atInt *[count];
+   for (i = 0; i < count; i++)
+      items[i] = new atInt(rand());
+
+   // Add them all, then take them all out in priority order
+   queue = new atPriorityQueue();
+   bench->start();
+   for (i = 0; i < count; i++)
+      queue->addEntry(items[i]);
+   while (queue->removeEntry() != NULL);
+   seconds = bench->stop();
+   bench->report("container.priority_queue.add_remove", count, seconds);
+
+   // Clean up
+   delete queue;
+   for (i = 0; i < count; i++)
+      delete items[i];
+   delete [] items;
+}
+
+
+void runContainerBenchmarks(atBench * bench)
+{
+   // Same data every run
+   srand(2);
+
+   // Maps, lists and the heap
+   benchMaps(bench);
+   benchLists(bench);
+   benchPriorityQueue(bench);
+}
@@ -0,0 +1,62 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdio.h>
+#include "atBench.h++"
+#include "atMetrics.h++"
+
+
+int main(int argc, char ** argv)
+{
+   atBench *   bench;
+
+   // Usage: atlasBench [--quick] [--metrics] [benchmark prefix ...]
+   bench = new atBench(argc, argv);
+
+   // Run the suites (each one skips whatever wasn't asked for)
+   runMathBenchmarks(bench);
+   runContainerBenchmarks(bench);
+   runQueueBenchmarks(bench);
+   runNetworkBenchmarks(bench);
+   #ifdef __AT_XML_ENABLED__
+      runXMLBenchmarks(bench);
+   #endif
+   runMetricsBenchmarks(bench);
+   runTaskBenchmarks(bench);
+   runConfigBenchmarks(bench);
+
+   // Show what the library recorded along the way (this only has
+   // anything in it when ATLAS was built with metrics enabled)
+   if (bench->isDumpingMetrics())
+   {
+      printf("\n");
+      atMetrics::dump(stdout);
+   }
+
+   // Done
+   delete bench;
+   return 0;
+}
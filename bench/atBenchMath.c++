@@ -0,0 +1,245 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "atBench.h++"
+#include "atMatrix.h++"
+#include "atMatrixArray.h++"
+#include "atPointArray.h++"
+#include "atQuat.h++"
+#include "atQuatArray.h++"
+#include "atVector.h++"
+
+
+#define BENCH_MATH_POINTS     4096
+#define BENCH_MATH_QUATS      4096
+#define BENCH_MATH_MATRICES   1024
+
+
+static double randomValue()
+{
+   // Something in [-1, 1]
+   return (double ) rand() / (double ) RAND_MAX * 2.0 - 1.0;
+}
+
+
+static void getRandomMatrix(atMatrix * matrix)
+{
+   int   i;
+   int   j;
+
+   // Fill in an affine transform (the bottom row stays 0 0 0 1)
+   matrix->setIdentity();
+   for (i = 0; i < 3; i++)
+      for (j = 0; j < 4; j++)
+         matrix->setValue(i, j, randomValue());
+}
+
+
+static void benchPointXform(atBench * bench)
+{
+   atMatrix       matrix;
+   atVector *     points;
+   atVector *     results;
+   atPointArray   pointArray(BENCH_MATH_POINTS);
+   atPointArray   resultArray(BENCH_MATH_POINTS);
+   u_long         reps;
+   u_long         r;
+   u_long         i;
+   double         seconds;
+
+   // Make up some points and a transform
+   getRandomMatrix(&matrix);
+   points = new atVector[BENCH_MATH_POINTS];
+   results = new atVector[BENCH_MATH_POINTS];
+   for (i = 0; i < BENCH_MATH_POINTS; i++)
+   {
+      points[i].set(randomValue(), randomValue(), randomValue());
+      pointArray.setPoint(i, points[i]);
+   }
+   reps = bench->getSize(2000);
+
+   // One point at a time with atMatrix
+   if (bench->shouldRun("math.point_xform.scalar"))
+   {
+      bench->start();
+      for (r = 0; r < reps; r++)
+         for (i = 0; i < BENCH_MATH_POINTS; i++)
+            results[i] = matrix.getPointXform(points[i]);
+      seconds = bench->stop();
+      bench->report("math.point_xform.scalar", reps * BENCH_MATH_POINTS,
+                    seconds);
+   }
+
+   // The whole array at once with atPointArray
+   if (bench->shouldRun("math.point_xform.batch"))
+   {
+      bench->start();
+      for (r = 0; r < reps; r++)
+         pointArray.getPointXform(matrix, &resultArray);
+      seconds = bench->stop();
+      bench->report("math.point_xform.batch", reps * BENCH_MATH_POINTS,
+                    seconds);
+   }
+
+   // Clean up
+   delete [] points;
+   delete [] results;
+}
+
+
+static void benchQuatSlerp(atBench * bench)
+{
+   atQuat *      sources;
+   atQuat *      destinations;
+   atQuat *      results;
+   atQuatArray   sourceArray(BENCH_MATH_QUATS);
+   atQuatArray   destinationArray(BENCH_MATH_QUATS);
+   atQuatArray   resultArray(BENCH_MATH_QUATS);
+   u_long        reps;
+   u_long        r;
+   u_long        i;
+   double        seconds;
+
+   // Make up some pairs of rotations
+   sources = new atQuat[BENCH_MATH_QUATS];
+   destinations = new atQuat[BENCH_MATH_QUATS];
+   results = new atQuat[BENCH_MATH_QUATS];
+   for (i = 0; i < BENCH_MATH_QUATS; i++)
+   {
+      sources[i].set(randomValue(), randomValue(), randomValue(),
+                     randomValue());
+      sources[i].normalize();
+      destinations[i].set(randomValue(), randomValue(), randomValue(),
+                          randomValue());
+      destinations[i].normalize();
+      sourceArray.setQuat(i, sources[i]);
+      destinationArray.setQuat(i, destinations[i]);
+   }
+   reps = bench->getSize(500);
+
+   // One at a time with atQuat
+   if (bench->shouldRun("math.quat_slerp.scalar"))
+   {
+      bench->start();
+      for (r = 0; r < reps; r++)
+         for (i = 0; i < BENCH_MATH_QUATS; i++)
+            results[i] = sources[i].slerp(destinations[i], 0.3);
+      seconds = bench->stop();
+      bench->report("math.quat_slerp.scalar", reps * BENCH_MATH_QUATS,
+                    seconds);
+   }
+
+   // The whole array at once with atQuatArray
+   if (bench->shouldRun("math.quat_slerp.batch"))
+   {
+      bench->start();
+      for (r = 0; r < reps; r++)
+         sourceArray.slerp(destinationArray, 0.3, &resultArray);
+      seconds = bench->stop();
+      bench->report("math.quat_slerp.batch", reps * BENCH_MATH_QUATS,
+                    seconds);
+   }
+
+   // Clean up
+   delete [] sources;
+   delete [] destinations;
+   delete [] results;
+}
+
+
+static void benchMatrixMultiply(atBench * bench)
+{
+   atMatrix *      lefts;
+   atMatrix *      rights;
+   atMatrix *      results;
+   atMatrixArray   leftArray(BENCH_MATH_MATRICES);
+   atMatrixArray   rightArray(BENCH_MATH_MATRICES);
+   atMatrixArray   resultArray(BENCH_MATH_MATRICES);
+   u_long          reps;
+   u_long          r;
+   u_long          i;
+   double          seconds;
+
+   // Make up some pairs of transforms
+   lefts = new atMatrix[BENCH_MATH_MATRICES];
+   rights = new atMatrix[BENCH_MATH_MATRICES];
+   results = new atMatrix[BENCH_MATH_MATRICES];
+   for (i = 0; i < BENCH_MATH_MATRICES; i++)
+   {
+      getRandomMatrix(&lefts[i]);
+      getRandomMatrix(&rights[i]);
+      leftArray.setMatrix(i, lefts[i]);
+      rightArray.setMatrix(i, rights[i]);
+   }
+   reps = bench->getSize(2000);
+
+   // One at a time with atMatrix
+   if (bench->shouldRun("math.matrix_multiply.scalar"))
+   {
+      bench->start();
+      for (r = 0; r < reps; r++)
+      {
+         for (i = 0; i < BENCH_MATH_MATRICES; i++)
+         {
+            results[i] = lefts[i];
+            results[i].postMultiply(rights[i]);
+         }
+      }
+      seconds = bench->stop();
+      bench->report("math.matrix_multiply.scalar",
+                    reps * BENCH_MATH_MATRICES, seconds);
+   }
+
+   // The whole array at once with atMatrixArray
+   if (bench->shouldRun("math.matrix_multiply.batch"))
+   {
+      bench->start();
+      for (r = 0; r < reps; r++)
+         leftArray.getPostMultiplied(rightArray, &resultArray);
+      seconds = bench->stop();
+      bench->report("math.matrix_multiply.batch",
+                    reps * BENCH_MATH_MATRICES, seconds);
+   }
+
+   // Clean up
+   delete [] lefts;
+   delete [] rights;
+   delete [] results;
+}
+
+
+void runMathBenchmarks(atBench * bench)
+{
+   // Same data every run
+   srand(1);
+
+   // Scalar classes against the batch arrays
+   benchPointXform(bench);
+   benchQuatSlerp(bench);
+   benchMatrixMultiply(bench);
+}
@@ -0,0 +1,85 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdio.h>
+#include "atBench.h++"
+#include "atMetrics.h++"
+
+
+void runMetricsBenchmarks(atBench * bench)
+{
+   atMetricsSnapshot   snapshot;
+   atMetricID          counter;
+   atMetricID          histogram;
+   u_long              count;
+   u_long              i;
+   double              seconds;
+
+   // Metrics of our own, so the real ones aren't disturbed
+   counter = atMetrics::registerCounter("bench.counter");
+   histogram = atMetrics::registerHistogram("bench.histogram");
+   count = bench->getSize(10000000);
+
+   // The calls the instrumentation makes, made directly (so they're
+   // measured even when the macros are compiled out)
+   if (bench->shouldRun("metrics.count"))
+   {
+      bench->start();
+      for (i = 0; i < count; i++)
+         atMetrics::addCount(counter, 1);
+      seconds = bench->stop();
+      bench->report("metrics.count", count, seconds);
+   }
+   if (bench->shouldRun("metrics.record"))
+   {
+      bench->start();
+      for (i = 0; i < count; i++)
+         atMetrics::recordValue(histogram, i);
+      seconds = bench->stop();
+      bench->report("metrics.record", count, seconds);
+   }
+   if (bench->shouldRun("metrics.timer"))
+   {
+      bench->start();
+      for (i = 0; i < count; i++)
+      {
+         atMetricsTimer   timer(histogram);
+      }
+      seconds = bench->stop();
+      bench->report("metrics.timer", count, seconds);
+   }
+
+   // Gathering everything up
+   if (bench->shouldRun("metrics.snapshot"))
+   {
+      count = bench->getSize(100000);
+      bench->start();
+      for (i = 0; i < count; i++)
+         atMetrics::getSnapshot(&snapshot);
+      seconds = bench->stop();
+      bench->report("metrics.snapshot", count, seconds);
+   }
+}
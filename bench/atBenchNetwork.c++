@@ -0,0 +1,273 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+#include "atBench.h++"
+#include "atPacketPool.h++"
+#include "atTCPNetworkInterface.h++"
+#include "atUDPNetworkInterface.h++"
+
+
+#define BENCH_NET_UDP_PORT        42400
+#define BENCH_NET_TCP_PORT        42401
+
+#define BENCH_NET_PACKET_SIZE     256
+#define BENCH_NET_BATCH_SIZE      64
+#define BENCH_NET_MESSAGE_SIZE    64
+
+
+static void benchUDP(atBench * bench)
+{
+   atUDPNetworkInterface *   udp;
+   atPacketPool *            pool;
+   u_char                    packet[BENCH_NET_PACKET_SIZE];
+   u_long                    numBatches;
+   u_long                    batch;
+   u_long                    received;
+   int                       i;
+   int                       result;
+   double                    seconds;
+
+   // Send to ourselves over the loopback interface, a batch at a time
+   // (so the socket buffer never overflows)
+   udp = new atUDPNetworkInterface((char *) "127.0.0.1", BENCH_NET_UDP_PORT);
+   numBatches = bench->getSize(20000);
+   memset(packet, 'u', sizeof(packet));
+
+   // One system call per packet
+   if (bench->shouldRun("network.udp.single"))
+   {
+      bench->start();
+      for (batch = 0; batch < numBatches; batch++)
+      {
+         for (i = 0; i < BENCH_NET_BATCH_SIZE; i++)
+            udp->write(packet, sizeof(packet));
+         for (i = 0; i < BENCH_NET_BATCH_SIZE; i++)
+            udp->read(packet, sizeof(packet));
+      }
+      seconds = bench->stop();
+      bench->report("network.udp.single",
+                    numBatches * BENCH_NET_BATCH_SIZE, seconds);
+   }
+
+   // Whole batches per system call
+   if (bench->shouldRun("network.udp.batched"))
+   {
+      pool = new atPacketPool(BENCH_NET_BATCH_SIZE, BENCH_NET_PACKET_SIZE);
+      bench->start();
+      for (batch = 0; batch < numBatches; batch++)
+      {
+         // Refill the pool and send it
+         pool->clear();
+         for (i = 0; i < BENCH_NET_BATCH_SIZE; i++)
+            pool->addPacket(packet, sizeof(packet));
+         udp->writeMany(pool);
+
+         // Read until the whole batch is back
+         received = 0;
+         while (received < BENCH_NET_BATCH_SIZE)
+         {
+            result = udp->readMany(pool);
+            if (result <= 0)
+               break;
+            received += result;
+         }
+      }
+      seconds = bench->stop();
+      bench->report("network.udp.batched",
+                    numBatches * BENCH_NET_BATCH_SIZE, seconds);
+      delete pool;
+   }
+
+   delete udp;
+}
+
+
+static u_long getMaxClients(u_long wantedClients)
+{
+   struct rlimit   limit;
+   u_long          maxClients;
+
+   // Each client takes two descriptors (its own end and the server's), so
+   // raise our descriptor limit as far as we're allowed and cut the
+   // number of clients down if that still isn't enough
+   if (getrlimit(RLIMIT_NOFILE, &limit) != 0)
+      return wantedClients;
+   if (limit.rlim_cur < limit.rlim_max)
+   {
+      limit.rlim_cur = limit.rlim_max;
+      setrlimit(RLIMIT_NOFILE, &limit);
+      getrlimit(RLIMIT_NOFILE, &limit);
+   }
+   maxClients = ((u_long ) limit.rlim_cur - 64) / 2;
+   if (maxClients < wantedClients)
+      return maxClients;
+   else
+      return wantedClients;
+}
+
+
+static void echoRound(atTCPNetworkInterface * server,
+                      atTCPNetworkInterface ** clients, int * clientIDs,
+                      u_long numClients, bool eventMode)
+{
+   u_char   message[BENCH_NET_MESSAGE_SIZE];
+   u_long   received;
+   u_long   i;
+   int      clientID;
+
+   // Every client sends a message
+   memset(message, 't', sizeof(message));
+   for (i = 0; i < numClients; i++)
+      clients[i]->writeMessage(message, sizeof(message));
+
+   // The server echoes each message back as it arrives
+   received = 0;
+   while (received < numClients)
+   {
+      if (eventMode)
+      {
+         // Only look at the clients that have something for us, and send
+         // all the replies together
+         server->processEvents(100);
+         while ((clientID = server->getNextReadyClient()) >= 0)
+         {
+            while (server->readMessage(clientID, message,
+                                       sizeof(message)) > 0)
+            {
+               server->writeMessage(clientID, message, sizeof(message));
+               received++;
+            }
+         }
+         server->flushClients();
+      }
+      else
+      {
+         // Check every client in turn
+         for (i = 0; i < numClients; i++)
+         {
+            if (server->readMessage(clientIDs[i], message,
+                                    sizeof(message)) > 0)
+            {
+               server->writeMessage(clientIDs[i], message, sizeof(message));
+               received++;
+            }
+         }
+      }
+   }
+
+   // Every client waits for its reply
+   for (i = 0; i < numClients; i++)
+      clients[i]->readMessage(message, sizeof(message));
+}
+
+
+static void benchTCP(atBench * bench)
+{
+   atTCPNetworkInterface *    server;
+   atTCPNetworkInterface **   clients;
+   int *                      clientIDs;
+   u_long                     numClients;
+   u_long                     numRounds;
+   u_long                     round;
+   u_long                     i;
+   char                       note[64];
+   double                     seconds;
+
+   if ((!bench->shouldRun("network.tcp.polling")) &&
+       (!bench->shouldRun("network.tcp.event")))
+      return;
+
+   // Set up the server and connect all the clients to it
+   numClients = getMaxClients(bench->isQuick() ? 100 : 1000);
+   numRounds = bench->getSize(200);
+   server = new atTCPNetworkInterface(BENCH_NET_TCP_PORT);
+   if (!server->allowConnections((int ) numClients))
+   {
+      delete server;
+      return;
+   }
+   clients = new atTCPNetworkInterface *[numClients];
+   clientIDs = new int[numClients];
+   for (i = 0; i < numClients; i++)
+   {
+      clients[i] = new atTCPNetworkInterface((char *) "127.0.0.1",
+                                             BENCH_NET_TCP_PORT);
+      clientIDs[i] = -1;
+      if (clients[i]->makeConnection() >= 0)
+         clientIDs[i] = server->acceptConnection();
+
+      // Stop at the first client that couldn't connect
+      if (clientIDs[i] < 0)
+      {
+         delete clients[i];
+         numClients = i;
+         break;
+      }
+      server->disableBlockingOnClient(clientIDs[i]);
+   }
+   sprintf(note, "%lu clients", numClients);
+
+   // The server polls each client for messages
+   if (bench->shouldRun("network.tcp.polling"))
+   {
+      bench->start();
+      for (round = 0; round < numRounds; round++)
+         echoRound(server, clients, clientIDs, numClients, false);
+      seconds = bench->stop();
+      bench->report("network.tcp.polling", numRounds * numClients, seconds,
+                    note);
+   }
+
+   // The server waits for events on all the clients at once
+   if (bench->shouldRun("network.tcp.event"))
+   {
+      server->enableEventMode();
+      bench->start();
+      for (round = 0; round < numRounds; round++)
+         echoRound(server, clients, clientIDs, numClients, true);
+      seconds = bench->stop();
+      bench->report("network.tcp.event", numRounds * numClients, seconds,
+                    note);
+      server->disableEventMode();
+   }
+
+   // Clean up
+   for (i = 0; i < numClients; i++)
+      delete clients[i];
+   delete [] clients;
+   delete [] clientIDs;
+   delete server;
+}
+
+
+void runNetworkBenchmarks(atBench * bench)
+{
+   benchUDP(bench);
+   benchTCP(bench);
+}
@@ -0,0 +1,203 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include "atAtomic.h++"
+#include "atBench.h++"
+#include "atSharedQueue.h++"
+#include "atThreadQueue.h++"
+
+
+#define BENCH_QUEUE_MESSAGE_SIZE   64
+#define BENCH_QUEUE_RING_SIZE      (1 << 20)
+#define BENCH_QUEUE_MAX_PRODUCERS  4
+
+// Keys for the semaphores and shared memory the queues use
+#define BENCH_QUEUE_THREAD_KEY     0x41544201
+#define BENCH_QUEUE_CONTROL_KEY    0x41544202
+#define BENCH_QUEUE_DATA_KEY       0x41544203
+
+
+// What each producer thread needs to know
+typedef struct
+{
+   atThreadQueue *   thread_queue;
+   atSharedQueue *   shared_queue;
+   u_long            num_messages;
+} atBenchQueueJob;
+
+
+static void * produceMessages(void * jobPtr)
+{
+   atBenchQueueJob *   job;
+   u_char              message[BENCH_QUEUE_MESSAGE_SIZE];
+   u_long              i;
+   bool                queued;
+
+   // Enqueue the messages, trying again whenever a ring is full
+   job = (atBenchQueueJob *) jobPtr;
+   memset(message, 'x', sizeof(message));
+   for (i = 0; i < job->num_messages; i++)
+   {
+      do
+      {
+         if (job->thread_queue != NULL)
+            queued = job->thread_queue->enqueue(message, sizeof(message));
+         else
+            queued = job->shared_queue->enqueue(message, sizeof(message));
+         if (!queued)
+            atomicPause();
+      }
+      while (!queued);
+   }
+
+   return NULL;
+}
+
+
+static void benchQueue(atBench * bench, const char * name,
+                       atThreadQueue * threadQueue,
+                       atSharedQueue * sharedQueue, int numProducers,
+                       u_long numMessages)
+{
+   pthread_t         producers[BENCH_QUEUE_MAX_PRODUCERS];
+   atBenchQueueJob   job;
+   u_char            message[BENCH_QUEUE_MESSAGE_SIZE];
+   u_long            messageLen;
+   u_long            received;
+   u_long            total;
+   bool              dequeued;
+   int               i;
+   double            seconds;
+
+   // All the producers share the same job
+   job.thread_queue = threadQueue;
+   job.shared_queue = sharedQueue;
+   job.num_messages = numMessages;
+   total = numMessages * numProducers;
+
+   // Start the producers, then consume everything on this thread
+   bench->start();
+   for (i = 0; i < numProducers; i++)
+      pthread_create(&producers[i], NULL, produceMessages, &job);
+   received = 0;
+   while (received < total)
+   {
+      messageLen = sizeof(message);
+      if (threadQueue != NULL)
+         dequeued = threadQueue->dequeue(message, &messageLen);
+      else
+         dequeued = sharedQueue->dequeue(message, &messageLen);
+      if (dequeued)
+         received++;
+      else
+         atomicPause();
+   }
+   for (i = 0; i < numProducers; i++)
+      pthread_join(producers[i], NULL);
+   seconds = bench->stop();
+
+   // Report the message rate
+   bench->report(name, total, seconds);
+}
+
+
+void runQueueBenchmarks(atBench * bench)
+{
+   atThreadQueue *   threadQueue;
+   atSharedQueue *   sharedQueue;
+   u_long            count;
+
+   // One producer and one consumer for each kind of queue
+   count = bench->getSize(2000000);
+   if (bench->shouldRun("queue.thread.locked.1p"))
+   {
+      threadQueue = new atThreadQueue(BENCH_QUEUE_THREAD_KEY,
+                                      BENCH_QUEUE_RING_SIZE,
+                                      BENCH_QUEUE_RING_SIZE,
+                                      AT_QUEUE_LOCKED);
+      benchQueue(bench, "queue.thread.locked.1p", threadQueue, NULL, 1,
+                 count);
+      delete threadQueue;
+   }
+   if (bench->shouldRun("queue.thread.ring_spsc.1p"))
+   {
+      threadQueue = new atThreadQueue(BENCH_QUEUE_THREAD_KEY,
+                                      BENCH_QUEUE_RING_SIZE,
+                                      BENCH_QUEUE_RING_SIZE,
+                                      AT_QUEUE_RING_SPSC);
+      benchQueue(bench, "queue.thread.ring_spsc.1p", threadQueue, NULL, 1,
+                 count);
+      delete threadQueue;
+   }
+   if (bench->shouldRun("queue.shared.locked.1p"))
+   {
+      sharedQueue = new atSharedQueue(BENCH_QUEUE_CONTROL_KEY,
+                                      BENCH_QUEUE_DATA_KEY,
+                                      BENCH_QUEUE_RING_SIZE,
+                                      BENCH_QUEUE_RING_SIZE,
+                                      AT_QUEUE_LOCKED);
+      benchQueue(bench, "queue.shared.locked.1p", NULL, sharedQueue, 1,
+                 count);
+      delete sharedQueue;
+   }
+   if (bench->shouldRun("queue.shared.ring_spsc.1p"))
+   {
+      sharedQueue = new atSharedQueue(BENCH_QUEUE_CONTROL_KEY,
+                                      BENCH_QUEUE_DATA_KEY,
+                                      BENCH_QUEUE_RING_SIZE,
+                                      BENCH_QUEUE_RING_SIZE,
+                                      AT_QUEUE_RING_SPSC);
+      benchQueue(bench, "queue.shared.ring_spsc.1p", NULL, sharedQueue, 1,
+                 count);
+      delete sharedQueue;
+   }
+
+   // Several producers feeding one consumer
+   count = bench->getSize(500000);
+   if (bench->shouldRun("queue.thread.locked.4p"))
+   {
+      threadQueue = new atThreadQueue(BENCH_QUEUE_THREAD_KEY,
+                                      BENCH_QUEUE_RING_SIZE,
+                                      BENCH_QUEUE_RING_SIZE,
+                                      AT_QUEUE_LOCKED);
+      benchQueue(bench, "queue.thread.locked.4p", threadQueue, NULL,
+                 BENCH_QUEUE_MAX_PRODUCERS, count);
+      delete threadQueue;
+   }
+   if (bench->shouldRun("queue.thread.ring_mpsc.4p"))
+   {
+      threadQueue = new atThreadQueue(BENCH_QUEUE_THREAD_KEY,
+                                      BENCH_QUEUE_RING_SIZE,
+                                      BENCH_QUEUE_RING_SIZE,
+                                      AT_QUEUE_RING_MPSC);
+      benchQueue(bench, "queue.thread.ring_mpsc.4p", threadQueue, NULL,
+                 BENCH_QUEUE_MAX_PRODUCERS, count);
+      delete threadQueue;
+   }
+}
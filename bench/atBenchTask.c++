@@ -0,0 +1,250 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <math.h>
+#include <stdio.h>
+#include "atBench.h++"
+#include "atMatrix.h++"
+#include "atPointArray.h++"
+#include "atTaskPool.h++"
+#include "atThread.h++"
+
+
+#define BENCH_TASK_MAX_COUNTS     16
+#define BENCH_TASK_REDUCE_GRAIN   65536
+
+
+// Sums a function that takes a while to compute at each index, so the
+// reduction is limited by the processors rather than memory
+class atBenchSum : public atTaskReduce
+{
+   public:
+      double   total;
+
+      atBenchSum()
+      {
+         total = 0.0;
+      }
+
+      virtual atTaskReduce * split()
+      {
+         return new atBenchSum();
+      }
+
+      virtual void runRange(u_long start, u_long end)
+      {
+         u_long   i;
+
+         for (i = start; i < end; i++)
+            total += sqrt((double ) i) * sin((double ) i);
+      }
+
+      virtual void join(atTaskReduce * other)
+      {
+         total += ((atBenchSum *) other)->total;
+      }
+};
+
+
+// A task that does next to nothing, for measuring the pool's overhead
+class atBenchTinyTask : public atTask
+{
+   public:
+      u_long   result;
+
+      virtual void run()
+      {
+         result++;
+      }
+};
+
+
+static int getThreadCounts(u_long * counts)
+{
+   u_long   numProcessors;
+   u_long   count;
+   int      numCounts;
+
+   // Powers of two up to the number of processors, then all of them
+   numProcessors = getNumProcessors();
+   numCounts = 0;
+   for (count = 1; (count < numProcessors) &&
+                   (numCounts < BENCH_TASK_MAX_COUNTS - 1); count *= 2)
+   {
+      counts[numCounts] = count;
+      numCounts++;
+   }
+   counts[numCounts] = numProcessors;
+   return numCounts + 1;
+}
+
+
+static void reportScaling(atBench * bench, const char * name,
+                          u_long threads, u_long operations, double seconds,
+                          double baseSeconds)
+{
+   char   fullName[64];
+   char   note[64];
+
+   // Tag the name with the thread count and note the speedup over one
+   // thread
+   sprintf(fullName, "%s.%lut", name, threads);
+   sprintf(note, "speedup %.2fx", baseSeconds / seconds);
+   bench->report(fullName, operations, seconds, note);
+}
+
+
+static void benchXform(atBench * bench, u_long * counts, int numCounts)
+{
+   atMatrix         matrix;
+   atPointArray *   points;
+   atTaskPool *     pool;
+   u_long           numPoints;
+   u_long           reps;
+   u_long           r;
+   u_long           i;
+   int              c;
+   double           seconds;
+   double           baseSeconds;
+
+   // Transform a large entity array over and over (a small rotation
+   // keeps the values in range)
+   numPoints = bench->getSize(4000000);
+   reps = 20;
+   points = new atPointArray(numPoints);
+   for (i = 0; i < numPoints; i++)
+      points->setPoint(i, (double ) i, 1.0, 2.0);
+   matrix.setEulerRotation(AT_EULER_ANGLES_ZYX_S, 0.001, 0.0, 0.0);
+
+   // Run on more and more threads (the waiting thread makes one)
+   baseSeconds = 0.0;
+   for (c = 0; c < numCounts; c++)
+   {
+      pool = new atTaskPool(counts[c] - 1);
+      bench->start();
+      for (r = 0; r < reps; r++)
+         points->pointXform(matrix, pool);
+      seconds = bench->stop();
+      if (c == 0)
+         baseSeconds = seconds;
+      reportScaling(bench, "task.xform", counts[c], numPoints * reps,
+                    seconds, baseSeconds);
+      delete pool;
+   }
+
+   delete points;
+}
+
+
+static void benchReduce(atBench * bench, u_long * counts, int numCounts,
+                        bool pinned)
+{
+   atTaskPool *   pool;
+   atBenchSum     sum;
+   double         firstTotal;
+   u_long         count;
+   int            c;
+   double         seconds;
+   double         baseSeconds;
+
+   // Sum up a big range with a fixed grain size, so every run should
+   // come up with exactly the same answer
+   count = bench->getSize(20000000);
+   firstTotal = 0.0;
+   baseSeconds = 0.0;
+   for (c = 0; c < numCounts; c++)
+   {
+      pool = new atTaskPool(counts[c] - 1, pinned);
+      sum.total = 0.0;
+      bench->start();
+      pool->parallelReduce(0, count, BENCH_TASK_REDUCE_GRAIN, &sum);
+      seconds = bench->stop();
+      if (c == 0)
+      {
+         firstTotal = sum.total;
+         baseSeconds = seconds;
+      }
+      else if (sum.total != firstTotal)
+         bench->notify(AT_WARN, "Reduction result changed with %lu "
+                       "threads.\n", counts[c]);
+      reportScaling(bench, pinned ? "task.reduce_pinned" : "task.reduce",
+                    counts[c], count, seconds, baseSeconds);
+      delete pool;
+   }
+}
+
+
+static void benchSubmit(atBench * bench, u_long * counts, int numCounts)
+{
+   atBenchTinyTask *   tasks;
+   atTaskGroup         group;
+   atTaskPool *        pool;
+   u_long              numTasks;
+   u_long              i;
+   int                 c;
+   double              seconds;
+   double              baseSeconds;
+
+   // Submit lots of tiny tasks from outside the pool and wait for them,
+   // which is mostly the cost of the deques and waking workers
+   numTasks = bench->getSize(1000000);
+   tasks = new atBenchTinyTask[numTasks];
+   baseSeconds = 0.0;
+   for (c = 0; c < numCounts; c++)
+   {
+      pool = new atTaskPool(counts[c] - 1);
+      bench->start();
+      for (i = 0; i < numTasks; i++)
+         pool->submit(&tasks[i], &group);
+      pool->wait(&group);
+      seconds = bench->stop();
+      if (c == 0)
+         baseSeconds = seconds;
+      reportScaling(bench, "task.submit", counts[c], numTasks, seconds,
+                    baseSeconds);
+      delete pool;
+   }
+
+   delete [] tasks;
+}
+
+
+void runTaskBenchmarks(atBench * bench)
+{
+   u_long   counts[BENCH_TASK_MAX_COUNTS];
+   int      numCounts;
+
+   // Scale from one thread up to one per processor
+   numCounts = getThreadCounts(counts);
+   if (bench->shouldRun("task.xform"))
+      benchXform(bench, counts, numCounts);
+   if (bench->shouldRun("task.reduce"))
+      benchReduce(bench, counts, numCounts, false);
+   if (bench->shouldRun("task.reduce_pinned"))
+      benchReduce(bench, counts, numCounts, true);
+   if (bench->shouldRun("task.submit"))
+      benchSubmit(bench, counts, numCounts);
+}
@@ -0,0 +1,298 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdio.h>
+#include <string.h>
+#include "atBench.h++"
+#include "atXMLBuffer.h++"
+#include "atXMLHandler.h++"
+
+
+#define BENCH_XML_NUM_DOCUMENTS   2000
+
+// A document whose attribute needs its entity and character references
+// decoded
+#define BENCH_XML_ENTITY_DOCUMENT \
+   "<bench><entity name=\"x&amp;y&lt;z &#65;&quot;\"/></bench>"
+
+// A document that tries to pull a local file in through an external
+// entity (the file's contents must never show up)
+#define BENCH_XML_SECRET_FILENAME   "atlasBench.secret"
+#define BENCH_XML_SECRET            "atlasBenchSecret"
+#define BENCH_XML_EXTERNAL_DOCUMENT \
+   "<!DOCTYPE bench [<!ENTITY x SYSTEM \"" BENCH_XML_SECRET_FILENAME \
+   "\">]><bench>&x;</bench>"
+
+
+// Counts the elements it's handed, so the streaming benchmark does a
+// token amount of work per element
+class atBenchXMLHandler : public atXMLHandler
+{
+   public:
+      u_long   num_elements;
+
+      atBenchXMLHandler()
+      {
+         num_elements = 0;
+      }
+
+      virtual void startElement(char * name, char ** attributes)
+      {
+         num_elements++;
+      }
+};
+
+
+// Keeps the name attribute of the entity element, so the streaming value
+// can be checked against the one the document tree gives
+class atBenchXMLAttributeHandler : public atXMLHandler
+{
+   public:
+      char   entity_name[64];
+
+      atBenchXMLAttributeHandler()
+      {
+         entity_name[0] = '\0';
+      }
+
+      virtual void attribute(char * elementName, char * name, char * value)
+      {
+         if ((strcmp(elementName, "entity") == 0) &&
+             (strcmp(name, "name") == 0))
+         {
+            strncpy(entity_name, value, sizeof(entity_name) - 1);
+            entity_name[sizeof(entity_name) - 1] = '\0';
+         }
+      }
+};
+
+
+static void checkEntities(atBench * bench)
+{
+   atBenchXMLAttributeHandler   handler;
+   atXMLBuffer *                buffer;
+   atList *                     documents;
+   atXMLDocument *              document;
+   atXMLDocumentNodePtr         node;
+   char                         expected[64];
+   int                          mode;
+
+   // Get the attribute the way the document tree gives it back
+   buffer = new atXMLBuffer((char *) "bench");
+   documents = buffer->processData((u_char *) BENCH_XML_ENTITY_DOCUMENT,
+                                   strlen(BENCH_XML_ENTITY_DOCUMENT));
+   document = (atXMLDocument *) documents->getFirstEntry();
+   if (document == NULL)
+   {
+      bench->notify(AT_WARN, "Entity test document didn't parse.\n");
+      delete buffer;
+      return;
+   }
+   node = document->getNextChildNode(document->getRootNode());
+   strncpy(expected, document->getNodeAttribute(node, (char *) "name"),
+           sizeof(expected) - 1);
+   expected[sizeof(expected) - 1] = '\0';
+   delete buffer;
+
+   // Streaming has to hand the same value to the handler, whether or not
+   // it's building documents too
+   for (mode = 1; mode <= 2; mode++)
+   {
+      buffer = new atXMLBuffer((char *) "bench");
+      buffer->enableStreaming(&handler, (mode == 2));
+      handler.entity_name[0] = '\0';
+      buffer->processData((u_char *) BENCH_XML_ENTITY_DOCUMENT,
+                          strlen(BENCH_XML_ENTITY_DOCUMENT));
+      if (strcmp(handler.entity_name, expected) != 0)
+         bench->notify(AT_WARN, "Streaming gave attribute as \"%s\" "
+                       "instead of \"%s\".\n", handler.entity_name,
+                       expected);
+      delete buffer;
+   }
+}
+
+
+// Keeps the character data it's handed, so it can be checked for
+// anything that shouldn't be there
+class atBenchXMLTextHandler : public atXMLHandler
+{
+   public:
+      char     text[256];
+      u_long   text_len;
+
+      atBenchXMLTextHandler()
+      {
+         text[0] = '\0';
+         text_len = 0;
+      }
+
+      virtual void characters(char * chars, u_long len)
+      {
+         if (len > sizeof(text) - 1 - text_len)
+            len = sizeof(text) - 1 - text_len;
+         memcpy(&text[text_len], chars, len);
+         text_len += len;
+         text[text_len] = '\0';
+      }
+};
+
+
+static void checkExternalEntities(atBench * bench)
+{
+   atBenchXMLTextHandler   handler;
+   atXMLBuffer *           buffer;
+   atList *                documents;
+   atXMLDocument *         document;
+   char *                  text;
+   FILE *                  outfile;
+   int                     mode;
+
+   // Write the file the document asks for
+   outfile = fopen(BENCH_XML_SECRET_FILENAME, "w");
+   if (outfile == NULL)
+      return;
+   fprintf(outfile, "%s\n", BENCH_XML_SECRET);
+   fclose(outfile);
+
+   // None of the modes may read the file, whether into the handler or
+   // into the document tree
+   for (mode = 0; mode <= 2; mode++)
+   {
+      buffer = new atXMLBuffer((char *) "bench");
+      if (mode > 0)
+         buffer->enableStreaming(&handler, (mode == 2));
+      handler.text[0] = '\0';
+      handler.text_len = 0;
+      documents = buffer->processData((u_char *) BENCH_XML_EXTERNAL_DOCUMENT,
+                                      strlen(BENCH_XML_EXTERNAL_DOCUMENT));
+      if (strstr(handler.text, BENCH_XML_SECRET) != NULL)
+         bench->notify(AT_WARN, "Mode %d read an external entity into "
+                       "the character data.\n", mode);
+
+      document = (atXMLDocument *) documents->getFirstEntry();
+      if (document != NULL)
+      {
+         text = document->getNodeText(
+            document->getNextChildNode(document->getRootNode()), true);
+         if ((text != NULL) && (strstr(text, BENCH_XML_SECRET) != NULL))
+            bench->notify(AT_WARN, "Mode %d read an external entity into "
+                          "the document.\n", mode);
+      }
+      delete buffer;
+   }
+
+   remove(BENCH_XML_SECRET_FILENAME);
+}
+
+
+static char * makeStream(u_long numDocuments, u_long * streamLen)
+{
+   char *   stream;
+   u_long   len;
+   u_long   i;
+
+   // Build a stream of small documents like the ones the XML buffer is
+   // meant for (a few elements and attributes each)
+   stream = new char[numDocuments * 256];
+   len = 0;
+   for (i = 0; i < numDocuments; i++)
+   {
+      len += sprintf(&stream[len],
+                     "<bench><entity id=\"%lu\" type=\"vehicle\">"
+                     "<position x=\"1.5\" y=\"2.5\" z=\"3.5\"/>"
+                     "<name>entity%lu</name></entity></bench>\n", i, i);
+   }
+
+   *streamLen = len;
+   return stream;
+}
+
+
+static void benchStream(atBench * bench, const char * name, char * stream,
+                        u_long streamLen, u_long chunkSize, int mode)
+{
+   atXMLBuffer *       buffer;
+   atBenchXMLHandler   handler;
+   u_long              pos;
+   u_long              len;
+   char                note[64];
+   double              seconds;
+
+   // Legacy mode (0) collects whole documents and parses them at the end;
+   // streaming parses as the data arrives, with (2) or without (1)
+   // building documents too
+   buffer = new atXMLBuffer((char *) "bench");
+   if (mode > 0)
+      buffer->enableStreaming(&handler, (mode == 2));
+
+   // Hand the stream over a chunk at a time, as if from the network
+   bench->start();
+   for (pos = 0; pos < streamLen; pos += chunkSize)
+   {
+      len = streamLen - pos;
+      if (len > chunkSize)
+         len = chunkSize;
+      buffer->processData((u_char *) &stream[pos], len);
+   }
+   seconds = bench->stop();
+
+   // Report the document rate
+   sprintf(note, "%lu-byte chunks", chunkSize);
+   bench->report(name, BENCH_XML_NUM_DOCUMENTS, seconds, note);
+   delete buffer;
+}
+
+
+void runXMLBenchmarks(atBench * bench)
+{
+   static const u_long   chunkSizes[] = { 64, 512, 4096, 65536 };
+   char *                stream;
+   u_long                streamLen;
+   u_long                i;
+
+   // Make sure streaming decodes attributes like the document tree does
+   if (bench->shouldRun("xml.streaming"))
+   {
+      checkEntities(bench);
+      checkExternalEntities(bench);
+   }
+
+   // Use the same stream for each run
+   stream = makeStream(BENCH_XML_NUM_DOCUMENTS, &streamLen);
+   for (i = 0; i < sizeof(chunkSizes) / sizeof(chunkSizes[0]); i++)
+   {
+      if (bench->shouldRun("xml.legacy"))
+         benchStream(bench, "xml.legacy", stream, streamLen,
+                     chunkSizes[i], 0);
+      if (bench->shouldRun("xml.streaming"))
+         benchStream(bench, "xml.streaming", stream, streamLen,
+                     chunkSizes[i], 1);
+      if (bench->shouldRun("xml.streaming_dom"))
+         benchStream(bench, "xml.streaming_dom", stream, streamLen,
+                     chunkSizes[i], 2);
+   }
+   delete [] stream;
+}
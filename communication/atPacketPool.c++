@@ -0,0 +1,232 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// INCLUDES
+#include <stdlib.h>
+#include <string.h>
+#include "atPacketPool.h++"
+
+
+atPacketPool::atPacketPool(u_long numSlots, u_long slotSize)
+{
+   u_long   i;
+
+   // Allocate the slots and one block of memory for all their data
+   packet_slots = (SocketPacket *) calloc(numSlots, sizeof(SocketPacket));
+   packet_data = (u_char *) malloc(numSlots * slotSize);
+   num_slots = numSlots;
+   slot_size = slotSize;
+   num_packets = 0;
+
+   // Point each slot at its part of the data
+   for (i = 0; i < numSlots; i++)
+   {
+      packet_slots[i].buffer = &packet_data[i * slotSize];
+      packet_slots[i].capacity = slotSize;
+   }
+}
+
+
+atPacketPool::~atPacketPool()
+{
+   // Free the slots and data
+   free(packet_slots);
+   free(packet_data);
+}
+
+
+u_long atPacketPool::getNumSlots()
+{
+   // Return the number of slots
+   return num_slots;
+}
+
+
+u_long atPacketPool::getSlotSize()
+{
+   // Return the maximum size of a packet
+   return slot_size;
+}
+
+
+u_long atPacketPool::getNumPackets()
+{
+   // Return how many slots hold packets
+   return num_packets;
+}
+
+
+void atPacketPool::setNumPackets(u_long numPackets)
+{
+   // Set how many slots (from the start) hold packets
+   if (numPackets > num_slots)
+      num_packets = num_slots;
+   else
+      num_packets = numPackets;
+}
+
+
+void atPacketPool::clear()
+{
+   u_long   i;
+
+   // Empty the pool and forget all the destinations
+   for (i = 0; i < num_packets; i++)
+   {
+      packet_slots[i].length = 0;
+      packet_slots[i].address.sin_family = 0;
+   }
+   num_packets = 0;
+}
+
+
+long atPacketPool::addPacket(u_char * buffer, u_long len)
+{
+   long   index;
+
+   // Make sure the packet fits
+   if ((num_packets >= num_slots) || (len > slot_size))
+      return -1;
+
+   // Copy it into the next free slot (it'll go to the default address)
+   index = num_packets;
+   memcpy(packet_slots[index].buffer, buffer, len);
+   packet_slots[index].length = len;
+   packet_slots[index].address.sin_family = 0;
+   num_packets++;
+
+   // Return the slot used
+   return index;
+}
+
+
+long atPacketPool::addPacket(u_char * buffer, u_long len,
+                             atString sendToAddr, u_short sendToPort)
+{
+   long   index;
+
+   // Add the packet and give it its own destination
+   index = addPacket(buffer, len);
+   if (index >= 0)
+      setPacketDestination(index, sendToAddr, sendToPort);
+
+   // Return the slot used
+   return index;
+}
+
+
+u_char * atPacketPool::getPacket(u_long index)
+{
+   // Return the slot's data
+   if (index >= num_slots)
+      return NULL;
+   return packet_slots[index].buffer;
+}
+
+
+u_long atPacketPool::getPacketLength(u_long index)
+{
+   // Return the packet's length
+   if (index >= num_slots)
+      return 0;
+   return packet_slots[index].length;
+}
+
+
+void atPacketPool::setPacketLength(u_long index, u_long len)
+{
+   // Set the length (for packets written directly into the slot)
+   if (index >= num_slots)
+      return;
+   if (len > slot_size)
+      len = slot_size;
+   packet_slots[index].length = len;
+}
+
+
+struct sockaddr_in * atPacketPool::getPacketAddress(u_long index)
+{
+   // Return the raw address
+   if (index >= num_slots)
+      return NULL;
+   return &packet_slots[index].address;
+}
+
+
+void atPacketPool::getPacketSender(u_long index, atString * senderAddr,
+                                   u_short * senderPort)
+{
+   char   senderAddrBuffer[INET_ADDRSTRLEN];
+
+   // Make sure the slot exists
+   if (index >= num_slots)
+      return;
+
+   // Address
+   if (senderAddr != NULL)
+   {
+      netAddrToStr(AF_INET, &packet_slots[index].address.sin_addr, 
+                   senderAddrBuffer, INET_ADDRSTRLEN);
+      senderAddr->setString(senderAddrBuffer);
+   }
+
+   // Port
+   if (senderPort != NULL)
+      *senderPort = ntohs(packet_slots[index].address.sin_port);
+}
+
+
+void atPacketPool::setPacketDestination(u_long index, atString sendToAddr,
+                                        u_short sendToPort)
+{
+   // Make sure the slot exists
+   if (index >= num_slots)
+      return;
+
+   // Set-up sockaddr based on destination
+   memset(&packet_slots[index].address, 0, sizeof(struct sockaddr_in));
+   packet_slots[index].address.sin_family = AF_INET;
+   strToNetAddr(AF_INET, sendToAddr.getString(),
+                &packet_slots[index].address.sin_addr);
+   packet_slots[index].address.sin_port = htons(sendToPort);
+}
+
+
+void atPacketPool::clearPacketDestination(u_long index)
+{
+   // Send this packet to the interface's default address
+   if (index < num_slots)
+      packet_slots[index].address.sin_family = 0;
+}
+
+
+SocketPacket * atPacketPool::getSlots()
+{
+   // Return the slots themselves (for the network interface)
+   return packet_slots;
+}
+
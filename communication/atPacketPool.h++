@@ -0,0 +1,85 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AT_PACKET_POOL_H
+#define AT_PACKET_POOL_H
+
+
+// INCLUDES
+#include "atItem.h++"
+#include "atString.h++"
+#include "atOSDefs.h++"
+
+
+// A fixed set of reusable datagram slots for atUDPNetworkInterface's
+// readMany() and writeMany().  All slots are allocated up front in one
+// block, so a pool can be filled and drained over and over without any
+// allocation.  Addresses are kept in their raw form and only turned into
+// strings when asked for
+class ATLAS_SYM atPacketPool : public atItem
+{
+   protected:
+      SocketPacket *   packet_slots;
+      u_char *         packet_data;
+      u_long           num_slots;
+      u_long           slot_size;
+      u_long           num_packets;
+
+   public:
+      atPacketPool(u_long numSlots, u_long slotSize);
+      virtual ~atPacketPool();
+
+      u_long                 getNumSlots();
+      u_long                 getSlotSize();
+
+      u_long                 getNumPackets();
+      void                   setNumPackets(u_long numPackets);
+      void                   clear();
+
+      long                   addPacket(u_char * buffer, u_long len);
+      long                   addPacket(u_char * buffer, u_long len,
+                                       atString sendToAddr,
+                                       u_short sendToPort);
+
+      u_char *               getPacket(u_long index);
+      u_long                 getPacketLength(u_long index);
+      void                   setPacketLength(u_long index, u_long len);
+
+      struct sockaddr_in *   getPacketAddress(u_long index);
+      void                   getPacketSender(u_long index,
+                                             atString * senderAddr,
+                                             u_short * senderPort);
+      void                   setPacketDestination(u_long index,
+                                                  atString sendToAddr,
+                                                  u_short sendToPort);
+      void                   clearPacketDestination(u_long index);
+
+      SocketPacket *         getSlots();
+};
+
+#endif
+
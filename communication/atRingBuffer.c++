@@ -0,0 +1,430 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include "atRingBuffer.h++"
+
+
+// CONSTANTS
+// Marks an initialized control block
+#define AT_RING_MAGIC        0x52494e47
+
+// Size of the header in front of each entry (keeps entries 8-byte aligned)
+#define AT_RING_HEADER_LEN   8
+
+// Smallest and largest data areas we'll use
+#define AT_RING_MIN_SIZE     64
+#define AT_RING_MAX_SIZE     0x20000000
+
+// Flags in the entry header word (the rest of the word is the length).  A
+// header of zero hasn't been written yet (free space is always zeroed)
+#define AT_RING_BUSY         0x80000000
+#define AT_RING_SKIP         0x40000000
+#define AT_RING_READY        0x20000000
+#define AT_RING_LEN_MASK     0x1fffffff
+
+// Total space an entry of the given length takes in the ring
+#define AT_RING_ENTRY_SIZE(len) \
+   (AT_RING_HEADER_LEN + (((len) + 7) & ~((uint32_t ) 7)))
+
+
+u_long atRingBuffer::getMemorySize(u_long dataSize)
+{
+   u_long   ringSize;
+
+   // The data area is the next power of two that holds the requested
+   // size, and the control block comes in front of it
+   ringSize = AT_RING_MIN_SIZE;
+   while ((ringSize < dataSize) && (ringSize < AT_RING_MAX_SIZE))
+      ringSize <<= 1;
+   return sizeof(atRingControl) + ringSize;
+}
+
+
+atRingBuffer::atRingBuffer(u_char * memory, u_long memorySize, 
+                           bool initialize, bool multiProducer)
+{
+   u_long   ringSize;
+
+   // The control block sits at the start of the memory with the data
+   // area right behind it
+   ring_control = (atRingControl *) memory;
+   ring_data = &memory[sizeof(atRingControl)];
+   multi_producer = multiProducer;
+   ring_mask = 0;
+
+   // Make sure the memory can hold at least the smallest ring
+   if ((memory == NULL) || 
+       (memorySize < sizeof(atRingControl) + AT_RING_MIN_SIZE))
+   {
+      notify(AT_ERROR, "Not enough memory for ring buffer.\n");
+      ring_control = NULL;
+      return;
+   }
+
+   if (initialize == true)
+   {
+      // Use the largest power of two that fits in the memory we have
+      ringSize = AT_RING_MIN_SIZE;
+      while ((ringSize * 2 <= memorySize - sizeof(atRingControl)) &&
+             (ringSize < AT_RING_MAX_SIZE))
+         ringSize <<= 1;
+
+      // Set up the control block, and mark it as ready last of all (the
+      // data area starts out zeroed, as free space always is)
+      memset(ring_control, 0, sizeof(atRingControl));
+      memset(ring_data, 0, ringSize);
+      ring_control->ring_size = (uint32_t ) ringSize;
+      atomicStore(&ring_control->ring_magic, AT_RING_MAGIC);
+   }
+   else if (atomicLoad(&ring_control->ring_magic) != AT_RING_MAGIC)
+   {
+      // Whoever owns the memory hasn't set up the ring
+      notify(AT_ERROR, "Ring buffer memory was never initialized.\n");
+      ring_control = NULL;
+      return;
+   }
+
+   // Positions are masked to get offsets into the data area
+   ring_mask = ring_control->ring_size - 1;
+}
+
+
+atRingBuffer::~atRingBuffer()
+{
+   // We don't own the memory, so nothing to do
+}
+
+
+bool atRingBuffer::claimSpace(uint32_t producerPos, uint32_t newPos)
+{
+   // A single producer owns the position outright.  Multiple producers
+   // race to move it, and whoever loses tries again from the new position
+   // (nobody ever holds a lock, so a producer that dies can't block the
+   // others)
+   if (multi_producer == false)
+   {
+      atomicStore(&ring_control->producer_pos, newPos);
+      return true;
+   }
+   else
+      return atomicCompareAndSwap(&ring_control->producer_pos, producerPos,
+                                  newPos);
+}
+
+
+void atRingBuffer::wakeConsumer()
+{
+   // Make sure the entry we just published is visible before we check
+   // whether the consumer is asleep (the consumer does the opposite, so
+   // one of us always sees the other)
+   atomicFence();
+
+   // Only pay for the syscall if somebody is actually waiting
+   if (atomicLoad(&ring_control->consumer_waiting) != 0)
+   {
+      atomicAdd(&ring_control->wake_sequence, 1);
+      atomicWake(&ring_control->wake_sequence);
+   }
+}
+
+
+bool atRingBuffer::isValid()
+{
+   return (ring_control != NULL);
+}
+
+
+u_long atRingBuffer::getDataSize()
+{
+   // Return the size of the data area
+   if (ring_control == NULL)
+      return 0;
+   else
+      return ring_control->ring_size;
+}
+
+
+u_long atRingBuffer::getMaxEntrySize()
+{
+   // An entry (with its header) can take up the whole data area
+   if (ring_control == NULL)
+      return 0;
+   else
+      return ring_control->ring_size - AT_RING_HEADER_LEN;
+}
+
+
+u_long atRingBuffer::getUsedSize()
+{
+   // The space in use is everything between the two positions (this is
+   // only a momentary value if the other side is busy)
+   if (ring_control == NULL)
+      return 0;
+   else
+      return atomicLoad(&ring_control->producer_pos) -
+             atomicLoad(&ring_control->consumer_pos);
+}
+
+
+u_char * atRingBuffer::reserve(u_long entryLen)
+{
+   uint32_t     entrySize;
+   uint32_t     producerPos;
+   uint32_t     consumerPos;
+   uint32_t     offset;
+   uint32_t     toEnd;
+   atAtomic *   header;
+
+   // Make sure the entry could ever fit
+   if ((ring_control == NULL) || (entryLen > getMaxEntrySize()))
+   {
+      notify(AT_WARN, "Entry of %lu bytes is too large for ring buffer.\n",
+             entryLen);
+      return NULL;
+   }
+   entrySize = AT_RING_ENTRY_SIZE((uint32_t ) entryLen);
+
+   // Claim the space, trying again whenever another producer gets there
+   // first
+   while (true)
+   {
+      // Read the consumer's position first, so it can never be ahead of
+      // the producer position we read
+      consumerPos = atomicLoad(&ring_control->consumer_pos);
+      producerPos = atomicLoad(&ring_control->producer_pos);
+      offset = producerPos & ring_mask;
+      toEnd = ring_control->ring_size - offset;
+
+      // Entries are never split across the end of the data area (so that
+      // callers can write straight into them).  If this one won't fit
+      // before the end, claim the rest of the area for a skip entry and
+      // go around again to claim the entry at the beginning
+      if (entrySize > toEnd)
+      {
+         // Make sure the padding itself fits
+         if (producerPos + toEnd - consumerPos > ring_control->ring_size)
+            return NULL;
+
+         // Publish the skip entry once the space is ours, so the consumer
+         // can get past it even if the entry doesn't fit yet
+         if (claimSpace(producerPos, producerPos + toEnd))
+         {
+            header = (atAtomic *) &ring_data[offset];
+            atomicStore(header, AT_RING_SKIP | toEnd);
+         }
+         continue;
+      }
+
+      // See if the entry fits in the free space
+      if (producerPos + entrySize - consumerPos > ring_control->ring_size)
+         return NULL;
+
+      // Advance the producer position past the entry
+      if (claimSpace(producerPos, producerPos + entrySize))
+         break;
+      atomicPause();
+   }
+
+   // Write the entry header, marked busy until it's committed.  Until
+   // then, the header is still zero, which the consumer also waits on
+   header = (atAtomic *) &ring_data[offset];
+   atomicStore(header, AT_RING_BUSY | (uint32_t ) entryLen);
+
+   // Hand back the space after the header
+   return &ring_data[offset + AT_RING_HEADER_LEN];
+}
+
+
+void atRingBuffer::commit(u_char * entry)
+{
+   atAtomic *   header;
+
+   // Swap the busy flag for the ready flag to hand the entry over to the
+   // consumer
+   header = (atAtomic *) (entry - AT_RING_HEADER_LEN);
+   atomicStore(header, (atomicLoad(header) & AT_RING_LEN_MASK) | 
+                       AT_RING_READY);
+
+   // Let the consumer know if it's waiting
+   wakeConsumer();
+}
+
+
+u_char * atRingBuffer::peek(u_long * entryLen)
+{
+   uint32_t     consumerPos;
+   uint32_t     producerPos;
+   uint32_t     offset;
+   uint32_t     headerWord;
+
+   if (ring_control == NULL)
+      return NULL;
+
+   // Only the consumer moves the consumer position
+   consumerPos = ring_control->consumer_pos;
+   while (true)
+   {
+      // See if there's anything past our position
+      producerPos = atomicLoad(&ring_control->producer_pos);
+      if (consumerPos == producerPos)
+         return NULL;
+
+      // Look at the next entry's header
+      offset = consumerPos & ring_mask;
+      headerWord = atomicLoad((atAtomic *) &ring_data[offset]);
+
+      // If the producer hasn't written or committed the entry yet, we
+      // have to wait (entries are consumed in order)
+      if ((headerWord == 0) || ((headerWord & AT_RING_BUSY) != 0))
+         return NULL;
+
+      // Skip over any padding at the end of the data area (clearing its
+      // header, since the rest of it is already zero)
+      if ((headerWord & AT_RING_SKIP) != 0)
+      {
+         atomicStore((atAtomic *) &ring_data[offset], 0);
+         consumerPos += headerWord & AT_RING_LEN_MASK;
+         atomicStore(&ring_control->consumer_pos, consumerPos);
+      }
+      else
+      {
+         // Here's the entry
+         *entryLen = headerWord & AT_RING_LEN_MASK;
+         return &ring_data[offset + AT_RING_HEADER_LEN];
+      }
+   }
+}
+
+
+void atRingBuffer::release()
+{
+   u_char *   entry;
+   u_long     entryLen;
+   uint32_t   entrySize;
+
+   // Find the entry that peek() would return, zero it (so a producer
+   // that later claims this space can tell its header hasn't been written
+   // yet) and move past it, giving its space back to the producers
+   entry = peek(&entryLen);
+   if (entry != NULL)
+   {
+      entrySize = AT_RING_ENTRY_SIZE((uint32_t ) entryLen);
+      memset(entry - AT_RING_HEADER_LEN, 0, entrySize);
+      atomicStore(&ring_control->consumer_pos, 
+                  ring_control->consumer_pos + entrySize);
+   }
+}
+
+
+bool atRingBuffer::enqueue(u_char * buffer, u_long bufferLen)
+{
+   u_char *   entry;
+
+   // Claim space, copy the buffer in and publish it
+   entry = reserve(bufferLen);
+   if (entry == NULL)
+      return false;
+   memcpy(entry, buffer, bufferLen);
+   commit(entry);
+   return true;
+}
+
+
+bool atRingBuffer::dequeue(u_char * buffer, u_long * bufferLen)
+{
+   u_char *   entry;
+   u_long     entryLen;
+
+   // See if there's anything to dequeue
+   entry = peek(&entryLen);
+   if (entry == NULL)
+   {
+      *bufferLen = 0;
+      return false;
+   }
+
+   // Make sure the user's buffer can hold this entry
+   if (entryLen > *bufferLen)
+   {
+      notify(AT_WARN, "Queue entry is larger than buffer.  Not dequeueing.\n");
+      notify(AT_WARN, "Queue entry size was %lu, buffer size was %lu.\n",
+             entryLen, *bufferLen);
+      *bufferLen = 0;
+      return false;
+   }
+
+   // Copy the entry out and give its space back
+   memcpy(buffer, entry, entryLen);
+   *bufferLen = entryLen;
+   release();
+   return true;
+}
+
+
+bool atRingBuffer::isEmpty()
+{
+   u_long   entryLen;
+
+   // Empty means there's no committed entry for us to read
+   return (peek(&entryLen) == NULL);
+}
+
+
+bool atRingBuffer::waitForEntry(u_long timeoutMicrosecs)
+{
+   uint32_t   sequence;
+
+   if (ring_control == NULL)
+      return false;
+
+   // Don't wait if there's already something there
+   if (isEmpty() == false)
+      return true;
+
+   // Tell the producers we're going to sleep, then check again in case
+   // an entry showed up in the meantime (the producers check the flag
+   // after publishing, so one side or the other sees the change)
+   sequence = atomicLoad(&ring_control->wake_sequence);
+   atomicStore(&ring_control->consumer_waiting, 1);
+   atomicFence();
+   if (isEmpty() == false)
+   {
+      atomicStore(&ring_control->consumer_waiting, 0);
+      return true;
+   }
+
+   // Sleep until a producer bumps the wake sequence (or we time out)
+   atomicWait(&ring_control->wake_sequence, sequence, timeoutMicrosecs);
+   atomicStore(&ring_control->consumer_waiting, 0);
+
+   // Let the caller know whether there's something to dequeue now
+   return (isEmpty() == false);
+}
+
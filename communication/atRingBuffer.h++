@@ -0,0 +1,116 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AT_RING_BUFFER_H
+#define AT_RING_BUFFER_H
+
+
+// INCLUDES
+#include <sys/types.h>
+#include "atNotifier.h++"
+#include "atOSDefs.h++"
+
+
+// CONSTANTS
+// Ways for atSharedQueue and atThreadQueue to manage their buffers.  The
+// locked mode is the original growable queue, where every operation holds
+// a semaphore.  The ring modes use a fixed-size atRingBuffer instead (only
+// one thread or process may dequeue from a ring; the single-producer
+// ring also allows only one thread or process to enqueue).  Producers on
+// a ring claim space with a compare-and-swap on the producer position and
+// never hold a lock, so a producer that dies doesn't stop the others.  A
+// producer that dies between reserve() and commit() does leave its entry
+// unfinished, though, and the consumer can't get past it.
+enum atQueueMode
+{
+   AT_QUEUE_LOCKED,
+   AT_QUEUE_RING_SPSC,
+   AT_QUEUE_RING_MPSC
+};
+
+
+// TYPES
+// Control block at the start of the ring's memory.  The producer and
+// consumer sides are kept on separate cache lines so they don't slow
+// each other down.  Positions are byte counts that run freely and wrap
+// at 2^32; the offset into the data area is the position modulo the
+// (power of two) ring size.
+typedef struct
+{
+   atAtomic   ring_magic;
+   uint32_t   ring_size;
+   uint32_t   ring_pad0[14];
+
+   atAtomic   producer_pos;
+   uint32_t   ring_pad1[15];
+
+   atAtomic   consumer_pos;
+   atAtomic   consumer_waiting;
+   atAtomic   wake_sequence;
+   uint32_t   ring_pad2[13];
+} atRingControl;
+
+
+class ATLAS_SYM atRingBuffer : public atNotifier
+{
+   protected:
+      atRingControl *   ring_control;
+      u_char *          ring_data;
+      uint32_t          ring_mask;
+      bool              multi_producer;
+
+      bool              claimSpace(uint32_t producerPos, uint32_t newPos);
+      void              wakeConsumer();
+
+   public:
+      static u_long     getMemorySize(u_long dataSize);
+
+      atRingBuffer(u_char * memory, u_long memorySize, bool initialize,
+                   bool multiProducer);
+      virtual ~atRingBuffer();
+
+      bool              isValid();
+      u_long            getDataSize();
+      u_long            getMaxEntrySize();
+      u_long            getUsedSize();
+
+      virtual u_char *  reserve(u_long entryLen);
+      virtual void      commit(u_char * entry);
+
+      virtual u_char *  peek(u_long * entryLen);
+      virtual void      release();
+
+      virtual bool      enqueue(u_char * buffer, u_long bufferLen);
+      virtual bool      dequeue(u_char * buffer, u_long * bufferLen);
+
+      virtual bool      isEmpty();
+      virtual bool      waitForEntry(u_long timeoutMicrosecs);
+};
+
+
+#endif
+
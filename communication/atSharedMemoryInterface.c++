@@ -32,6 +32,8 @@
 #define AT_SHM_INIT_QUEUE_SIZE   5000 
 #define AT_SHM_INC_QUEUE_SIZE   10000
 
+#define AT_SHM_RING_QUEUE_SIZE   65536
+
 
 atSharedMemoryInterface::atSharedMemoryInterface(ShmKey readKey, ShmKey writeKey)
 {
@@ -48,6 +50,25 @@ atSharedMemoryInterface::atSharedMemoryInterface(ShmKey readKey, ShmKey writeKey
 }
 
 
+atSharedMemoryInterface::atSharedMemoryInterface(ShmKey readKey, ShmKey writeKey,
+                                                 atQueueMode mode)
+{
+   u_long   initialSize;
+
+   // Same as above, but with the given kind of queue (both sides of the
+   // connection need to use the same mode).  A ring can't grow, so give
+   // it more room up front.
+   if (mode == AT_QUEUE_LOCKED)
+      initialSize = AT_SHM_INIT_QUEUE_SIZE;
+   else
+      initialSize = AT_SHM_RING_QUEUE_SIZE;
+   read_queue = new atSharedQueue(readKey, 0x10000-readKey, initialSize,
+                                  AT_SHM_INC_QUEUE_SIZE, mode);
+   write_queue = new atSharedQueue(writeKey, 0x10000-writeKey, initialSize,
+                                   AT_SHM_INC_QUEUE_SIZE, mode);
+}
+
+
 atSharedMemoryInterface::~atSharedMemoryInterface()
 {
    // Delete the shared queues
@@ -56,6 +77,22 @@ atSharedMemoryInterface::~atSharedMemoryInterface()
 }
 
 
+atSharedQueue * atSharedMemoryInterface::getReadQueue()
+{
+   // Return the queue we read from (so ring queue users can peek at
+   // entries in place or wait for them)
+   return read_queue;
+}
+
+
+atSharedQueue * atSharedMemoryInterface::getWriteQueue()
+{
+   // Return the queue we write to (so ring queue users can reserve space
+   // and write into it directly)
+   return write_queue;
+}
+
+
 int atSharedMemoryInterface::read(u_char * buffer, u_long length)
 {
    // Try to read the next queue entry
@@ -74,11 +111,11 @@ int atSharedMemoryInterface::read(u_char * buffer, u_long length)
 
 int atSharedMemoryInterface::write(u_char * buffer, u_long length)
 {
-   // Write the buffer to the queue
-   write_queue->enqueue(buffer, length);
-
-   // At least for now, we assume enqueuing to the shared buffer will work
-   // everytime
-   return length;
+   // Write the buffer to the queue (this only fails if the queue is a
+   // ring and it's full)
+   if (write_queue->enqueue(buffer, length) == true)
+      return length;
+   else
+      return 0;
 }
 
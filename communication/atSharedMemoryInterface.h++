@@ -44,8 +44,13 @@ class ATLAS_SYM atSharedMemoryInterface : public atIPCInterface
 
    public:
       atSharedMemoryInterface(ShmKey readKey, ShmKey writeKey);
+      atSharedMemoryInterface(ShmKey readKey, ShmKey writeKey,
+                              atQueueMode mode);
       virtual ~atSharedMemoryInterface();
 
+      atSharedQueue *   getReadQueue();
+      atSharedQueue *   getWriteQueue();
+
       int   read(u_char * buffer, u_long length);
       int   write(u_char * buffer, u_long length);
 };
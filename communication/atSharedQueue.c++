@@ -29,13 +29,35 @@
 #include <string.h>
 #include <sys/types.h>
 #include "atSharedQueue.h++"
+#include "atMetrics.h++"
 
 
 atSharedQueue::atSharedQueue(ShmKey controlKey, ShmKey dataKey, 
                              u_long initialSize, u_long incrementSize)
+{
+   // Use the original, semaphore-locked queue
+   initQueue(controlKey, dataKey, initialSize, incrementSize, 
+             AT_QUEUE_LOCKED);
+}
+
+
+atSharedQueue::atSharedQueue(ShmKey controlKey, ShmKey dataKey, 
+                             u_long initialSize, u_long incrementSize,
+                             atQueueMode mode)
+{
+   // Use whichever kind of queue was asked for (every process sharing
+   // the keys needs to ask for the same mode)
+   initQueue(controlKey, dataKey, initialSize, incrementSize, mode);
+}
+
+
+void atSharedQueue::initQueue(ShmKey controlKey, ShmKey dataKey, 
+                              u_long initialSize, u_long incrementSize,
+                              atQueueMode mode)
 {
    u_long        queueInfoSize;
    bool          createdControl;
+   bool          createdData;
 
    // Keep the keys to use later
    data_shm_key = dataKey;
@@ -50,6 +72,15 @@ atSharedQueue::atSharedQueue(ShmKey controlKey, ShmKey dataKey,
    // Keep the increment size for later use as well
    memory_increment_size = incrementSize;
 
+   // Remember which mode we're in.  A ring buffer has a fixed size, and
+   // keeps its own control block at the start of the data memory (the
+   // semaphore and control info are then only used while processes
+   // attach and detach).
+   queue_mode = mode;
+   ring_buffer = NULL;
+   if (queue_mode != AT_QUEUE_LOCKED)
+      initialSize = atRingBuffer::getMemorySize(initialSize);
+
    // Get a semaphore to control access to this shared memory buffer
    createdControl = semGet(sem_key, &sem_id);
    if (sem_id == INVALID_SEM_ID)
@@ -68,7 +99,7 @@ atSharedQueue::atSharedQueue(ShmKey controlKey, ShmKey dataKey,
    }
 
    // Get shared memory for the data buffer
-   shmGet(data_shm_key, initialSize, &data_shm_id);
+   createdData = shmGet(data_shm_key, initialSize, &data_shm_id);
    if (data_shm_id == INVALID_SHM_ID)
    {
       // Failed big time
@@ -110,6 +141,15 @@ atSharedQueue::atSharedQueue(ShmKey controlKey, ShmKey dataKey,
       // to tell everybody that we're here
       *connected_count = (*connected_count) + 1;
    }
+
+   // Set up the ring buffer if we're using one (whoever created the
+   // data memory initializes it, everybody else just attaches)
+   if (queue_mode != AT_QUEUE_LOCKED)
+   {
+      ring_buffer = new atRingBuffer(shared_buffer, initialSize, 
+                                     createdData,
+                                     (queue_mode == AT_QUEUE_RING_MPSC));
+   }
    unlock();
 
    // Initialize our local queue reallocation flag
@@ -124,6 +164,11 @@ atSharedQueue::~atSharedQueue()
    // Lock everything
    lock();
 
+   // We're done with the ring buffer (if any) before we detach from its
+   // memory
+   if (ring_buffer != NULL)
+      delete ring_buffer;
+
    // First, remove us from the count of people attached and keep a copy
    *connected_count = (*connected_count) - 1;
    newConnectedCount = *connected_count;
@@ -160,10 +205,19 @@ atSharedQueue::~atSharedQueue()
 }
 
 
+atQueueMode atSharedQueue::getMode()
+{
+   return queue_mode;
+}
+
+
 int atSharedQueue::lock()
 {
    int   result;
 
+   // Time how long we wait for the lock
+   AT_METRICS_TIMER(lockTimer, AT_METRIC_SHARED_QUEUE_LOCK_WAIT);
+
    // Try to do the lock and return either success or failure (if we failed
    // because of a reason besides that we were interrupted (by a signal), then
    // notify that fact to the user as well)
@@ -310,6 +364,9 @@ void atSharedQueue::reallocateQueue(u_long minimumToAdd)
 
       // Set our realloc tracker to this flag count
       last_realloc_num = *realloc_num;
+
+      // Count the reallocation
+      AT_METRICS_COUNT(AT_METRIC_SHARED_QUEUE_REALLOCATIONS, 1);
    }
 }
 
@@ -344,12 +401,28 @@ void atSharedQueue::checkForReallocatedQueue()
 }
 
 
-void atSharedQueue::enqueue(u_char * buffer, u_long bufferLen)
+bool atSharedQueue::enqueue(u_char * buffer, u_long bufferLen)
 {
    u_long     bufferWithHeaderLen;
    u_char *   bufferWithHeader;
    u_long     partialSize;
 
+   // A ring buffer doesn't grow, so this fails if the ring is full
+   if (queue_mode != AT_QUEUE_LOCKED)
+   {
+      if (!ring_buffer->enqueue(buffer, bufferLen))
+      {
+         AT_METRICS_COUNT(AT_METRIC_SHARED_QUEUE_FULL, 1);
+         return false;
+      }
+
+      // Count the entry and see how full the ring is now
+      AT_METRICS_COUNT(AT_METRIC_SHARED_QUEUE_MESSAGES_ENQUEUED, 1);
+      AT_METRICS_COUNT(AT_METRIC_SHARED_QUEUE_BYTES_ENQUEUED, bufferLen);
+      AT_METRICS_RECORD(AT_METRIC_SHARED_QUEUE_DEPTH, ring_buffer->getUsedSize());
+      return true;
+   }
+
    // Allocate space for a header and the buffer
    bufferWithHeaderLen = bufferLen + sizeof(u_long);
    bufferWithHeader = (u_char *) malloc(bufferWithHeaderLen);
@@ -424,11 +497,21 @@ void atSharedQueue::enqueue(u_char * buffer, u_long bufferLen)
       *queue_tail %= *queue_size;
    }
 
+   // See how full the queue is now (while we still hold the lock)
+   AT_METRICS_RECORD(AT_METRIC_SHARED_QUEUE_DEPTH, *queue_used);
+
    // Unlock access to the memory
    unlock();
 
    // Get rid of temporary buffer
    free(bufferWithHeader);
+
+   // Count the entry
+   AT_METRICS_COUNT(AT_METRIC_SHARED_QUEUE_MESSAGES_ENQUEUED, 1);
+   AT_METRICS_COUNT(AT_METRIC_SHARED_QUEUE_BYTES_ENQUEUED, bufferLen);
+
+   // The locked queue grows as needed, so this always works
+   return true;
 }
 
 
@@ -440,6 +523,18 @@ bool atSharedQueue::dequeue(u_char * buffer, u_long * bufferLen)
    u_long     partialSize;
    int        returnCode;
 
+   // A ring buffer handles this itself
+   if (queue_mode != AT_QUEUE_LOCKED)
+   {
+      if (!ring_buffer->dequeue(buffer, bufferLen))
+         return false;
+
+      // Count the entry
+      AT_METRICS_COUNT(AT_METRIC_SHARED_QUEUE_MESSAGES_DEQUEUED, 1);
+      AT_METRICS_COUNT(AT_METRIC_SHARED_QUEUE_BYTES_DEQUEUED, *bufferLen);
+      return true;
+   }
+
    // Initialize
    bufferWithHeader = NULL;
 
@@ -537,6 +632,10 @@ bool atSharedQueue::dequeue(u_char * buffer, u_long * bufferLen)
       *bufferLen = bufferWithHeaderLen - sizeof(bufferWithHeaderLen);
       memcpy(buffer, &bufferWithHeader[sizeof(bufferWithHeaderLen)],
              *bufferLen);
+
+      // Count the entry
+      AT_METRICS_COUNT(AT_METRIC_SHARED_QUEUE_MESSAGES_DEQUEUED, 1);
+      AT_METRICS_COUNT(AT_METRIC_SHARED_QUEUE_BYTES_DEQUEUED, *bufferLen);
    }
    else
       *bufferLen = 0;
@@ -549,3 +648,61 @@ bool atSharedQueue::dequeue(u_char * buffer, u_long * bufferLen)
    return returnCode;
 }
 
+
+u_char * atSharedQueue::reserve(u_long entryLen)
+{
+   // Only a ring buffer can hand out space to write into directly
+   if (queue_mode == AT_QUEUE_LOCKED)
+   {
+      notify(AT_WARN, "Reserving queue space requires a ring queue.\n");
+      return NULL;
+   }
+
+   // Returns NULL if the ring is full
+   return ring_buffer->reserve(entryLen);
+}
+
+
+void atSharedQueue::commit(u_char * entry)
+{
+   // Hand a reserved entry over to the reader
+   if (queue_mode != AT_QUEUE_LOCKED)
+      ring_buffer->commit(entry);
+}
+
+
+u_char * atSharedQueue::peek(u_long * entryLen)
+{
+   // Only a ring buffer can let the reader look at entries in place
+   if (queue_mode == AT_QUEUE_LOCKED)
+   {
+      notify(AT_WARN, "Peeking at queue entries requires a ring queue.\n");
+      return NULL;
+   }
+
+   // Returns NULL if there's nothing to read
+   return ring_buffer->peek(entryLen);
+}
+
+
+void atSharedQueue::release()
+{
+   // Done with the entry that peek() returned
+   if (queue_mode != AT_QUEUE_LOCKED)
+      ring_buffer->release();
+}
+
+
+bool atSharedQueue::waitForEntry(u_long timeoutMicrosecs)
+{
+   // Only a ring buffer can wake us up when something arrives
+   if (queue_mode == AT_QUEUE_LOCKED)
+   {
+      notify(AT_WARN, "Waiting for queue entries requires a ring queue.\n");
+      return false;
+   }
+
+   // Sleeps until there's an entry (or the timeout runs out)
+   return ring_buffer->waitForEntry(timeoutMicrosecs);
+}
+
@@ -33,6 +33,7 @@
 #include <sys/types.h>
 #include "atNotifier.h++"
 #include "atOSDefs.h++"
+#include "atRingBuffer.h++"
 
 
 class ATLAS_SYM atSharedQueue : public atNotifier
@@ -59,6 +60,12 @@ class ATLAS_SYM atSharedQueue : public atNotifier
 
       u_long     last_realloc_num;
 
+      atQueueMode      queue_mode;
+      atRingBuffer *   ring_buffer;
+
+      void     initQueue(ShmKey controlKey, ShmKey dataKey, 
+                         u_long initialSize, u_long incrementSize,
+                         atQueueMode mode);
       int      lock();
       int      unlock();
       u_long   spaceAvailable();
@@ -69,10 +76,20 @@ class ATLAS_SYM atSharedQueue : public atNotifier
    public:
       atSharedQueue(ShmKey controlKey, ShmKey dataKey, u_long initialSize, 
                     u_long incrementSize);
+      atSharedQueue(ShmKey controlKey, ShmKey dataKey, u_long initialSize, 
+                    u_long incrementSize, atQueueMode mode);
       virtual ~atSharedQueue();
 
-      virtual void   enqueue(u_char * buffer, u_long bufferLen);
-      virtual bool   dequeue(u_char * buffer, u_long * bufferLen);
+      atQueueMode        getMode();
+
+      virtual bool       enqueue(u_char * buffer, u_long bufferLen);
+      virtual bool       dequeue(u_char * buffer, u_long * bufferLen);
+
+      virtual u_char *   reserve(u_long entryLen);
+      virtual void       commit(u_char * entry);
+      virtual u_char *   peek(u_long * entryLen);
+      virtual void       release();
+      virtual bool       waitForEntry(u_long timeoutMicrosecs);
 };
 
 
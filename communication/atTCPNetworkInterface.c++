@@ -27,12 +27,124 @@
 
 // INCLUDES
 
+#include <stdlib.h>
 #include "atTCPNetworkInterface.h++"
+#include "atMetrics.h++"
 
 
 // CONSTANTS
 #define AT_TCP_MAX_PACKET_SIZE   65536
 
+// Initial room for client connections (grown as needed)
+#define AT_TCP_INITIAL_CLIENTS   16
+
+// Initial size of a connection's receive and send buffers, and the most
+// that can pile up unread in a receive buffer before we give up on the
+// connection
+#define AT_TCP_BUFFER_SIZE       4096
+#define AT_TCP_MAX_BUFFER_SIZE   (16 * 1024 * 1024)
+
+// Most bytes to pull from one connection per readiness event, so one busy
+// client can't starve the others
+#define AT_TCP_MAX_READ_SIZE     (256 * 1024)
+
+// Size of the framing header in front of each message
+#define AT_TCP_HEADER_SIZE       4
+
+// Number of readiness events to collect per processEvents() call
+#define AT_TCP_MAX_POLL_EVENTS   256
+
+// ID used for the listening socket in the poll set
+#define AT_TCP_LISTEN_ID         -1
+
+// Don't let a send to a closed connection kill the process with SIGPIPE
+#ifndef MSG_NOSIGNAL
+   #define MSG_NOSIGNAL   0
+#endif
+
+
+static void initConnection(atTCPConnection * connection, Socket socket)
+{
+   // Start with an open connection and no buffers
+   memset(connection, 0, sizeof(atTCPConnection));
+   connection->socket = socket;
+   connection->blocking = true;
+   connection->connected = true;
+}
+
+
+static void freeConnectionBuffers(atTCPConnection * connection)
+{
+   // Release the buffers and forget any data in them
+   free(connection->recv_buffer);
+   free(connection->send_buffer);
+   connection->recv_buffer = NULL;
+   connection->recv_start = 0;
+   connection->recv_end = 0;
+   connection->recv_capacity = 0;
+   connection->send_buffer = NULL;
+   connection->send_start = 0;
+   connection->send_end = 0;
+   connection->send_capacity = 0;
+}
+
+
+static void appendClientID(atTCPClientList * list, int id)
+{
+   // Grow the list if it's full
+   if (list->count == list->capacity)
+   {
+      list->capacity = (list->capacity == 0) ? 
+         AT_TCP_INITIAL_CLIENTS : list->capacity * 2;
+      list->ids = (int *) realloc(list->ids, list->capacity * sizeof(int));
+   }
+
+   // Add the ID
+   list->ids[list->count] = id;
+   list->count++;
+}
+
+
+static int takeClientID(atTCPClientList * list)
+{
+   int   id;
+
+   // If the list has been used up, empty it so it starts over
+   if (list->next >= list->count)
+   {
+      list->next = 0;
+      list->count = 0;
+      return -1;
+   }
+
+   // Hand back the next ID
+   id = list->ids[list->next];
+   list->next++;
+   return id;
+}
+
+
+static bool growBuffer(u_char ** buffer, u_long * capacity, u_long needed)
+{
+   u_long   newCapacity;
+   u_char * newBuffer;
+
+   // Double the buffer until it's big enough
+   newCapacity = (*capacity == 0) ? AT_TCP_BUFFER_SIZE : *capacity;
+   while (newCapacity < needed)
+      newCapacity *= 2;
+   if (newCapacity == *capacity)
+      return true;
+
+   // Reallocate it
+   newBuffer = (u_char *) realloc(*buffer, newCapacity);
+   if (newBuffer == NULL)
+      return false;
+   *buffer = newBuffer;
+   *capacity = newCapacity;
+   return true;
+}
+
 
 atTCPNetworkInterface::atTCPNetworkInterface(char * address, u_short port)
 {
@@ -78,7 +190,7 @@ atTCPNetworkInterface::atTCPNetworkInterface(char * address, u_short port)
    write_name.sin_port = htons(port);
 
    // Initialize remaining instance variables
-   num_client_sockets = 0;
+   initInterface();
 }
 
 
@@ -126,7 +238,7 @@ atTCPNetworkInterface::atTCPNetworkInterface(u_short port)
    write_name.sin_port = htons(port);
 
    // Initialize remaining instance variables
-   num_client_sockets = 0;
+   initInterface();
 }
 
 
@@ -134,16 +246,59 @@ atTCPNetworkInterface::~atTCPNetworkInterface()
 {
    u_long   i;
 
+   // Stop watching the sockets
+   if (poll_set != NULL)
+      pollSetDestroy(poll_set);
+   free(poll_events);
+
    // Close all the client sockets
    for (i=0; i < num_client_sockets; i++)
-      closeSocket(client_sockets[i]);
+   {
+      if (client_connections[i] != NULL)
+      {
+         if (client_connections[i]->connected)
+            closeSocket(client_connections[i]->socket);
+         freeConnectionBuffers(client_connections[i]);
+         free(client_connections[i]);
+      }
+   }
+   free(client_connections);
+
+   // Get rid of the event lists
+   free(accepted_clients.ids);
+   free(ready_clients.ids);
+   free(closed_clients.ids);
+   free(flush_clients.ids);
 
    // Close the socket
+   freeConnectionBuffers(&server_connection);
    if (socket_value != -1)
       closeSocket(socket_value);
 }
 
 
+void atTCPNetworkInterface::initInterface()
+{
+   // No clients yet
+   client_connections = NULL;
+   client_capacity = 0;
+   num_client_sockets = 0;
+
+   // Our own connection (used when we're the client)
+   initConnection(&server_connection, socket_value);
+   server_listening = false;
+
+   // Event mode is off until asked for
+   poll_set = NULL;
+   poll_events = NULL;
+   max_poll_events = 0;
+   memset(&accepted_clients, 0, sizeof(accepted_clients));
+   memset(&ready_clients, 0, sizeof(ready_clients));
+   memset(&closed_clients, 0, sizeof(closed_clients));
+   memset(&flush_clients, 0, sizeof(flush_clients));
+}
+
+
 bool atTCPNetworkInterface::allowConnections(int backlog)
 {
    bool   bindSuccess;
@@ -164,6 +319,14 @@ bool atTCPNetworkInterface::allowConnections(int backlog)
 
    // Notify our willingness to accept connections and give a backlog limit
    listen(socket_value, backlog);
+   server_listening = true;
+
+   // If we're already in event mode, start watching for new clients
+   if (poll_set != NULL)
+   {
+      setBlockingFlag(socket_value, false);
+      pollSetAdd(poll_set, socket_value, AT_TCP_LISTEN_ID, AT_POLL_READ);
+   }
 
    // Indicate to the user whether the port could be successfully bound
    return bindSuccess;
@@ -177,29 +340,35 @@ int atTCPNetworkInterface::acceptConnection()
    Socket               newSocket;
    struct sockaddr_in   connectingName;
    socklen_t            connectingNameLength;
-   SocketOptionValue    max;
-   SocketOptionValue    on;
-   u_char *             address;
-   u_short              addr0;
-   u_short              addr1;
-   u_short              addr2;
-   u_short              addr3;
+   int                  clientID;
 
-   // If we are in non-blocking mode, we use select() to see if
-   // there is a client connecting; othwew
-   FD_ZERO(&readFds);
-   FD_SET(socket_value, &readFds);
-   timeout.tv_sec = 0;
-   timeout.tv_usec = 10000;
-   if (select(socket_value+1, &readFds, NULL, NULL, &timeout) <= 0)
-   {
-      // We did not get a connection in time so determine our action
-      // based on whether we're in non-blocking mode or not
-      if (blocking_mode == false)
+   // In event mode, hand out any clients that processEvents() has
+   // already accepted; otherwise just try to accept (the listening
+   // socket is non-blocking in this mode, so we won't wait)
+   if (poll_set != NULL)
+   {
+      clientID = getNextAcceptedClient();
+      if (clientID >= 0)
+         return clientID;
+   }
+   else
+   {
+      // If we are in non-blocking mode, we use select() to see if
+      // there is a client connecting; othwew
+      FD_ZERO(&readFds);
+      FD_SET(socket_value, &readFds);
+      timeout.tv_sec = 0;
+      timeout.tv_usec = 10000;
+      if (select(socket_value+1, &readFds, NULL, NULL, &timeout) <= 0)
       {
-         // We're in non-blocking mode so just return -1; otherwise, we
-         // we fill fall through and just call accept() and block
-         return -1;
+         // We did not get a connection in time so determine our action
+         // based on whether we're in non-blocking mode or not
+         if (blocking_mode == false)
+         {
+            // We're in non-blocking mode so just return -1; otherwise, we
+            // we fill fall through and just call accept() and block
+            return -1;
+         }
       }
    }
 
@@ -219,57 +388,140 @@ int atTCPNetworkInterface::acceptConnection()
       return -1;
    }
    else
+      return addClient(newSocket, &connectingName);
+}
+
+
+int atTCPNetworkInterface::addClient(Socket newSocket,
+                                     struct sockaddr_in * connectingName)
+{
+   SocketOptionValue    max;
+   SocketOptionValue    on;
+   atTCPConnection *    connection;
+   u_char *             address;
+   u_short              addr0;
+   u_short              addr1;
+   u_short              addr2;
+   u_short              addr3;
+
+   // Set the max buffer size for this new socket (Windows has very
+   // low defaults so we fix them across our applications)
+   max = AT_TCP_MAX_PACKET_SIZE;
+   if (setsockopt(newSocket, SOL_SOCKET, SO_SNDBUF, 
+                  (char *) &max, sizeof(max)) < 0)
+      perror("setsockopt sndbuf");
+   if (setsockopt(newSocket, SOL_SOCKET, SO_RCVBUF, 
+                  (char *) &max, sizeof(max)) < 0)
+      perror("setsockopt sndbuf");
+
+   // Set option to send KEEPALIVE (this prevents TCP connections from 
+   // being closed on inactivity)
+   on = 1;
+   if (setsockopt(newSocket, SOL_SOCKET, SO_KEEPALIVE, 
+                  (char *) &on, sizeof(on)) < 0)
+   {
+      perror("setsockopt keepalive");
+   }
+
+   // In event mode, the new client is watched along with all the others
+   if (poll_set != NULL)
    {
-      // Set the max buffer size for this new socket (Windows has very
-      // low defaults so we fix them across our applications)
-      max = AT_TCP_MAX_PACKET_SIZE;
-      if (setsockopt(socket_value, SOL_SOCKET, SO_SNDBUF, 
-                     (char *) &max, sizeof(max)) < 0)
-         perror("setsockopt sndbuf");
-      if (setsockopt(socket_value, SOL_SOCKET, SO_RCVBUF, 
-                     (char *) &max, sizeof(max)) < 0)
-         perror("setsockopt sndbuf");
-
-      // Set option to send KEEPALIVE (this prevents TCP connections from 
-      // being closed on inactivity)
-      on = 1;
-      if (setsockopt(socket_value, SOL_SOCKET, SO_KEEPALIVE, 
-                     (char *) &on, sizeof(on)) < 0)
+      setBlockingFlag(newSocket, false);
+      if (!pollSetAdd(poll_set, newSocket, (int ) num_client_sockets,
+                      AT_POLL_READ))
       {
-         perror("setsockopt keepalive");
+         notify(AT_WARN, "Unable to watch new client; closing it.\n");
+         closeSocket(newSocket);
+         return -1;
       }
+   }
 
-      // Store the data for this connection (address handling is a bit
-      // nasty so that it also works in Windows)
-      client_sockets[num_client_sockets] = newSocket;
-      address = (u_char *) &connectingName.sin_addr.s_addr;
-      addr0 = 0x00ff & address[0];
-      addr1 = 0x00ff & address[1];
-      addr2 = 0x00ff & address[2];
-      addr3 = 0x00ff & address[3];
-      sprintf(client_addrs[num_client_sockets].address, "%hhu.%hhu.%hhu.%hhu",
-              addr0, addr1, addr2, addr3);
-      client_addrs[num_client_sockets].port = connectingName.sin_port;
-      client_blocking[num_client_sockets] = true;
-      num_client_sockets++;
-      return num_client_sockets - 1;
+   // Make room for the new client if we need to
+   if (num_client_sockets == client_capacity)
+   {
+      client_capacity = (client_capacity == 0) ? 
+         AT_TCP_INITIAL_CLIENTS : client_capacity * 2;
+      client_connections = (atTCPConnection **) 
+         realloc(client_connections,
+                 client_capacity * sizeof(atTCPConnection *));
    }
+
+   // Store the data for this connection (address handling is a bit
+   // nasty so that it also works in Windows)
+   connection = (atTCPConnection *) malloc(sizeof(atTCPConnection));
+   initConnection(connection, newSocket);
+   address = (u_char *) &connectingName->sin_addr.s_addr;
+   addr0 = 0x00ff & address[0];
+   addr1 = 0x00ff & address[1];
+   addr2 = 0x00ff & address[2];
+   addr3 = 0x00ff & address[3];
+   sprintf(connection->addr.address, "%hhu.%hhu.%hhu.%hhu",
+           addr0, addr1, addr2, addr3);
+   connection->addr.port = connectingName->sin_port;
+   client_connections[num_client_sockets] = connection;
+   num_client_sockets++;
+   return num_client_sockets - 1;
+}
+
+
+atTCPConnection * atTCPNetworkInterface::getClient(int clientID)
+{
+   // Make sure the ID refers to a client we still have
+   if ((clientID < 0) || ((u_long ) clientID >= num_client_sockets))
+      return NULL;
+   return client_connections[clientID];
+}
+
+
+void atTCPNetworkInterface::dropClient(int clientID)
+{
+   atTCPConnection *   connection;
+
+   // Stop watching and close the client's socket (any data already
+   // received stays around until the client is closed by the user)
+   connection = getClient(clientID);
+   if ((connection == NULL) || (!connection->connected))
+      return;
+   if (poll_set != NULL)
+      pollSetRemove(poll_set, connection->socket);
+   closeSocket(connection->socket);
+   connection->socket = -1;
+   connection->connected = false;
 }
 
 
 void atTCPNetworkInterface::enableBlockingOnClient(int clientID)
 {
-   // Set the client socket to blocking
-   client_blocking[clientID] = true;
-   setBlockingFlag(client_sockets[clientID], true);
+   atTCPConnection *   connection;
+
+   // Set the client socket to blocking (in event mode, the socket itself
+   // stays non-blocking until event mode is turned off)
+   connection = getClient(clientID);
+   if (connection == NULL)
+   {
+      notify(AT_WARN, "Invalid client ID.\n");
+      return;
+   }
+   connection->blocking = true;
+   if ((poll_set == NULL) && (connection->connected))
+      setBlockingFlag(connection->socket, true);
 }
 
 
 void atTCPNetworkInterface::disableBlockingOnClient(int clientID)
 {
+   atTCPConnection *   connection;
+
    // Set the client socket to non-blocking
-   client_blocking[clientID] = false;
-   setBlockingFlag(client_sockets[clientID], false);
+   connection = getClient(clientID);
+   if (connection == NULL)
+   {
+      notify(AT_WARN, "Invalid client ID.\n");
+      return;
+   }
+   connection->blocking = false;
+   if (connection->connected)
+      setBlockingFlag(connection->socket, false);
 }
 
 
@@ -303,36 +555,84 @@ void atTCPNetworkInterface::disableDelay()
 
 void atTCPNetworkInterface::enableDelayOnClient(int clientID)
 {
-   SocketOptionFlag   flag;
+   atTCPConnection *   connection;
+   SocketOptionFlag    flag;
 
    // Set the NO_DELAY flag to false
    flag = 0;
 
    // Try to enable TCP delay on the socket
-   if (setsockopt(client_sockets[clientID], IPPROTO_TCP, TCP_NODELAY,
-                  &flag, sizeof(int)) < 0)
+   connection = getClient(clientID);
+   if ((connection == NULL) ||
+       (setsockopt(connection->socket, IPPROTO_TCP, TCP_NODELAY,
+                   &flag, sizeof(int)) < 0))
       notify(AT_ERROR, "Unable to enable TCP delay on socket.\n");
 }
 
 
 void atTCPNetworkInterface::disableDelayOnClient(int clientID)
 {
-   SocketOptionFlag   flag;
+   atTCPConnection *   connection;
+   SocketOptionFlag    flag;
 
    // Set the NO_DELAY flag to true
    flag = 1;
 
    // Try to disable TCP delay on the socket
-   if (setsockopt(client_sockets[clientID], IPPROTO_TCP, TCP_NODELAY,
-                  &flag, sizeof(int)) < 0)
+   connection = getClient(clientID);
+   if ((connection == NULL) ||
+       (setsockopt(connection->socket, IPPROTO_TCP, TCP_NODELAY,
+                   &flag, sizeof(int)) < 0))
       notify(AT_ERROR, "Unable to disable TCP delay on socket.\n");
 }
 
 
 ClientAddr atTCPNetworkInterface::getClientInfo(int clientID)
 {
+   atTCPConnection *   connection;
+   ClientAddr          noAddr;
+
    // Return the information for this client ID
-   return client_addrs[clientID];
+   connection = getClient(clientID);
+   if (connection == NULL)
+   {
+      memset(&noAddr, 0, sizeof(noAddr));
+      return noAddr;
+   }
+   return connection->addr;
+}
+
+
+u_long atTCPNetworkInterface::getNumClients()
+{
+   // Client IDs aren't reused, so this is also one more than the
+   // highest ID handed out so far
+   return num_client_sockets;
+}
+
+
+bool atTCPNetworkInterface::isClientConnected(int clientID)
+{
+   atTCPConnection *   connection;
+
+   // See if the client is still there
+   connection = getClient(clientID);
+   return ((connection != NULL) && (connection->connected));
+}
+
+
+void atTCPNetworkInterface::closeClient(int clientID)
+{
+   atTCPConnection *   connection;
+
+   // Close the connection and throw away everything we had for it
+   connection = getClient(clientID);
+   if (connection == NULL)
+      return;
+   dropClient(clientID);
+   freeConnectionBuffers(connection);
+   free(connection);
+   client_connections[clientID] = NULL;
 }
 
 
@@ -348,6 +648,12 @@ int atTCPNetworkInterface::makeConnection()
    SocketOptionValue    max;
    SocketOptionValue    on;
 
+   // Forget anything left over from a previous connection
+   server_connection.recv_start = 0;
+   server_connection.recv_end = 0;
+   server_connection.send_start = 0;
+   server_connection.send_end = 0;
+
    // Loop until we stop it
    keepTrying = 1;
    while (keepTrying == 1)
@@ -491,81 +797,734 @@ int atTCPNetworkInterface::makeConnection()
 
 int atTCPNetworkInterface::read(u_char * buffer, u_long len)
 {
-   struct sockaddr_in   fromAddress;
-   socklen_t            fromAddressLength;
-   int                  packetLength;
+   int   result;
+
+   // Read from our connection to the server
+   server_connection.socket = socket_value;
+   server_connection.blocking = blocking_mode;
+   result = readRaw(&server_connection, buffer, len);
 
-   // Get a packet
-   fromAddressLength = sizeof(fromAddress);
-   if (blocking_mode == true)
+   // Count what we got
+   if (result > 0)
    {
-      packetLength = recvfrom(socket_value, (char *) buffer, len, MSG_WAITALL, 
-                              (struct sockaddr *) &fromAddress, 
-                              &fromAddressLength);
+      AT_METRICS_COUNT(AT_METRIC_TCP_MESSAGES_READ, 1);
+      AT_METRICS_COUNT(AT_METRIC_TCP_BYTES_READ, result);
    }
-   else
+   return result;
+}
+
+
+int atTCPNetworkInterface::read(int clientID, u_char * buffer, u_long len)
+{
+   atTCPConnection *   connection;
+   int                 result;
+
+   // Read from the client
+   connection = getClient(clientID);
+   if (connection == NULL)
+      return -1;
+   result = readRaw(connection, buffer, len);
+
+   // Count what we got
+   if (result > 0)
    {
-      packetLength = recvfrom(socket_value, (char *) buffer, len, 0, 
-                              (struct sockaddr *) &fromAddress, 
-                              &fromAddressLength);
+      AT_METRICS_COUNT(AT_METRIC_TCP_MESSAGES_READ, 1);
+      AT_METRICS_COUNT(AT_METRIC_TCP_BYTES_READ, result);
    }
+   return result;
+}
 
-   // Tell user how many bytes we read (-1 means an error)
-   return packetLength;
+
+int atTCPNetworkInterface::write(u_char * buffer, u_long len)
+{
+   int   result;
+
+   // Write to our connection to the server
+   server_connection.socket = socket_value;
+   server_connection.blocking = blocking_mode;
+   result = writeRaw(&server_connection, buffer, len);
+
+   // Count what went out
+   if (result > 0)
+   {
+      AT_METRICS_COUNT(AT_METRIC_TCP_MESSAGES_WRITTEN, 1);
+      AT_METRICS_COUNT(AT_METRIC_TCP_BYTES_WRITTEN, result);
+   }
+   return result;
 }
 
 
-int atTCPNetworkInterface::read(int clientID, u_char * buffer, u_long len)
+int atTCPNetworkInterface::write(int clientID, u_char * buffer, u_long len)
 {
-   struct sockaddr_in   fromAddress;
-   socklen_t            fromAddressLength;
-   int                  packetLength;
+   atTCPConnection *   connection;
+   int                 result;
+
+   // Write to the client
+   connection = getClient(clientID);
+   if ((connection == NULL) || (!connection->connected))
+      return -1;
+   result = writeRaw(connection, buffer, len);
 
-   // Get a packet
-   fromAddressLength = sizeof(fromAddress);
-   if (client_blocking[clientID] == true)
+   // Count what went out
+   if (result > 0)
    {
-      packetLength = recvfrom(client_sockets[clientID], (char *) buffer, len, 
-                              MSG_WAITALL,
-                              (struct sockaddr *) &fromAddress, 
-                              &fromAddressLength);
+      AT_METRICS_COUNT(AT_METRIC_TCP_MESSAGES_WRITTEN, 1);
+      AT_METRICS_COUNT(AT_METRIC_TCP_BYTES_WRITTEN, result);
    }
-   else
+   return result;
+}
+
+
+int atTCPNetworkInterface::readRaw(atTCPConnection * connection,
+                                   u_char * buffer, u_long len)
+{
+   u_long   copied;
+   bool     waitAll;
+   int      packetLength;
+
+   // Anything already pulled in by the event mode or the message calls
+   // comes first
+   copied = connection->recv_end - connection->recv_start;
+   if (copied > len)
+      copied = len;
+   if (copied > 0)
    {
-      packetLength = recvfrom(client_sockets[clientID], (char *) buffer, len, 
-                              0,
-                              (struct sockaddr *) &fromAddress, 
-                              &fromAddressLength);
+      memcpy(buffer, &connection->recv_buffer[connection->recv_start], copied);
+      connection->recv_start += copied;
    }
 
+   // A blocking read waits for everything that was asked for; otherwise
+   // we return whatever we have (sockets are never blocking in event mode)
+   waitAll = (connection->blocking) && 
+             ((poll_set == NULL) || (connection == &server_connection));
+   if ((copied == len) || ((copied > 0) && (!waitAll)))
+      return copied;
+   if (!connection->connected)
+      return (copied > 0) ? (int ) copied : -1;
+
+   // Get the rest from the socket
+   packetLength = recv(connection->socket, (char *) &buffer[copied],
+                       len - copied, waitAll ? MSG_WAITALL : 0);
+
    // Tell user how many bytes we read (-1 means an error)
-   return packetLength;
+   if (packetLength < 0)
+      return (copied > 0) ? (int ) copied : packetLength;
+   return copied + packetLength;
 }
 
 
-int atTCPNetworkInterface::write(u_char * buffer, u_long len)
+int atTCPNetworkInterface::writeRaw(atTCPConnection * connection,
+                                    u_char * buffer, u_long len)
+{
+   // If there are queued messages still waiting to go out, this data
+   // has to go after them
+   if (connection->send_start < connection->send_end)
+   {
+      if (!appendData(connection, buffer, len))
+         return -1;
+      drainBuffer(connection);
+      return len;
+   }
+
+   // Write the packet (-1 if error)
+   return send(connection->socket, (const char *) buffer, len, MSG_NOSIGNAL);
+}
+
+
+bool atTCPNetworkInterface::fillBuffer(atTCPConnection * connection)
 {
-   int   lengthWritten;
+   u_long   space;
+   u_long   total;
+   bool     singleRead;
+   int      received;
+   int      errorCode;
+
+   // Move unread data to the front of the buffer, so we have the most
+   // room possible at the end
+   if (connection->recv_start == connection->recv_end)
+   {
+      connection->recv_start = 0;
+      connection->recv_end = 0;
+   }
+   else if (connection->recv_start > 0)
+   {
+      memmove(connection->recv_buffer,
+              &connection->recv_buffer[connection->recv_start],
+              connection->recv_end - connection->recv_start);
+      connection->recv_end -= connection->recv_start;
+      connection->recv_start = 0;
+   }
+
+   // A blocking socket only gets a single recv() (another would wait
+   // for more data); non-blocking sockets are read until they're empty
+   singleRead = (connection->blocking) && 
+                ((poll_set == NULL) || (connection == &server_connection));
+
+   // Keep reading until the socket has nothing more for us
+   total = 0;
+   while (total < AT_TCP_MAX_READ_SIZE)
+   {
+      // Make sure there's room to read into
+      if (connection->recv_end == connection->recv_capacity)
+      {
+         if ((connection->recv_capacity >= AT_TCP_MAX_BUFFER_SIZE) ||
+             (!growBuffer(&connection->recv_buffer,
+                          &connection->recv_capacity,
+                          connection->recv_capacity + 1)))
+         {
+            notify(AT_WARN, "Too much unread data on connection.\n");
+            return false;
+         }
+      }
 
-   // Write the packet
-   lengthWritten = sendto(socket_value, (const char *) buffer, len, 0, 
-                          (struct sockaddr *) &write_name, write_name_length);
+      // Read what we can
+      space = connection->recv_capacity - connection->recv_end;
+      received = recv(connection->socket,
+                      (char *) &connection->recv_buffer[connection->recv_end],
+                      space, 0);
+      if (received > 0)
+      {
+         // Got some; a short read means the socket is empty
+         connection->recv_end += received;
+         total += received;
+         if ((singleRead) || ((u_long ) received < space))
+            return true;
+      }
+      else if (received == 0)
+      {
+         // The other side closed the connection
+         return false;
+      }
+      else
+      {
+         // Nothing more to read is fine, anything else is a problem
+         errorCode = getLastError();
+         if (errorCode == EWOULDBLOCK)
+            return true;
+         if (errorCode != EINTR)
+            return false;
+      }
+   }
 
-   // Tell user how many bytes we wrote (-1 if error)
-   return lengthWritten;
+   // Leave the rest for the next time around
+   return true;
 }
 
 
-int atTCPNetworkInterface::write(int clientID, u_char * buffer, u_long len)
+bool atTCPNetworkInterface::hasMessage(atTCPConnection * connection)
+{
+   u_long     available;
+   uint32_t   messageLength;
+
+   // See if there's a complete header and message in the buffer
+   available = connection->recv_end - connection->recv_start;
+   if (available < AT_TCP_HEADER_SIZE)
+      return false;
+   memcpy(&messageLength, &connection->recv_buffer[connection->recv_start],
+          AT_TCP_HEADER_SIZE);
+   return (available - AT_TCP_HEADER_SIZE >= ntohl(messageLength));
+}
+
+
+int atTCPNetworkInterface::extractMessage(atTCPConnection * connection,
+                                          u_char * buffer, u_long len)
+{
+   uint32_t   messageLength;
+
+   // Nothing to do unless a whole message is waiting
+   if (!hasMessage(connection))
+      return 0;
+
+   // Make sure the caller has room for it (if not, we leave it for them
+   // to try again with a bigger buffer)
+   memcpy(&messageLength, &connection->recv_buffer[connection->recv_start],
+          AT_TCP_HEADER_SIZE);
+   messageLength = ntohl(messageLength);
+   if (messageLength > len)
+   {
+      notify(AT_WARN, "Buffer too small for message (%u bytes).\n",
+             messageLength);
+      return -1;
+   }
+
+   // Hand it over
+   memcpy(buffer,
+          &connection->recv_buffer[connection->recv_start + AT_TCP_HEADER_SIZE],
+          messageLength);
+   connection->recv_start += AT_TCP_HEADER_SIZE + messageLength;
+
+   // Count the message
+   AT_METRICS_COUNT(AT_METRIC_TCP_MESSAGES_READ, 1);
+   AT_METRICS_COUNT(AT_METRIC_TCP_BYTES_READ, messageLength);
+   return messageLength;
+}
+
+
+bool atTCPNetworkInterface::appendData(atTCPConnection * connection,
+                                       u_char * buffer, u_long len)
+{
+   u_long   pending;
+
+   // If there isn't room at the end, move pending data to the front and
+   // grow the buffer if that's still not enough
+   pending = connection->send_end - connection->send_start;
+   if (connection->send_end + len > connection->send_capacity)
+   {
+      if (connection->send_start > 0)
+      {
+         memmove(connection->send_buffer,
+                 &connection->send_buffer[connection->send_start], pending);
+         connection->send_start = 0;
+         connection->send_end = pending;
+      }
+      if (!growBuffer(&connection->send_buffer, &connection->send_capacity,
+                      pending + len))
+      {
+         notify(AT_WARN, "Unable to grow send buffer.\n");
+         return false;
+      }
+   }
+
+   // Add the data
+   memcpy(&connection->send_buffer[connection->send_end], buffer, len);
+   connection->send_end += len;
+   return true;
+}
+
+
+bool atTCPNetworkInterface::drainBuffer(atTCPConnection * connection)
+{
+   int   sent;
+   int   errorCode;
+
+   // Send as much of the pending data as the socket will take
+   while (connection->send_start < connection->send_end)
+   {
+      sent = send(connection->socket,
+                  (const char *) &connection->send_buffer[connection->send_start],
+                  connection->send_end - connection->send_start, MSG_NOSIGNAL);
+      if (sent > 0)
+         connection->send_start += sent;
+      else
+      {
+         // The socket being full is fine (we'll finish later), anything
+         // else is a problem
+         errorCode = getLastError();
+         if (errorCode == EWOULDBLOCK)
+            return true;
+         if (errorCode != EINTR)
+            return false;
+      }
+   }
+
+   // Everything went out, so start the buffer over
+   connection->send_start = 0;
+   connection->send_end = 0;
+   return true;
+}
+
+
+void atTCPNetworkInterface::updateWriteInterest(int clientID,
+                                                atTCPConnection * connection)
+{
+   bool   pending;
+
+   // Only ask to hear about the socket being writable while we have
+   // something left to write (otherwise we'd be told all the time)
+   pending = (connection->send_start < connection->send_end);
+   if (pending != connection->write_armed)
+   {
+      pollSetModify(poll_set, connection->socket, clientID,
+                    pending ? (AT_POLL_READ | AT_POLL_WRITE) : AT_POLL_READ);
+      connection->write_armed = pending;
+   }
+}
+
+
+int atTCPNetworkInterface::readMessage(u_char * buffer, u_long len)
+{
+   int   result;
+
+   // Use our connection to the server
+   server_connection.socket = socket_value;
+   server_connection.blocking = blocking_mode;
+
+   // Give any unsent data another chance to go out
+   drainBuffer(&server_connection);
+
+   // Pull in data until a whole message arrives (if we're not blocking,
+   // we only try once)
+   while (!hasMessage(&server_connection))
+   {
+      if (!fillBuffer(&server_connection))
+         return -1;
+      if ((!blocking_mode) && (!hasMessage(&server_connection)))
+         return 0;
+   }
+
+   // Return the message
+   result = extractMessage(&server_connection, buffer, len);
+   return result;
+}
+
+
+int atTCPNetworkInterface::readMessage(int clientID, u_char * buffer,
+                                       u_long len)
+{
+   atTCPConnection *   connection;
+
+   // Make sure the client is valid
+   connection = getClient(clientID);
+   if (connection == NULL)
+      return -1;
+
+   // In event mode, processEvents() does the reading for us; otherwise
+   // read from the socket until we have a whole message (or once, if the
+   // client isn't blocking)
+   if ((poll_set == NULL) && (connection->connected))
+   {
+      while (!hasMessage(connection))
+      {
+         if (!fillBuffer(connection))
+         {
+            dropClient(clientID);
+            break;
+         }
+         if ((!connection->blocking) && (!hasMessage(connection)))
+            return 0;
+      }
+   }
+
+   // A closed client can still hand back what it sent before it went
+   // away, but once that's gone it's an error
+   if ((!connection->connected) && (!hasMessage(connection)))
+      return -1;
+   return extractMessage(connection, buffer, len);
+}
+
+
+int atTCPNetworkInterface::writeMessage(u_char * buffer, u_long len)
+{
+   uint32_t   header;
+
+   // Empty messages aren't allowed (they couldn't be told apart from
+   // no message on the other end)
+   if (len == 0)
+      return 0;
+
+   // Queue the header and message, then send as much as we can
+   server_connection.socket = socket_value;
+   server_connection.blocking = blocking_mode;
+   header = htonl((uint32_t ) len);
+   if ((!appendData(&server_connection, (u_char *) &header,
+                    AT_TCP_HEADER_SIZE)) ||
+       (!appendData(&server_connection, buffer, len)))
+      return -1;
+   if (!drainBuffer(&server_connection))
+      return -1;
+
+   // Count the message
+   AT_METRICS_COUNT(AT_METRIC_TCP_MESSAGES_WRITTEN, 1);
+   AT_METRICS_COUNT(AT_METRIC_TCP_BYTES_WRITTEN, len);
+   return len;
+}
+
+
+int atTCPNetworkInterface::writeMessage(int clientID, u_char * buffer,
+                                        u_long len)
 {
-   int   lengthWritten;
+   atTCPConnection *   connection;
+   uint32_t            header;
+
+   // Make sure the client is valid (and skip empty messages, as above)
+   connection = getClient(clientID);
+   if ((connection == NULL) || (!connection->connected))
+      return -1;
+   if (len == 0)
+      return 0;
+
+   // Queue the header and message
+   header = htonl((uint32_t ) len);
+   if ((!appendData(connection, (u_char *) &header, AT_TCP_HEADER_SIZE)) ||
+       (!appendData(connection, buffer, len)))
+      return -1;
 
-   // Write the packet
-   lengthWritten = sendto(client_sockets[clientID], (const char *) buffer, len,
-                          0,  
-                          (struct sockaddr *) &write_name, write_name_length);
+   // In event mode, the message waits for the next flushClients() call;
+   // otherwise, send it now
+   if (poll_set != NULL)
+   {
+      if (!connection->flush_listed)
+      {
+         appendClientID(&flush_clients, clientID);
+         connection->flush_listed = true;
+      }
+   }
+   else if (!drainBuffer(connection))
+   {
+      dropClient(clientID);
+      return -1;
+   }
 
-   // Tell user how many bytes we wrote (-1 if error)
-   return lengthWritten;
+   // Count the message
+   AT_METRICS_COUNT(AT_METRIC_TCP_MESSAGES_WRITTEN, 1);
+   AT_METRICS_COUNT(AT_METRIC_TCP_BYTES_WRITTEN, len);
+   return len;
 }
 
+
+bool atTCPNetworkInterface::enableEventMode()
+{
+   atTCPConnection *   connection;
+   u_long              i;
+
+   // Nothing to do if we're already in event mode
+   if (poll_set != NULL)
+      return true;
+
+   // Create the poll set
+   poll_set = pollSetCreate();
+   if (poll_set == NULL)
+   {
+      notify(AT_ERROR, "Unable to create poll set for event mode.\n");
+      return false;
+   }
+   max_poll_events = AT_TCP_MAX_POLL_EVENTS;
+   poll_events = (atPollEvent *) malloc(max_poll_events * sizeof(atPollEvent));
+
+   // Watch for new clients if we're already listening
+   if (server_listening)
+   {
+      setBlockingFlag(socket_value, false);
+      pollSetAdd(poll_set, socket_value, AT_TCP_LISTEN_ID, AT_POLL_READ);
+   }
+
+   // Watch all the clients we already have (all sockets are non-blocking
+   // in event mode)
+   for (i = 0; i < num_client_sockets; i++)
+   {
+      connection = client_connections[i];
+      if ((connection != NULL) && (connection->connected))
+      {
+         setBlockingFlag(connection->socket, false);
+         connection->write_armed = false;
+         if (!pollSetAdd(poll_set, connection->socket, (int ) i,
+                         AT_POLL_READ))
+            notify(AT_WARN, "Unable to watch client %lu.\n", i);
+      }
+   }
+
+   return true;
+}
+
+
+void atTCPNetworkInterface::disableEventMode()
+{
+   atTCPConnection *   connection;
+   u_long              i;
+
+   // Nothing to do if we're not in event mode
+   if (poll_set == NULL)
+      return;
+
+   // Send anything still queued while the sockets are non-blocking
+   flushClients();
+
+   // Get rid of the poll set
+   pollSetDestroy(poll_set);
+   poll_set = NULL;
+   free(poll_events);
+   poll_events = NULL;
+   max_poll_events = 0;
+
+   // Put the sockets back the way the user had them
+   if (server_listening)
+      setBlockingFlag(socket_value, blocking_mode);
+   for (i = 0; i < num_client_sockets; i++)
+   {
+      connection = client_connections[i];
+      if ((connection != NULL) && (connection->connected))
+      {
+         setBlockingFlag(connection->socket, connection->blocking);
+         connection->write_armed = false;
+         connection->flush_listed = false;
+      }
+   }
+   flush_clients.count = 0;
+   flush_clients.next = 0;
+}
+
+
+bool atTCPNetworkInterface::isEventModeEnabled()
+{
+   return (poll_set != NULL);
+}
+
+
+int atTCPNetworkInterface::processEvents(int timeoutMillisecs)
+{
+   atTCPConnection *    connection;
+   Socket               newSocket;
+   struct sockaddr_in   connectingName;
+   socklen_t            connectingNameLength;
+   int                  clientID;
+   int                  count;
+   int                  i;
+
+   // Event mode has to be on
+   if (poll_set == NULL)
+   {
+      notify(AT_WARN, "Event mode is not enabled.\n");
+      return -1;
+   }
+
+   // Wait for something to happen on any of the sockets
+   count = pollSetWait(poll_set, poll_events, max_poll_events,
+                       timeoutMillisecs);
+
+   // Handle each socket that's ready
+   for (i = 0; i < count; i++)
+   {
+      // New clients show up as the listening socket being readable, so
+      // accept all of them that are waiting
+      if (poll_events[i].id == AT_TCP_LISTEN_ID)
+      {
+         do
+         {
+            connectingNameLength = sizeof(connectingName);
+            newSocket = accept(socket_value, 
+                               (struct sockaddr *) &connectingName,
+                               &connectingNameLength);
+            if (newSocket != -1)
+            {
+               clientID = addClient(newSocket, &connectingName);
+               if (clientID >= 0)
+                  appendClientID(&accepted_clients, clientID);
+            }
+         }
+         while (newSocket != -1);
+
+         continue;
+      }
+
+      // Ignore clients that have gone away already
+      clientID = poll_events[i].id;
+      connection = getClient(clientID);
+      if ((connection == NULL) || (!connection->connected))
+         continue;
+
+      // Finish any sends that were held up
+      if (poll_events[i].events & AT_POLL_WRITE)
+      {
+         if (drainBuffer(connection))
+            updateWriteInterest(clientID, connection);
+         else
+            poll_events[i].events |= AT_POLL_ERROR;
+      }
+
+      // Pull in whatever has arrived, and let the user know if there's
+      // now a complete message (or that the client went away)
+      if (poll_events[i].events & (AT_POLL_READ | AT_POLL_ERROR))
+      {
+         if (!fillBuffer(connection))
+         {
+            dropClient(clientID);
+            appendClientID(&closed_clients, clientID);
+         }
+
+         if ((!connection->ready_listed) && (hasMessage(connection)))
+         {
+            appendClientID(&ready_clients, clientID);
+            connection->ready_listed = true;
+         }
+      }
+   }
+
+   // Tell the user how many sockets we serviced (-1 means an error)
+   return count;
+}
+
+
+int atTCPNetworkInterface::getNextAcceptedClient()
+{
+   int   clientID;
+
+   // Return the next new client that's still around (-1 if none)
+   do
+      clientID = takeClientID(&accepted_clients);
+   while ((clientID >= 0) && (getClient(clientID) == NULL));
+
+   return clientID;
+}
+
+
+int atTCPNetworkInterface::getNextReadyClient()
+{
+   atTCPConnection *   connection;
+   int                 clientID;
+
+   // Return the next client with at least one complete message (-1 if
+   // none).  The caller should read messages from it until readMessage()
+   // returns 0
+   do
+   {
+      clientID = takeClientID(&ready_clients);
+      connection = getClient(clientID);
+   }
+   while ((clientID >= 0) && (connection == NULL));
+
+   if (connection != NULL)
+      connection->ready_listed = false;
+   return clientID;
+}
+
+
+int atTCPNetworkInterface::getNextClosedClient()
+{
+   int   clientID;
+
+   // Return the next client that disconnected (-1 if none).  Its last
+   // messages can still be read until closeClient() is called on it
+   do
+      clientID = takeClientID(&closed_clients);
+   while ((clientID >= 0) && (getClient(clientID) == NULL));
+
+   return clientID;
+}
+
+
+long atTCPNetworkInterface::flushClients()
+{
+   atTCPConnection *   connection;
+   u_long              pending;
+   long                totalSent;
+   int                 clientID;
+
+   // Send whatever has been queued for each client that has something
+   // (one send per client, no matter how many messages it has waiting)
+   totalSent = 0;
+   while ((clientID = takeClientID(&flush_clients)) >= 0)
+   {
+      connection = getClient(clientID);
+      if ((connection == NULL) || (!connection->connected))
+         continue;
+      connection->flush_listed = false;
+
+      // Anything that doesn't go out now is finished when the socket
+      // becomes writable again
+      pending = connection->send_end - connection->send_start;
+      if (drainBuffer(connection))
+      {
+         totalSent += pending - (connection->send_end - connection->send_start);
+         if (poll_set != NULL)
+            updateWriteInterest(clientID, connection);
+      }
+      else
+      {
+         dropClient(clientID);
+         appendClientID(&closed_clients, clientID);
+      }
+   }
+
+   // Tell the user how many bytes went out
+   return totalSent;
+}
@@ -29,12 +29,10 @@
 #define AT_TCP_NETWORK_INTERFACE_H
 
 
-// INCLUDES
 #include "atNetworkInterface.h++"
 #include "atOSDefs.h++"
 
 
-// TYPES
 typedef struct
 {
    char     address[256];
@@ -42,13 +40,82 @@ typedef struct
 } ClientAddr;
 
 
+// Per-connection state.  The receive and send buffers are only allocated
+// (and grown) when the connection is used through the framed message
+// calls or the event mode
+typedef struct
+{
+   Socket       socket;
+   ClientAddr   addr;
+   bool         blocking;
+   bool         connected;
+
+   u_char *     recv_buffer;
+   u_long       recv_start;
+   u_long       recv_end;
+   u_long       recv_capacity;
+
+   u_char *     send_buffer;
+   u_long       send_start;
+   u_long       send_end;
+   u_long       send_capacity;
+
+   bool         ready_listed;
+   bool         flush_listed;
+   bool         write_armed;
+} atTCPConnection;
+
+
+// A simple growable list of client IDs, used to hand events back to the
+// application in the order they happened
+typedef struct
+{
+   int *        ids;
+   u_long       count;
+   u_long       next;
+   u_long       capacity;
+} atTCPClientList;
+
+
 class ATLAS_SYM atTCPNetworkInterface : public atNetworkInterface
 {
    protected:
-      Socket       client_sockets[256];
-      ClientAddr   client_addrs[256];
-      bool         client_blocking[256];
-      u_long       num_client_sockets;
+      atTCPConnection **   client_connections;
+      u_long               client_capacity;
+      u_long               num_client_sockets;
+
+      atTCPConnection      server_connection;
+      bool                 server_listening;
+
+      atPollSet *          poll_set;
+      atPollEvent *        poll_events;
+      int                  max_poll_events;
+      atTCPClientList      accepted_clients;
+      atTCPClientList      ready_clients;
+      atTCPClientList      closed_clients;
+      atTCPClientList      flush_clients;
+
+      void         initInterface();
+
+      int          addClient(Socket newSocket,
+                             struct sockaddr_in * connectingName);
+      atTCPConnection *   getClient(int clientID);
+      void         dropClient(int clientID);
+
+      bool         fillBuffer(atTCPConnection * connection);
+      bool         hasMessage(atTCPConnection * connection);
+      int          extractMessage(atTCPConnection * connection,
+                                  u_char * buffer, u_long len);
+      bool         appendData(atTCPConnection * connection,
+                              u_char * buffer, u_long len);
+      bool         drainBuffer(atTCPConnection * connection);
+      int          readRaw(atTCPConnection * connection, u_char * buffer,
+                           u_long len);
+      int          writeRaw(atTCPConnection * connection, u_char * buffer,
+                            u_long len);
+
+      void         updateWriteInterest(int clientID,
+                                       atTCPConnection * connection);
 
    public:
       atTCPNetworkInterface(char * address, u_short port);
@@ -66,6 +133,9 @@ class ATLAS_SYM atTCPNetworkInterface : public atNetworkInterface
       void         disableDelayOnClient(int clientID);
 
       ClientAddr   getClientInfo(int clientID);
+      u_long       getNumClients();
+      bool         isClientConnected(int clientID);
+      void         closeClient(int clientID);
 
       int          makeConnection();
 
@@ -73,6 +143,30 @@ class ATLAS_SYM atTCPNetworkInterface : public atNetworkInterface
       int          read(int clientID, u_char * buffer, u_long len);
       int          write(u_char * buffer, u_long len);
       int          write(int clientID, u_char * buffer, u_long len);
+
+      // Length-prefixed messages.  Each message is sent as a 4-byte
+      // length in network order followed by the payload, so the receiver
+      // always gets whole messages no matter how TCP splits the stream
+      int          readMessage(u_char * buffer, u_long len);
+      int          readMessage(int clientID, u_char * buffer, u_long len);
+      int          writeMessage(u_char * buffer, u_long len);
+      int          writeMessage(int clientID, u_char * buffer, u_long len);
+
+      // Event-driven server mode.  All clients are watched together
+      // (with epoll where available) and serviced by processEvents(),
+      // which accepts new clients, pulls in whatever data has arrived and
+      // finishes any sends that didn't complete.  Messages written to
+      // clients are queued until flushClients() is called, so a whole
+      // tick's worth of output goes out in one send per client
+      bool         enableEventMode();
+      void         disableEventMode();
+      bool         isEventModeEnabled();
+
+      int          processEvents(int timeoutMillisecs);
+      int          getNextAcceptedClient();
+      int          getNextReadyClient();
+      int          getNextClosedClient();
+      long         flushClients();
 };
 
 
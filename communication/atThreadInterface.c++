@@ -35,6 +35,8 @@
 #define AT_THR_INIT_QUEUE_SIZE   5000 
 #define AT_THR_INC_QUEUE_SIZE   10000
 
+#define AT_THR_RING_QUEUE_SIZE   65536
+
 #define AT_THR_SEM_KEY   3099
 
 
@@ -44,11 +46,35 @@ static atMap   atlas_thread_interface_key_map;
 
 
 atThreadInterface::atThreadInterface(SemKey readKey, SemKey writeKey)
+{
+   // Use the original, semaphore-locked queues
+   initInterface(readKey, writeKey, AT_QUEUE_LOCKED);
+}
+
+
+atThreadInterface::atThreadInterface(SemKey readKey, SemKey writeKey,
+                                     atQueueMode mode)
+{
+   // Use the given kind of queue (if another interface already created
+   // the queue for a key, we share that queue as-is)
+   initInterface(readKey, writeKey, mode);
+}
+
+
+void atThreadInterface::initInterface(SemKey readKey, SemKey writeKey,
+                                      atQueueMode mode)
 {
    char         tmp[256];
    atString *   readKeyStr;
    atString *   writeKeyStr;
    atPair *     pair;
+   u_long       initialSize;
+
+   // A ring can't grow, so give it more room up front
+   if (mode == AT_QUEUE_LOCKED)
+      initialSize = AT_THR_INIT_QUEUE_SIZE;
+   else
+      initialSize = AT_THR_RING_QUEUE_SIZE;
 
    // Get the semaphore that controls access to the key map (maps keys
    // to instances of atThreadQueue)
@@ -69,9 +95,8 @@ atThreadInterface::atThreadInterface(SemKey readKey, SemKey writeKey)
    if (pair == NULL)
    {
       // Create a read queue for communication messages
-      read_queue = new atThreadQueue(readKey,
-                                     AT_THR_INIT_QUEUE_SIZE, 
-                                     AT_THR_INC_QUEUE_SIZE);
+      read_queue = new atThreadQueue(readKey, initialSize,
+                                     AT_THR_INC_QUEUE_SIZE, mode);
       read_count = new atThreadCount();
       read_count->inc();
 
@@ -100,9 +125,8 @@ atThreadInterface::atThreadInterface(SemKey readKey, SemKey writeKey)
    if (pair == NULL)
    {
       // Create a write queue for communication messages
-      write_queue = new atThreadQueue(writeKey,
-                                      AT_THR_INIT_QUEUE_SIZE, 
-                                      AT_THR_INC_QUEUE_SIZE);
+      write_queue = new atThreadQueue(writeKey, initialSize,
+                                      AT_THR_INC_QUEUE_SIZE, mode);
       write_count = new atThreadCount();
       write_count->inc();
 
@@ -169,6 +193,22 @@ atThreadInterface::~atThreadInterface()
 }
 
 
+atThreadQueue * atThreadInterface::getReadQueue()
+{
+   // Return the queue we read from (so ring queue users can peek at
+   // entries in place or wait for them)
+   return read_queue;
+}
+
+
+atThreadQueue * atThreadInterface::getWriteQueue()
+{
+   // Return the queue we write to (so ring queue users can reserve space
+   // and write into it directly)
+   return write_queue;
+}
+
+
 int atThreadInterface::read(u_char * buffer, u_long length)
 {
    // Try to read the next queue entry
@@ -187,11 +227,11 @@ int atThreadInterface::read(u_char * buffer, u_long length)
 
 int atThreadInterface::write(u_char * buffer, u_long length)
 {
-   // Write the buffer to the queue
-   write_queue->enqueue(buffer, length);
-
-   // At least for now, we assume enqueuing to the shared buffer will work
-   // everytime
-   return length;
+   // Write the buffer to the queue (this only fails if the queue is a
+   // ring and it's full)
+   if (write_queue->enqueue(buffer, length) == true)
+      return length;
+   else
+      return 0;
 }
 
@@ -49,10 +49,17 @@ class ATLAS_SYM atThreadInterface : public atIPCInterface
       atThreadCount *   read_count;
       atThreadCount *   write_count;
 
+      void   initInterface(SemKey readKey, SemKey writeKey, 
+                           atQueueMode mode);
+
    public:
       atThreadInterface(SemKey readKey, SemKey writeKey);
+      atThreadInterface(SemKey readKey, SemKey writeKey, atQueueMode mode);
       virtual ~atThreadInterface();
 
+      atThreadQueue *   getReadQueue();
+      atThreadQueue *   getWriteQueue();
+
       int   read(u_char * buffer, u_long length);
       int   write(u_char * buffer, u_long length);
 };
@@ -29,17 +29,62 @@
 #include <string.h>
 #include <sys/types.h>
 #include "atThreadQueue.h++"
+#include "atMetrics.h++"
 
 
 atThreadQueue::atThreadQueue(SemKey key, u_long initialSize, 
                              u_long incrementSize)
 {
+   // Use the original, semaphore-locked queue
+   initQueue(key, initialSize, incrementSize, AT_QUEUE_LOCKED);
+}
+
+
+atThreadQueue::atThreadQueue(SemKey key, u_long initialSize, 
+                             u_long incrementSize, atQueueMode mode)
+{
+   // Use whichever kind of queue was asked for
+   initQueue(key, initialSize, incrementSize, mode);
+}
+
+
+void atThreadQueue::initQueue(SemKey key, u_long initialSize, 
+                              u_long incrementSize, atQueueMode mode)
+{
+   u_long   ringMemorySize;
+
    // Keep the keys to use later
    sem_key = key;
 
    // Keep the increment size for later use
    memory_increment_size = incrementSize;
 
+   // Remember which mode we're in
+   queue_mode = mode;
+   ring_buffer = NULL;
+
+   // A ring buffer doesn't need the semaphore (or to grow), so set it up
+   // with a fixed size and we're done
+   if (queue_mode != AT_QUEUE_LOCKED)
+   {
+      sem_id = INVALID_SEM_ID;
+      queue_head = 0;
+      queue_tail = 0;
+      queue_used = 0;
+
+      // Get memory for the ring (including its control block)
+      ringMemorySize = atRingBuffer::getMemorySize(initialSize);
+      queue_buffer = (u_char *) calloc(ringMemorySize, sizeof(u_char));
+      if (queue_buffer == NULL)
+         notify(AT_FATAL_ERROR, "Failed to get memory for queue.\n");
+      queue_size = ringMemorySize;
+
+      // Set up the ring in that memory
+      ring_buffer = new atRingBuffer(queue_buffer, ringMemorySize, true,
+                                     (queue_mode == AT_QUEUE_RING_MPSC));
+      return;
+   }
+
    // Get a semaphore to control access to this buffer
    semGet(sem_key, &sem_id);
    if (sem_id == INVALID_SEM_ID)
@@ -66,6 +111,14 @@ atThreadQueue::atThreadQueue(SemKey key, u_long initialSize,
 
 atThreadQueue::~atThreadQueue()
 {
+   // A ring buffer has no semaphore, so just free it
+   if (queue_mode != AT_QUEUE_LOCKED)
+   {
+      delete ring_buffer;
+      free(queue_buffer);
+      return;
+   }
+
    // Free the queue
    lock();
    if (queue_buffer != NULL)
@@ -77,10 +130,19 @@ atThreadQueue::~atThreadQueue()
 }
 
 
+atQueueMode atThreadQueue::getMode()
+{
+   return queue_mode;
+}
+
+
 bool atThreadQueue::lock()
 {
    int   result;
 
+   // Time how long we wait for the lock
+   AT_METRICS_TIMER(lockTimer, AT_METRIC_THREAD_QUEUE_LOCK_WAIT);
+
    // Try to do the lock and return either success or failure (if we failed
    // because of a reason besides that we were interrupted (by a signal), then
    // notify that fact to the user as well)
@@ -211,16 +273,35 @@ void atThreadQueue::reallocateQueue(u_long minimumToAdd)
       queue_size = queue_size + increment;
       queue_head = headOffset;
       queue_tail = tailOffset;
+
+      // Count the reallocation
+      AT_METRICS_COUNT(AT_METRIC_THREAD_QUEUE_REALLOCATIONS, 1);
    }
 }
 
 
-void atThreadQueue::enqueue(u_char * buffer, u_long bufferLen)
+bool atThreadQueue::enqueue(u_char * buffer, u_long bufferLen)
 {
    u_long     bufferWithHeaderLen;
    u_char *   bufferWithHeader;
    u_long     partialSize;
 
+   // A ring buffer doesn't grow, so this fails if the ring is full
+   if (queue_mode != AT_QUEUE_LOCKED)
+   {
+      if (!ring_buffer->enqueue(buffer, bufferLen))
+      {
+         AT_METRICS_COUNT(AT_METRIC_THREAD_QUEUE_FULL, 1);
+         return false;
+      }
+
+      // Count the entry and see how full the ring is now
+      AT_METRICS_COUNT(AT_METRIC_THREAD_QUEUE_MESSAGES_ENQUEUED, 1);
+      AT_METRICS_COUNT(AT_METRIC_THREAD_QUEUE_BYTES_ENQUEUED, bufferLen);
+      AT_METRICS_RECORD(AT_METRIC_THREAD_QUEUE_DEPTH, ring_buffer->getUsedSize());
+      return true;
+   }
+
    // Allocate space for a header and the buffer
    bufferWithHeaderLen = bufferLen + sizeof(u_long);
    bufferWithHeader = (u_char *) malloc(bufferWithHeaderLen);
@@ -292,11 +373,21 @@ void atThreadQueue::enqueue(u_char * buffer, u_long bufferLen)
       queue_tail %= queue_size;
    }
 
+   // See how full the queue is now (while we still hold the lock)
+   AT_METRICS_RECORD(AT_METRIC_THREAD_QUEUE_DEPTH, queue_used);
+
    // Unlock access to the memory
    unlock();
 
    // Get rid of temporary buffer
    free(bufferWithHeader);
+
+   // Count the entry
+   AT_METRICS_COUNT(AT_METRIC_THREAD_QUEUE_MESSAGES_ENQUEUED, 1);
+   AT_METRICS_COUNT(AT_METRIC_THREAD_QUEUE_BYTES_ENQUEUED, bufferLen);
+
+   // The locked queue grows as needed, so this always works
+   return true;
 }
 
 
@@ -308,6 +399,18 @@ bool atThreadQueue::dequeue(u_char * buffer, u_long * bufferLen)
    u_long     partialSize;
    int        returnCode;
 
+   // A ring buffer handles this itself
+   if (queue_mode != AT_QUEUE_LOCKED)
+   {
+      if (!ring_buffer->dequeue(buffer, bufferLen))
+         return false;
+
+      // Count the entry
+      AT_METRICS_COUNT(AT_METRIC_THREAD_QUEUE_MESSAGES_DEQUEUED, 1);
+      AT_METRICS_COUNT(AT_METRIC_THREAD_QUEUE_BYTES_DEQUEUED, *bufferLen);
+      return true;
+   }
+
    // Initialize
    bufferWithHeader = NULL;
 
@@ -402,6 +505,10 @@ bool atThreadQueue::dequeue(u_char * buffer, u_long * bufferLen)
       *bufferLen = bufferWithHeaderLen - sizeof(bufferWithHeaderLen);
       memcpy(buffer, &bufferWithHeader[sizeof(bufferWithHeaderLen)],
              *bufferLen);
+
+      // Count the entry
+      AT_METRICS_COUNT(AT_METRIC_THREAD_QUEUE_MESSAGES_DEQUEUED, 1);
+      AT_METRICS_COUNT(AT_METRIC_THREAD_QUEUE_BYTES_DEQUEUED, *bufferLen);
    }
    else
       *bufferLen = 0;
@@ -414,3 +521,61 @@ bool atThreadQueue::dequeue(u_char * buffer, u_long * bufferLen)
    return returnCode;
 }
 
+
+u_char * atThreadQueue::reserve(u_long entryLen)
+{
+   // Only a ring buffer can hand out space to write into directly
+   if (queue_mode == AT_QUEUE_LOCKED)
+   {
+      notify(AT_WARN, "Reserving queue space requires a ring queue.\n");
+      return NULL;
+   }
+
+   // Returns NULL if the ring is full
+   return ring_buffer->reserve(entryLen);
+}
+
+
+void atThreadQueue::commit(u_char * entry)
+{
+   // Hand a reserved entry over to the reader
+   if (queue_mode != AT_QUEUE_LOCKED)
+      ring_buffer->commit(entry);
+}
+
+
+u_char * atThreadQueue::peek(u_long * entryLen)
+{
+   // Only a ring buffer can let the reader look at entries in place
+   if (queue_mode == AT_QUEUE_LOCKED)
+   {
+      notify(AT_WARN, "Peeking at queue entries requires a ring queue.\n");
+      return NULL;
+   }
+
+   // Returns NULL if there's nothing to read
+   return ring_buffer->peek(entryLen);
+}
+
+
+void atThreadQueue::release()
+{
+   // Done with the entry that peek() returned
+   if (queue_mode != AT_QUEUE_LOCKED)
+      ring_buffer->release();
+}
+
+
+bool atThreadQueue::waitForEntry(u_long timeoutMicrosecs)
+{
+   // Only a ring buffer can wake us up when something arrives
+   if (queue_mode == AT_QUEUE_LOCKED)
+   {
+      notify(AT_WARN, "Waiting for queue entries requires a ring queue.\n");
+      return false;
+   }
+
+   // Sleeps until there's an entry (or the timeout runs out)
+   return ring_buffer->waitForEntry(timeoutMicrosecs);
+}
+
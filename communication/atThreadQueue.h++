@@ -33,6 +33,7 @@
 #include <sys/types.h>
 #include "atItem.h++"
 #include "atOSDefs.h++"
+#include "atRingBuffer.h++"
 
 
 class ATLAS_SYM atThreadQueue : public atItem
@@ -50,6 +51,11 @@ class ATLAS_SYM atThreadQueue : public atItem
       u_long     queue_size;
       u_long     queue_used;
 
+      atQueueMode      queue_mode;
+      atRingBuffer *   ring_buffer;
+
+      void     initQueue(SemKey key, u_long initialSize, u_long incrementSize,
+                         atQueueMode mode);
       bool     lock();
       bool     unlock();
       u_long   spaceAvailable();
@@ -58,10 +64,20 @@ class ATLAS_SYM atThreadQueue : public atItem
 
    public:
       atThreadQueue(SemKey key, u_long initialSize, u_long incrementSize);
+      atThreadQueue(SemKey key, u_long initialSize, u_long incrementSize,
+                    atQueueMode mode);
       virtual ~atThreadQueue();
 
-      virtual void   enqueue(u_char * buffer, u_long bufferLen);
-      virtual bool   dequeue(u_char * buffer, u_long * bufferLen);
+      atQueueMode        getMode();
+
+      virtual bool       enqueue(u_char * buffer, u_long bufferLen);
+      virtual bool       dequeue(u_char * buffer, u_long * bufferLen);
+
+      virtual u_char *   reserve(u_long entryLen);
+      virtual void       commit(u_char * entry);
+      virtual u_char *   peek(u_long * entryLen);
+      virtual void       release();
+      virtual bool       waitForEntry(u_long timeoutMicrosecs);
 };
 
 
@@ -27,6 +27,7 @@
 
 // INCLUDES
 #include "atUDPNetworkInterface.h++"
+#include "atMetrics.h++"
 #include "atOSDefs.h++"
 #include "atNetwork.h++"
 
@@ -88,6 +89,7 @@ atUDPNetworkInterface::atUDPNetworkInterface(char * address, u_short port)
 
    // Do not ignore our own broadcasted packets by default
    ignore_our_own = false;
+   own_address_known = false;
 }
 
 
@@ -121,6 +123,7 @@ atUDPNetworkInterface::atUDPNetworkInterface(u_short port)
 
    // Ignore our own broadcasted packets by default
    ignore_our_own = true;
+   own_address_known = false;
 }
 
 
@@ -205,6 +208,13 @@ int atUDPNetworkInterface::read(u_char * buffer, u_long len,
       *senderPort = ntohs(fromAddress.sin_port);
    }
 
+   // Count the packet
+   if (packetLength > 0)
+   {
+      AT_METRICS_COUNT(AT_METRIC_UDP_MESSAGES_READ, 1);
+      AT_METRICS_COUNT(AT_METRIC_UDP_BYTES_READ, packetLength);
+   }
+
    // Tell user how many bytes we read (-1 if error)
    return packetLength;
 }
@@ -218,6 +228,13 @@ int atUDPNetworkInterface::write(u_char * buffer, u_long len)
    lengthWritten = sendto(socket_value, (char * ) buffer, len, 0, 
                           (struct sockaddr *) &write_name, write_name_length);
 
+   // Count the packet
+   if (lengthWritten > 0)
+   {
+      AT_METRICS_COUNT(AT_METRIC_UDP_MESSAGES_WRITTEN, 1);
+      AT_METRICS_COUNT(AT_METRIC_UDP_BYTES_WRITTEN, lengthWritten);
+   }
+
    // Tell user how many bytes we wrote (-1 if error)
    return lengthWritten;
 }
@@ -238,7 +255,121 @@ int atUDPNetworkInterface::write(u_char * buffer, u_long len,
    lengthWritten = sendto(socket_value, (char * ) buffer, len, 0, 
                           (struct sockaddr *) &sendTo, sizeof(sendTo));
 
+   // Count the packet
+   if (lengthWritten > 0)
+   {
+      AT_METRICS_COUNT(AT_METRIC_UDP_MESSAGES_WRITTEN, 1);
+      AT_METRICS_COUNT(AT_METRIC_UDP_BYTES_WRITTEN, lengthWritten);
+   }
+
    // Tell user how many bytes we wrote (-1 if error)
    return lengthWritten;
 }
 
+
+bool atUDPNetworkInterface::isOwnPacket(struct sockaddr_in * fromAddress)
+{
+   char               hostname[MAXHOSTNAMELEN];
+   struct hostent *   host;
+
+   // Look up our own address the first time we need it
+   if (own_address_known == false)
+   {
+      gethostname(hostname, sizeof(hostname));
+      host = gethostbyname(hostname);
+      if (host == NULL)
+         return false;
+      memcpy(&own_address, host->h_addr_list[0], sizeof(own_address));
+      own_address_known = true;
+   }
+
+   // See if the packet came from us
+   return (memcmp(&fromAddress->sin_addr, &own_address, 
+                  sizeof(own_address)) == 0);
+}
+
+
+int atUDPNetworkInterface::readMany(atPacketPool * pool)
+{
+   SocketPacket *   slots;
+   SocketPacket     swap;
+   int              received;
+   int              kept;
+   int              i;
+
+   // Keep looping if necessary
+   slots = pool->getSlots();
+   do
+   {
+      // Get as many packets as are waiting
+      received = receivePackets(socket_value, slots, pool->getNumSlots());
+      if (received <= 0)
+      {
+         pool->setNumPackets(0);
+         return received;
+      }
+
+      // In broadcast mode we're going to receive our own packets back
+      // so drop them if requested (the slots are swapped rather than
+      // copied, so the packet data doesn't move)
+      kept = received;
+      if (ignore_our_own == true)
+      {
+         kept = 0;
+         for (i = 0; i < received; i++)
+         {
+            if (!isOwnPacket(&slots[i].address))
+            {
+               if (kept != i)
+               {
+                  swap = slots[kept];
+                  slots[kept] = slots[i];
+                  slots[i] = swap;
+               }
+               kept++;
+            }
+         }
+      }
+   }
+   while ((kept == 0) && (blocking_mode == true));
+
+   // Count the packets
+   #ifdef __AT_METRICS_ENABLED__
+      AT_METRICS_COUNT(AT_METRIC_UDP_MESSAGES_READ, kept);
+      for (i = 0; i < kept; i++)
+         AT_METRICS_COUNT(AT_METRIC_UDP_BYTES_READ, slots[i].length);
+   #endif
+
+   // Tell user how many packets we read
+   pool->setNumPackets(kept);
+   return kept;
+}
+
+
+int atUDPNetworkInterface::writeMany(atPacketPool * pool)
+{
+   int   sent;
+
+   // Send all the packets in the pool (-1 if error).  Packets without a
+   // destination of their own go to our write address
+   sent = sendPackets(socket_value, pool->getSlots(), pool->getNumPackets(),
+                      &write_name);
+
+   // Count the packets that went out
+   #ifdef __AT_METRICS_ENABLED__
+      int   i;
+
+      if (sent > 0)
+      {
+         AT_METRICS_COUNT(AT_METRIC_UDP_MESSAGES_WRITTEN, sent);
+         for (i = 0; i < sent; i++)
+         {
+            AT_METRICS_COUNT(AT_METRIC_UDP_BYTES_WRITTEN,
+                             pool->getPacketLength(i));
+         }
+      }
+   #endif
+
+   // Tell user how many packets we sent
+   return sent;
+}
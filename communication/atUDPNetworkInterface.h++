@@ -32,13 +32,19 @@
 // INCLUDES
 #include "atString.h++"
 #include "atNetworkInterface.h++"
+#include "atPacketPool.h++"
 #include "atOSDefs.h++"
 
 
 class ATLAS_SYM atUDPNetworkInterface : public atNetworkInterface
 {
    protected:
-      bool   ignore_our_own;
+      bool             ignore_our_own;
+
+      bool             own_address_known;
+      struct in_addr   own_address;
+
+      bool             isOwnPacket(struct sockaddr_in * fromAddress);
 
    public:
       atUDPNetworkInterface(char * address, u_short port);
@@ -51,6 +57,13 @@ class ATLAS_SYM atUDPNetworkInterface : public atNetworkInterface
       int   write(u_char * buffer, u_long len);
       int   write(u_char * buffer, u_long len,
                   atString senderAddr, u_short senderPort);
+
+      // Batched versions of read() and write().  readMany() fills as
+      // many of the pool's slots as there are packets waiting (waiting
+      // for the first one if blocking) and writeMany() sends all the
+      // packets in the pool, each in as few system calls as possible
+      int   readMany(atPacketPool * pool);
+      int   writeMany(atPacketPool * pool);
 };
 
 #endif
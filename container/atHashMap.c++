@@ -0,0 +1,432 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "atGlobals.h++"
+
+#include "atHashMap.h++"
+
+// Table size used when the first entry is added
+#define AT_HASH_MAP_MIN_SIZE   16
+
+// The table grows once it's this full (as a fraction of 256)
+#define AT_HASH_MAP_MAX_LOAD   192
+
+// ------------------------------------------------------------------------
+// Constructor - Sets the map to empty (no table is allocated until the
+// first entry is added)
+// ------------------------------------------------------------------------
+atHashMap::atHashMap()
+{
+    slotTable = NULL;
+    tableSize = 0;
+    numEntries = 0;
+}
+
+// ------------------------------------------------------------------------
+// Constructor - Sets the map to empty, with room for the given number of
+// entries before the table needs to grow
+// ------------------------------------------------------------------------
+atHashMap::atHashMap(u_long expectedEntries)
+{
+    slotTable = NULL;
+    tableSize = 0;
+    numEntries = 0;
+    reserve(expectedEntries);
+}
+
+// ------------------------------------------------------------------------
+// Destructor - Deletes the contents of the map
+// ------------------------------------------------------------------------
+atHashMap::~atHashMap()
+{
+    // Delete all map entries and the table itself
+    clear();
+    free(slotTable);
+}
+
+// ------------------------------------------------------------------------
+// Adds a new mapping from key to value to the map. Returns true if
+// successful, or false if a mapping for that key already exists.
+// ------------------------------------------------------------------------
+bool atHashMap::addEntry(atItem * key, atItem * value)
+{
+    u_long hash;
+    u_long index;
+
+    // We can't store a NULL key (it marks an empty slot)
+    if (key == NULL)
+        return false;
+
+    // Make sure that the key isn't already in the map
+    hash = hashKey(key);
+    if (findSlot(key, hash) >= 0)
+        return false;
+
+    // Grow the table if adding this entry would make it too full
+    if ((numEntries + 1) * 256 > tableSize * AT_HASH_MAP_MAX_LOAD)
+    {
+        if (!resizeTable(tableSize == 0 ? AT_HASH_MAP_MIN_SIZE :
+                                          tableSize * 2))
+            return false;
+    }
+
+    // Probe from the key's home slot to the first empty one
+    index = hash & (tableSize - 1);
+    while (slotTable[index].slotKey != NULL)
+        index = (index + 1) & (tableSize - 1);
+
+    // Store the entry
+    slotTable[index].slotKey = key;
+    slotTable[index].slotValue = value;
+    slotTable[index].slotHash = hash;
+
+    // Increase entry count by one and return success
+    numEntries++;
+    return true;
+}
+
+// ------------------------------------------------------------------------
+// Removes the mapping associated with the given key from the map, deleting
+// both the key and value. Returns true if successful, or false if the key
+// is not in the map.
+// ------------------------------------------------------------------------
+bool atHashMap::deleteEntry(atItem * key)
+{
+    long index;
+
+    // A NULL key can't be in the map
+    if (key == NULL)
+        return false;
+
+    // Find the key's slot. Abort if it's not there.
+    index = findSlot(key, hashKey(key));
+    if (index < 0)
+        return false;
+
+    // Delete the key and value, then empty the slot
+    if (slotTable[index].slotKey != NULL)
+        delete slotTable[index].slotKey;
+    if (slotTable[index].slotValue != NULL)
+        delete slotTable[index].slotValue;
+    removeSlot(index);
+
+    // Decrease entry count by one and return success
+    numEntries--;
+    return true;
+}
+
+// ------------------------------------------------------------------------
+// Removes the entry specified by the key from the map, returning the
+// value.  Yields ownership of both the key and value (neither are 
+// deleted).  Returns NULL if there is no entry with the given key.
+// ------------------------------------------------------------------------
+atItem * atHashMap::removeEntry(atItem * key)
+{
+    long index;
+    atItem * targetKey;
+    atItem * targetValue;
+
+    // A NULL key can't be in the map
+    if (key == NULL)
+        return NULL;
+
+    // Find the key's slot. Abort if it's not there.
+    index = findSlot(key, hashKey(key));
+    if (index < 0)
+        return NULL;
+
+    // Get the entry's key and value before we empty the slot
+    targetKey = slotTable[index].slotKey;
+    targetValue = slotTable[index].slotValue;
+    removeSlot(index);
+
+    // If the given key and the key previously stored in the map are
+    // different objects (i.e.: two different instances), we need to
+    // delete the stored key to avoid a memory leak (same as atMap)
+    if ((void *)key != (void *)targetKey)
+       delete targetKey;
+
+    // Decrease entry count by one and return the value
+    numEntries--;
+    return targetValue;
+}
+
+// ------------------------------------------------------------------------
+// Returns the number of mappings contained in this map
+// ------------------------------------------------------------------------
+u_long atHashMap::getNumEntries()
+{
+    return numEntries;
+}
+
+// ------------------------------------------------------------------------
+// Checks if a mapping for the given key is present in the map. Returns
+// true if so, false if not.
+// ------------------------------------------------------------------------
+bool atHashMap::containsKey(atItem * key)
+{
+    // A NULL key can't be in the map
+    if (key == NULL)
+        return false;
+
+    // See if the key has a slot
+    return (findSlot(key, hashKey(key)) >= 0);
+}
+
+// ------------------------------------------------------------------------
+// Returns the value associated with the given key, or NULL if that key is
+// not present within the map.
+// ------------------------------------------------------------------------
+atItem * atHashMap::getValue(atItem * key)
+{
+    long index;
+
+    // A NULL key can't be in the map
+    if (key == NULL)
+        return NULL;
+
+    // Find the key's slot
+    index = findSlot(key, hashKey(key));
+    if (index >= 0)
+        return slotTable[index].slotValue;
+
+    // Return NULL if the target key wasn't found
+    return NULL;
+}
+
+// ------------------------------------------------------------------------
+// Attempts to change the value associated with the given key to newValue.
+// Return the old value if successful, NULL if the given key is not present
+// within the map.
+// ------------------------------------------------------------------------
+atItem * atHashMap::changeValue(atItem * key, atItem * newValue)
+{
+    long index;
+    atItem *oldValue;
+
+    // A NULL key can't be in the map
+    if (key == NULL)
+        return NULL;
+
+    // Find the key's slot
+    index = findSlot(key, hashKey(key));
+    if (index < 0)
+        return NULL;
+
+    // Set the new value and return the old value
+    oldValue = slotTable[index].slotValue;
+    slotTable[index].slotValue = newValue;
+    return oldValue;
+}
+
+// ------------------------------------------------------------------------
+// Removes all mappings from the map, deleting the keys and values. The
+// table keeps its size, so refilling the map doesn't need to grow it
+// again.
+// ------------------------------------------------------------------------
+void atHashMap::clear()
+{
+    u_long i;
+
+    // No work to do if the map is already empty
+    if (numEntries == 0)
+        return;
+
+    // Delete every entry and empty its slot
+    for (i = 0; i < tableSize; i++)
+    {
+        if (slotTable[i].slotKey != NULL)
+        {
+            delete slotTable[i].slotKey;
+            if (slotTable[i].slotValue != NULL)
+                delete slotTable[i].slotValue;
+            slotTable[i].slotKey = NULL;
+            slotTable[i].slotValue = NULL;
+        }
+    }
+
+    // Set the map to empty
+    numEntries = 0;
+}
+
+// ------------------------------------------------------------------------
+// Makes sure the table can hold the given number of entries without
+// having to grow
+// ------------------------------------------------------------------------
+void atHashMap::reserve(u_long expectedEntries)
+{
+    u_long newSize;
+
+    // Find the smallest power of two that keeps the table under its
+    // maximum load
+    newSize = AT_HASH_MAP_MIN_SIZE;
+    while (expectedEntries * 256 > newSize * AT_HASH_MAP_MAX_LOAD)
+        newSize *= 2;
+
+    // Only ever grow the table
+    if (newSize > tableSize)
+        resizeTable(newSize);
+}
+
+// ------------------------------------------------------------------------
+// Private function
+// Returns the hash code for the given key, scrambled so that all of its
+// bits affect the low bits that pick the slot (keys like integers and
+// pointers tend to have very regular hash codes)
+// ------------------------------------------------------------------------
+u_long atHashMap::hashKey(atItem * key)
+{
+    u_long hash;
+
+    // Fold the upper half in (done in two steps because a single shift
+    // would be too big when u_long is 32 bits), then mix the bits
+    hash = key->getHashCode();
+    hash ^= (hash >> 16) >> 16;
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bUL;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35UL;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+// ------------------------------------------------------------------------
+// Private function
+// Searches the table for the slot holding the given key. Returns its
+// index, or -1 if it can't find it.
+// ------------------------------------------------------------------------
+long atHashMap::findSlot(atItem * key, u_long hash)
+{
+    u_long index;
+
+    // No table, no entries
+    if (tableSize == 0)
+        return -1;
+
+    // Probe from the key's home slot until we find the key or hit an
+    // empty slot (the stored hash saves calling equals() on most of the
+    // entries we pass)
+    index = hash & (tableSize - 1);
+    while (slotTable[index].slotKey != NULL)
+    {
+        if ((slotTable[index].slotHash == hash) &&
+            (slotTable[index].slotKey->equals(key)))
+            return index;
+
+        index = (index + 1) & (tableSize - 1);
+    }
+
+    // Return -1 if the target key wasn't found
+    return -1;
+}
+
+// ------------------------------------------------------------------------
+// Private function
+// Empties the given slot. Rather than leaving a marker behind, any
+// entries after it in the same probe run that could live in the emptied
+// slot are moved back, so lookups never have to skip over removed
+// entries.
+// ------------------------------------------------------------------------
+void atHashMap::removeSlot(u_long index)
+{
+    u_long mask;
+    u_long next;
+    u_long home;
+    bool   canMove;
+
+    // Walk along the run of slots following the removed one
+    mask = tableSize - 1;
+    next = index;
+    while (true)
+    {
+        next = (next + 1) & mask;
+        if (slotTable[next].slotKey == NULL)
+            break;
+
+        // An entry can move back into the hole as long as its home slot
+        // isn't between the hole and where it is now (it would then be
+        // ahead of its home slot, and lookups would miss it)
+        home = slotTable[next].slotHash & mask;
+        if (index <= next)
+            canMove = ((home <= index) || (home > next));
+        else
+            canMove = ((home <= index) && (home > next));
+
+        // Move the entry back, leaving a hole where it was
+        if (canMove)
+        {
+            slotTable[index] = slotTable[next];
+            index = next;
+        }
+    }
+
+    // Empty the final hole
+    slotTable[index].slotKey = NULL;
+    slotTable[index].slotValue = NULL;
+}
+
+// ------------------------------------------------------------------------
+// Private function
+// Moves all the entries into a new table of the given size (which must be
+// a power of two). Returns false if the table couldn't be allocated.
+// ------------------------------------------------------------------------
+bool atHashMap::resizeTable(u_long newSize)
+{
+    atHashMapSlot * newTable;
+    u_long i;
+    u_long index;
+
+    // Allocate the new table with all slots empty
+    newTable = (atHashMapSlot *) calloc(newSize, sizeof(atHashMapSlot));
+    if (newTable == NULL)
+    {
+        notify(AT_ERROR, "atHashMap::resizeTable: Unable to allocate "
+            "table of %lu slots\n", newSize);
+        return false;
+    }
+
+    // Reinsert every entry (the hashes are stored, so keys don't need
+    // to be hashed again)
+    for (i = 0; i < tableSize; i++)
+    {
+        if (slotTable[i].slotKey != NULL)
+        {
+            index = slotTable[i].slotHash & (newSize - 1);
+            while (newTable[index].slotKey != NULL)
+                index = (index + 1) & (newSize - 1);
+            newTable[index] = slotTable[i];
+        }
+    }
+
+    // Switch to the new table
+    free(slotTable);
+    slotTable = newTable;
+    tableSize = newSize;
+    return true;
+}
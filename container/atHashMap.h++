@@ -0,0 +1,98 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AT_HASH_MAP_HPP
+#define AT_HASH_MAP_HPP
+
+#include "atGlobals.h++"
+#include "atItem.h++"
+#include "atNotifier.h++"
+#include "atOSDefs.h++"
+
+// A slot in the hash map's table.  Empty slots have a NULL key.
+struct atHashMapSlot
+{
+    atItem *   slotKey;
+    atItem *   slotValue;
+    u_long     slotHash;
+};
+
+// Unordered map from keys to values.  It has the same interface and
+// ownership rules as atMap, but keeps its entries in one contiguous
+// table (open addressing with linear probing) and finds them by the
+// keys' getHashCode() rather than by comparing keys down a tree.  Keys
+// must implement getHashCode() consistently with equals().
+//
+// Some of the library's own items need care as keys:
+// - atFloat, atDouble, atVector, atMatrix and atQuat compare their values
+//   within AT_DEFAULT_TOLERANCE.  Their hash codes agree with that, but
+//   only by giving every value smaller in magnitude than 2^-15 (for
+//   floats) or 2^14 (for doubles) the same hash code, so maps keyed on
+//   small values degrade to a linear search.  Use atMap for those.
+// - atPair and atTriple hash their items, so they're only valid keys if
+//   their items are.
+// - atJoint doesn't override equals(atItem *), so joints are keys by
+//   identity (as are any other items that don't).
+// - atStringBuffer is NOT a valid key.  Its equals() is only true for an
+//   atString with the same text (never for another atStringBuffer, or
+//   itself), so duplicate keys aren't caught and only an atString finds
+//   the entry again.
+class ATLAS_SYM atHashMap : public atNotifier
+{
+    friend class atHashMapIterator;
+
+private:
+
+    atHashMapSlot *   slotTable;
+    u_long            tableSize;
+    u_long            numEntries;
+
+    u_long            hashKey(atItem * key);
+    long              findSlot(atItem * key, u_long hash);
+    void              removeSlot(u_long index);
+    bool              resizeTable(u_long newSize);
+
+public:
+
+                atHashMap();
+                atHashMap(u_long expectedEntries);
+    virtual     ~atHashMap();
+
+    bool        addEntry(atItem * key, atItem * value);
+    bool        deleteEntry(atItem * key);
+    atItem *    removeEntry(atItem * key);
+    u_long      getNumEntries();
+    
+    bool        containsKey(atItem * key);
+    atItem *    getValue(atItem * key);
+    atItem *    changeValue(atItem * key, atItem * newValue);
+
+    void        clear();
+    void        reserve(u_long expectedEntries);
+};
+
+#endif
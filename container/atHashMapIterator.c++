@@ -0,0 +1,95 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "atHashMapIterator.h++"
+
+// ------------------------------------------------------------------------
+// Constructor - Sets up to iterate over the given map (call next() to get
+// to the first entry)
+// ------------------------------------------------------------------------
+atHashMapIterator::atHashMapIterator(atHashMap * map)
+{
+    hashMap = map;
+    reset();
+}
+
+// ------------------------------------------------------------------------
+// Destructor
+// ------------------------------------------------------------------------
+atHashMapIterator::~atHashMapIterator()
+{
+}
+
+// ------------------------------------------------------------------------
+// Goes back to before the first entry
+// ------------------------------------------------------------------------
+void atHashMapIterator::reset()
+{
+    slotIndex = 0;
+    started = false;
+}
+
+// ------------------------------------------------------------------------
+// Moves to the next entry. Returns false once there are no more entries.
+// ------------------------------------------------------------------------
+bool atHashMapIterator::next()
+{
+    // Step past the current slot (unless we haven't started yet)
+    if (started)
+        slotIndex++;
+    started = true;
+
+    // Skip over empty slots
+    while ((slotIndex < hashMap->tableSize) &&
+           (hashMap->slotTable[slotIndex].slotKey == NULL))
+        slotIndex++;
+
+    // Tell the caller whether we found another entry
+    return (slotIndex < hashMap->tableSize);
+}
+
+// ------------------------------------------------------------------------
+// Returns the current entry's key, or NULL if not on an entry
+// ------------------------------------------------------------------------
+atItem * atHashMapIterator::getKey()
+{
+    if ((!started) || (slotIndex >= hashMap->tableSize))
+        return NULL;
+
+    return hashMap->slotTable[slotIndex].slotKey;
+}
+
+// ------------------------------------------------------------------------
+// Returns the current entry's value, or NULL if not on an entry
+// ------------------------------------------------------------------------
+atItem * atHashMapIterator::getValue()
+{
+    if ((!started) || (slotIndex >= hashMap->tableSize))
+        return NULL;
+
+    return hashMap->slotTable[slotIndex].slotValue;
+}
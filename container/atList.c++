@@ -30,14 +30,30 @@
 
 atList::atList()
 {
-   // Initialize the doubly-linked list
-   list_head = NULL;
-   list_tail = NULL;
-   num_entries = 0;
+   // Entries come straight from the heap
+   initList(NULL, false);
+}
 
-   // We haven't started traversing the list
-   current_entry = NULL;
-   next_entry = list_head;
+
+atList::atList(u_long poolBlockSize)
+{
+   // Entries come from a pool of our own, which lets removeAllEntries()
+   // free them all at once
+   initList(new atNodePool(sizeof(atListEntry), poolBlockSize), true);
+}
+
+
+atList::atList(atNodePool * sharedPool)
+{
+   // Entries come from the given pool, which may be shared with other
+   // lists (so we don't own it), but only if its nodes are big enough
+   if ((sharedPool != NULL) &&
+       (sharedPool->getNodeSize() < sizeof(atListEntry)))
+   {
+      notify(AT_WARN, "Node pool is too small for List entries.\n");
+      sharedPool = NULL;
+   }
+   initList(sharedPool, false);
 }
 
 
@@ -60,9 +76,151 @@ atList::~atList()
       // Move to the next entry
       current = current->next;
 
-      // Free the old one of which we saved a pointer
-      free(old);
+      // Free the old one of which we saved a pointer (unless it lives in
+      // our own pool, which we're about to get rid of anyway)
+      if (!owns_pool)
+         freeEntry(old);
+   }
+
+   // Get rid of our pool (if we have one)
+   if (owns_pool)
+      delete node_pool;
+}
+
+
+void atList::initList(atNodePool * pool, bool ownsPool)
+{
+   // Initialize the doubly-linked list
+   list_head = NULL;
+   list_tail = NULL;
+   num_entries = 0;
+
+   // We haven't started traversing the list
+   current_entry = NULL;
+   next_entry = list_head;
+
+   // No position is cached yet for getNthEntry()
+   index_entry = NULL;
+   index_position = 0;
+
+   // Keep track of where the entries come from
+   node_pool = pool;
+   owns_pool = ownsPool;
+}
+
+
+atListEntry * atList::allocateEntry()
+{
+   // Take the entry from the pool if we have one, otherwise from the heap
+   if (node_pool != NULL)
+      return (atListEntry *) node_pool->allocateNode();
+   else
+      return (atListEntry *) calloc(1, sizeof(atListEntry));
+}
+
+
+void atList::freeEntry(atListEntry * entry)
+{
+   // Give the entry back to wherever it came from
+   if (node_pool != NULL)
+      node_pool->freeNode(entry);
+   else
+      free(entry);
+}
+
+
+void atList::unlinkEntry(atListEntry * entry)
+{
+   // Fix the forward link (or the head if this is the first entry)
+   if (entry->previous == NULL)
+      list_head = entry->next;
+   else
+      entry->previous->next = entry->next;
+
+   // Fix the back link (or the tail if this is the last entry)
+   if (entry->next == NULL)
+      list_tail = entry->previous;
+   else
+      entry->next->previous = entry->previous;
+
+   // If the traversal is sitting on this entry, the next one to visit is
+   // the one after it
+   if (current_entry == entry)
+   {
+      current_entry = NULL;
+      next_entry = entry->next;
+   }
+   else if (next_entry == entry)
+      next_entry = entry->next;
+
+   // The positions of the entries after this one just changed, so forget
+   // the cached position
+   index_entry = NULL;
+
+   // Free up the structure from the list
+   freeEntry(entry);
+
+   // Remove one from our counter since we just took out a node
+   num_entries--;
+}
+
+
+atListEntry * atList::findNthEntry(u_long n)
+{
+   atListEntry *   entry;
+   u_long          position;
+   u_long          distance;
+
+   // Nothing to find if we don't have that many entries
+   if (n >= num_entries)
+      return NULL;
+
+   // Start from whichever end of the list is closer
+   if (n < num_entries - n)
+   {
+      entry = list_head;
+      position = 0;
+      distance = n;
+   }
+   else
+   {
+      entry = list_tail;
+      position = num_entries - 1;
+      distance = position - n;
+   }
+
+   // Starting from the last position we looked up is even better if it's
+   // closer (this is what makes walking the list by index cheap)
+   if (index_entry != NULL)
+   {
+      if ((index_position >= n) && (index_position - n < distance))
+      {
+         entry = index_entry;
+         position = index_position;
+      }
+      else if ((index_position < n) && (n - index_position < distance))
+      {
+         entry = index_entry;
+         position = index_position;
+      }
    }
+
+   // Walk to the requested entry
+   while (position < n)
+   {
+      entry = entry->next;
+      position++;
+   }
+   while (position > n)
+   {
+      entry = entry->previous;
+      position--;
+   }
+
+   // Remember this position for next time and return the entry
+   index_entry = entry;
+   index_position = n;
+   return entry;
 }
 
 
@@ -72,12 +230,20 @@ u_long atList::getNumEntries()
 }
 
 
+atNodePool * atList::getNodePool()
+{
+   // Return the pool the entries come from (NULL if they come from the
+   // heap)
+   return node_pool;
+}
+
+
 bool atList::addEntry(atItem * item)
 {
    atListEntry   *newEntry;
                                                                                 
    // Create a new entry for this item in the list
-   newEntry = (atListEntry *) calloc(1, sizeof(atListEntry));
+   newEntry = allocateEntry();
    if (newEntry == NULL)
    {
       // We failed to allocate the memory so tell user and return a failure
@@ -126,7 +292,7 @@ bool atList::insertEntry(atItem * item)
    else
    {
       // Create a new entry for this item in the list
-      newEntry = (atListEntry *) calloc(1, sizeof(atListEntry));
+      newEntry = allocateEntry();
       if (newEntry == NULL)
       {
          // We failed to allocate the memory so tell user and return a failure
@@ -165,6 +331,10 @@ bool atList::insertEntry(atItem * item)
          newEntry->next = current_entry;
       }
 
+      // The positions of the entries after this one just changed, so
+      // forget the cached position
+      index_entry = NULL;
+
       // Increment the number of entries since we just added one
       num_entries++;
 
@@ -176,83 +346,14 @@ bool atList::insertEntry(atItem * item)
 
 bool atList::removeCurrentEntry()
 {
-   atListEntry *  old;
-
    // If we don't have a current node, return a failure
    if (current_entry == NULL)
       return false;
    else
    {
-      // Take the node out of the list (but handle special case of being
-      // at the first node in the list)
-      if (current_entry->previous == NULL)
-      {
-         // We are removing the first node so move the head pointer
-         list_head = current_entry->next;
-
-         // Now we need to fix the back pointer (previous pointer) of the
-         // new first node but only if it exists of course (i.e. make sure
-         // we didn't just remove the ONLY node)
-         if (current_entry->next != NULL)
-         {
-            // We have another node so set its "previous" pointer to NULL
-            // so it knows it's the front of the list
-            current_entry->next->previous = NULL;
-         }
-         else
-         {
-            // We're also removing the last node (must be the only node) so
-            // we need to fix the tail pointer
-            list_tail = NULL;
-         }
-      }
-      else
-      {
-         // Otherwise, we are removing a node that isn't first so the
-         // general approach works (put in the new forward link and
-         // and then fix the back link if we have a node (i.e. we aren't
-         // removing the last node in the list)
-         current_entry->previous->next = current_entry->next;
-         if (current_entry->next != NULL)
-            current_entry->next->previous = current_entry->previous;
-      }
-
-      // Save a pointer to the structure holding this item
-      old = current_entry;
-
-      // Check for head and tail issues for the "current entry"
-      if (current_entry->previous == NULL)
-      {
-         // We removed the first node but the head is already okay
-
-         // But it could be the only node too
-         if (current_entry->next == NULL)
-            list_tail = NULL;
-
-         // Set the traversals
-         next_entry = list_head;
-         current_entry = NULL;
-      }
-      else if (current_entry->next == NULL)
-      {
-         // We removed the last node so fix the tail and set current and
-         // next as being done with the list
-         list_tail = current_entry->previous;
-         current_entry = NULL;
-         next_entry = NULL;
-      }
-      else
-      {
-         // We're removing a node in the middle
-         next_entry = current_entry->next;
-         current_entry = NULL;
-      }
-                                                                                
-      // Free up the structure from the list
-      free(old);
-
-      // Remove one from our counter since we just took out a node
-      num_entries--;
+      // Take the node out of the list (this also moves the traversal
+      // along so that the next entry is the one after the removed one)
+      unlinkEntry(current_entry);
                                                                                 
       // Return success
       return true;
@@ -262,18 +363,33 @@ bool atList::removeCurrentEntry()
 
 bool atList::removeAllEntries()
 {
-   // We'll do this by calling removeCurrentEntry() for each entry in
-   // the list (since we're removing all entries, it won't matter that
-   // we're messing with the current_entry pointer)
+   atListEntry *   old;
+
+   // If we have our own pool, nothing else is using it, so we can just
+   // drop all of the entries and hand them back to the pool at once
+   if (owns_pool)
+   {
+      list_head = NULL;
+      node_pool->freeAllNodes();
+   }
+
+   // Otherwise, free the entries one at a time (we aren't deleting the
+   // items, only the entries holding them)
    while (list_head != NULL)
    {
-       current_entry = list_head;
-       removeCurrentEntry();
+      old = list_head;
+      list_head = list_head->next;
+      freeEntry(old);
    }
 
+   // The list is now empty
+   list_tail = NULL;
+   num_entries = 0;
+
    // Set traversal pointers
    current_entry = NULL;
    next_entry = NULL;
+   index_entry = NULL;
 
    // Return success
    return true;
@@ -344,27 +460,26 @@ atItem * atList::getLastEntry()
 
 atItem * atList::getNthEntry(u_long n)
 {
-   u_long     count;
-   atItem *   item;
+   atListEntry *   entry;
 
-   // Walk the list until we reach the n'th element
-   count = 0;
-   item = getFirstEntry();
-   while ((count < n) && (item != NULL))
-   {
-       // Increment the count
-       count++;
+   // Find the n'th entry (this walks from the closest of the head, the
+   // tail, or the entry found last time)
+   entry = findNthEntry(n);
 
-       // Advance the current entry pointer
-       item = getNextEntry();
+   // If there is no such entry, leave the traversal at the end of the
+   // list and return NULL
+   if (entry == NULL)
+   {
+      current_entry = list_tail;
+      next_entry = NULL;
+      return NULL;
    }
 
-   // If the count reached the target number, return the corresponding item
-   if (count == n)
-      return item;
-
-   // Otherwise return NULL, since we never got to the requested item
-   return NULL;
+   // Make the entry the current one (so the traversal can continue from
+   // it) and return its item
+   current_entry = entry;
+   next_entry = entry->next;
+   return entry->item;
 }
 
 
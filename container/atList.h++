@@ -35,6 +35,7 @@
 #include <sys/types.h>
 #include "atNotifier.h++"
 #include "atItem.h++"
+#include "atNodePool.h++"
 #include "atOSDefs.h++"
 
 
@@ -49,6 +50,8 @@ typedef struct atEntry
 
 class ATLAS_SYM atList : public atNotifier
 {
+   friend class atListIterator;
+
    protected:
       atListEntry *   list_head;
       atListEntry *   list_tail;
@@ -58,11 +61,26 @@ class ATLAS_SYM atList : public atNotifier
       atListEntry *   current_entry;
       atListEntry *   next_entry;
 
+      atListEntry *   index_entry;
+      u_long          index_position;
+
+      atNodePool *    node_pool;
+      bool            owns_pool;
+
+      void            initList(atNodePool * pool, bool ownsPool);
+      atListEntry *   allocateEntry();
+      void            freeEntry(atListEntry * entry);
+      void            unlinkEntry(atListEntry * entry);
+      atListEntry *   findNthEntry(u_long n);
+
    public:
       atList();
+      atList(u_long poolBlockSize);
+      atList(atNodePool * sharedPool);
       virtual ~atList();
 
       virtual u_long     getNumEntries();
+      atNodePool *       getNodePool();
 
       virtual bool       addEntry(atItem * item);
       virtual bool       insertEntry(atItem * item);
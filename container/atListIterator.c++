@@ -0,0 +1,199 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "atListIterator.h++"
+
+
+atListIterator::atListIterator(atList * list)
+{
+   // Start before the first entry, so getNextEntry() returns the first
+   // entry just like getFirstEntry() does
+   the_list = list;
+   current_entry = NULL;
+   next_entry = list->list_head;
+   next_index = 0;
+}
+
+
+atListIterator::~atListIterator()
+{
+}
+
+
+atItem * atListIterator::getFirstEntry()
+{
+   // Go to the first node (if it exists)
+   current_entry = the_list->list_head;
+   if (current_entry != NULL)
+   {
+      // The next entry is the second one
+      next_entry = current_entry->next;
+      next_index = 1;
+
+      // Return the first item
+      return current_entry->item;
+   }
+   else
+   {
+      // Empty list
+      next_entry = NULL;
+      next_index = 0;
+      return NULL;
+   }
+}
+
+
+atItem * atListIterator::getNextEntry()
+{
+   // If there is a next node, move on and return it
+   if (next_entry != NULL)
+   {
+      // Advance
+      current_entry = next_entry;
+      next_entry = current_entry->next;
+      next_index++;
+
+      // Return the item
+      return current_entry->item;
+   }
+   else
+      return NULL;
+}
+
+
+atItem * atListIterator::getPreviousEntry()
+{
+   atListEntry *   entry;
+
+   // Figure out which entry comes before our position (if the current
+   // entry was just removed, that's the one before the next entry, and
+   // if we're past the end, that's the last one)
+   if (current_entry != NULL)
+   {
+      entry = current_entry->previous;
+      next_index--;
+   }
+   else if (next_entry != NULL)
+      entry = next_entry->previous;
+   else
+   {
+      entry = the_list->list_tail;
+      next_index = the_list->num_entries;
+   }
+
+   // If we backed up past the first entry, we're back at the start
+   if (entry == NULL)
+   {
+      current_entry = NULL;
+      next_entry = the_list->list_head;
+      next_index = 0;
+      return NULL;
+   }
+
+   // Otherwise, the entry we found is now the current one
+   current_entry = entry;
+   next_entry = entry->next;
+   return entry->item;
+}
+
+
+atItem * atListIterator::getLastEntry()
+{
+   // Go to the last node (if it exists)
+   current_entry = the_list->list_tail;
+   next_entry = NULL;
+   next_index = the_list->num_entries;
+
+   // If we have a last node, return the item stored in it
+   if (current_entry != NULL)
+      return current_entry->item;
+   else
+      return NULL;
+}
+
+
+atItem * atListIterator::getNthEntry(u_long n)
+{
+   atListEntry *   entry;
+
+   // Let the list find the entry (it walks from whichever known position
+   // is closest)
+   entry = the_list->findNthEntry(n);
+
+   // If there is no such entry, go past the end of the list
+   if (entry == NULL)
+   {
+      current_entry = NULL;
+      next_entry = NULL;
+      next_index = the_list->num_entries;
+      return NULL;
+   }
+
+   // Make the entry the current one and return its item
+   current_entry = entry;
+   next_entry = entry->next;
+   next_index = n + 1;
+   return entry->item;
+}
+
+
+atItem * atListIterator::getCurrentEntry()
+{
+   // Return the current item (if we're on one)
+   if (current_entry != NULL)
+      return current_entry->item;
+   else
+      return NULL;
+}
+
+
+u_long atListIterator::getCurrentIndex()
+{
+   // The current entry comes right before the next one (if we aren't on
+   // an entry, this is the index the next entry will have)
+   if (current_entry != NULL)
+      return next_index - 1;
+   else
+      return next_index;
+}
+
+
+bool atListIterator::removeCurrentEntry()
+{
+   // If we don't have a current node, return a failure
+   if (current_entry == NULL)
+      return false;
+
+   // Take the entry out of the list; the entry after it moves into its
+   // position, so it becomes our next entry and keeps the same index
+   next_entry = current_entry->next;
+   the_list->unlinkEntry(current_entry);
+   current_entry = NULL;
+   next_index--;
+
+   // Return success
+   return true;
+}
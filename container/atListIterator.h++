@@ -0,0 +1,68 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AT_LIST_ITERATOR_H
+#define AT_LIST_ITERATOR_H
+
+
+// INCLUDES
+#include "atList.h++"
+
+
+// Walks through an atList with its own position, independent of the
+// list's built-in traversal (so several iterators can walk the same list
+// at once, or a loop can walk it while calling code that uses
+// getFirstEntry()/getNextEntry()).  The iterator is a plain object meant
+// to live on the stack.  Entries may only be removed through the
+// iterator while it's in use; removing the iterator's current entry
+// through the list (or another iterator) leaves it dangling.
+class ATLAS_SYM atListIterator
+{
+   protected:
+      atList *        the_list;
+
+      atListEntry *   current_entry;
+      atListEntry *   next_entry;
+      u_long          next_index;
+
+   public:
+      atListIterator(atList * list);
+      virtual ~atListIterator();
+
+      atItem *   getFirstEntry();
+      atItem *   getNextEntry();
+      atItem *   getPreviousEntry();
+      atItem *   getLastEntry();
+      atItem *   getNthEntry(u_long n);
+
+      atItem *   getCurrentEntry();
+      u_long     getCurrentIndex();
+
+      bool       removeCurrentEntry();
+};
+
+#endif
+
@@ -37,9 +37,34 @@
 // ------------------------------------------------------------------------
 atMap::atMap()
 {
-    // Tree initially has not root node and no nodes
-    treeRoot = NULL;
-    treeSize = 0;
+    // Nodes come straight from the heap
+    initMap(NULL, false);
+}
+
+// ------------------------------------------------------------------------
+// Constructor - Sets the tree to empty, with its nodes coming from a pool
+// of its own (so clear() can free them all at once)
+// ------------------------------------------------------------------------
+atMap::atMap(u_long poolBlockSize)
+{
+    initMap(new atNodePool(sizeof(atMapNode), poolBlockSize), true);
+}
+
+// ------------------------------------------------------------------------
+// Constructor - Sets the tree to empty, with its nodes coming from the
+// given pool (which may be shared with other maps, so the map doesn't own
+// it)
+// ------------------------------------------------------------------------
+atMap::atMap(atNodePool * sharedPool)
+{
+    // Make sure the pool's nodes are big enough to hold ours
+    if ((sharedPool != NULL) &&
+        (sharedPool->getNodeSize() < sizeof(atMapNode)))
+    {
+        notify(AT_WARN, "Node pool is too small for Map nodes.\n");
+        sharedPool = NULL;
+    }
+    initMap(sharedPool, false);
 }
 
 // ------------------------------------------------------------------------
@@ -49,6 +74,10 @@ atMap::~atMap()
 {
     // Delete all tree entries
     clear();
+
+    // Get rid of our pool (if we have one)
+    if (ownsPool)
+        delete nodePool;
 }
 
 // ------------------------------------------------------------------------
@@ -66,7 +95,9 @@ bool atMap::addEntry(atItem * key, atItem * value)
 
     // Create the new node using the given key and value. New nodes
     // are initially colored red.
-    atMapNode *newNode = new atMapNode;
+    atMapNode *newNode = allocateNode();
+    if (newNode == NULL)
+        return false;
     newNode->leftChild = NULL;
     newNode->rightChild = NULL;
     newNode->parent = NULL;
@@ -281,6 +312,11 @@ void atMap::clear()
 
     // The deleteTree function does all of the actual work
     deleteTree(treeRoot);
+
+    // If we have our own pool, deleteTree() left the nodes alone so they
+    // can all go back to the pool at once
+    if (ownsPool)
+        nodePool->freeAllNodes();
     
     // Set the tree to empty
     treeRoot = NULL;
@@ -327,6 +363,45 @@ void atMap::getSortedList(atList * keyList, atList * valueList)
     }
 }
 
+// ------------------------------------------------------------------------
+// Private function
+// Sets the tree to empty and records where its nodes come from
+// ------------------------------------------------------------------------
+void atMap::initMap(atNodePool * pool, bool ownPool)
+{
+    // Tree initially has not root node and no nodes
+    treeRoot = NULL;
+    treeSize = 0;
+
+    // Remember the pool (if any)
+    nodePool = pool;
+    ownsPool = ownPool;
+}
+
+// ------------------------------------------------------------------------
+// Private function
+// Gets memory for a new node, from the pool if there is one
+// ------------------------------------------------------------------------
+atMapNode * atMap::allocateNode()
+{
+    if (nodePool != NULL)
+        return (atMapNode *)nodePool->allocateNode();
+    else
+        return new atMapNode;
+}
+
+// ------------------------------------------------------------------------
+// Private function
+// Gives a node's memory back to wherever it came from
+// ------------------------------------------------------------------------
+void atMap::freeNode(atMapNode * node)
+{
+    if (nodePool != NULL)
+        nodePool->freeNode(node);
+    else
+        delete node;
+}
+
 // ------------------------------------------------------------------------
 // Private function
 // Searches the subtree rooted at 'node' for a node with the given key.
@@ -617,7 +692,7 @@ void atMap::deleteNode(atMapNode * node)
             delete node->nodeKey;
         if (node->nodeValue != NULL)
             delete node->nodeValue;
-        delete node;
+        freeNode(node);
     }
     else if ((node->leftChild == NULL) || (node->rightChild == NULL))
     {
@@ -651,7 +726,7 @@ void atMap::deleteNode(atMapNode * node)
             delete node->nodeKey;
         if (node->nodeValue != NULL)
             delete node->nodeValue;
-        delete node;
+        freeNode(node);
     }
     else
     {
@@ -711,7 +786,7 @@ void atMap::removeNode(atMapNode * node)
             rebalanceDelete(parent, childType);
         
         // Delete the detached node
-        delete node;
+        freeNode(node);
     }
     else if ((node->leftChild == NULL) || (node->rightChild == NULL))
     {
@@ -741,7 +816,7 @@ void atMap::removeNode(atMapNode * node)
             rebalanceDelete(parent, childType);
 
         // Delete the detached node
-        delete node;
+        freeNode(node);
     }
     else
     {
@@ -917,7 +992,8 @@ void atMap::deleteTree(atMapNode * node)
         delete node->nodeKey;
     if (node->nodeValue != NULL)
         delete node->nodeValue;
-    delete node;
+    if (!ownsPool)
+        freeNode(node);
 }
 
 // ------------------------------------------------------------------------
@@ -31,6 +31,7 @@
 #include "atGlobals.h++"
 #include "atList.h++"
 #include "atItem.h++"
+#include "atNodePool.h++"
 #include "atNotifier.h++"
 #include "atOSDefs.h++"
 
@@ -60,11 +61,19 @@ struct atMapNode
 
 class ATLAS_SYM atMap : public atNotifier
 {
+    friend class atMapIterator;
+
 private:
 
     atMapNode *   treeRoot;
     u_long        treeSize;
+
+    atNodePool *  nodePool;
+    bool          ownsPool;
     
+    void              initMap(atNodePool * pool, bool ownPool);
+    atMapNode *       allocateNode();
+    void              freeNode(atMapNode * node);
     atMapNode *       findNode(atMapNode * node, atItem * key);
     void              rebalanceInsert(atMapNode * node);
     void              rebalanceDelete(atMapNode * parent,
@@ -83,6 +92,8 @@ private:
 public:
 
                 atMap();
+                atMap(u_long poolBlockSize);
+                atMap(atNodePool * sharedPool);
     virtual     ~atMap();
 
     bool        addEntry(atItem * key, atItem * value);
@@ -0,0 +1,122 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "atMapIterator.h++"
+
+// ------------------------------------------------------------------------
+// Constructor - Sets up to iterate over the given map (call next() to get
+// to the first entry)
+// ------------------------------------------------------------------------
+atMapIterator::atMapIterator(atMap * map)
+{
+    treeMap = map;
+    reset();
+}
+
+// ------------------------------------------------------------------------
+// Destructor
+// ------------------------------------------------------------------------
+atMapIterator::~atMapIterator()
+{
+}
+
+// ------------------------------------------------------------------------
+// Goes back to before the first entry
+// ------------------------------------------------------------------------
+void atMapIterator::reset()
+{
+    currentNode = NULL;
+    started = false;
+}
+
+// ------------------------------------------------------------------------
+// Moves to the entry with the next highest key. Returns false once there
+// are no more entries.
+// ------------------------------------------------------------------------
+bool atMapIterator::next()
+{
+    atMapNode *child;
+
+    // The first entry is the leftmost node in the tree
+    if (!started)
+    {
+        started = true;
+        currentNode = treeMap->treeRoot;
+        if (currentNode != NULL)
+        {
+            while (currentNode->leftChild)
+                currentNode = currentNode->leftChild;
+        }
+        return (currentNode != NULL);
+    }
+
+    // Nothing after the end
+    if (currentNode == NULL)
+        return false;
+
+    // If there's a right subtree, the next entry is its leftmost node
+    if (currentNode->rightChild)
+    {
+        currentNode = currentNode->rightChild;
+        while (currentNode->leftChild)
+            currentNode = currentNode->leftChild;
+        return true;
+    }
+
+    // Otherwise, climb until we come up from a left child; that parent
+    // is the next entry (if we run out of parents, we're done)
+    child = currentNode;
+    currentNode = currentNode->parent;
+    while ((currentNode != NULL) && (currentNode->rightChild == child))
+    {
+        child = currentNode;
+        currentNode = currentNode->parent;
+    }
+    return (currentNode != NULL);
+}
+
+// ------------------------------------------------------------------------
+// Returns the current entry's key, or NULL if not on an entry
+// ------------------------------------------------------------------------
+atItem * atMapIterator::getKey()
+{
+    if (currentNode == NULL)
+        return NULL;
+
+    return currentNode->nodeKey;
+}
+
+// ------------------------------------------------------------------------
+// Returns the current entry's value, or NULL if not on an entry
+// ------------------------------------------------------------------------
+atItem * atMapIterator::getValue()
+{
+    if (currentNode == NULL)
+        return NULL;
+
+    return currentNode->nodeValue;
+}
@@ -0,0 +1,214 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "atNodePool.h++"
+
+
+atNodePool::atNodePool(u_long nodeSize)
+{
+   // Use the default number of nodes per block
+   initPool(nodeSize, AT_NODE_POOL_DEFAULT_BLOCK_SIZE);
+}
+
+
+atNodePool::atNodePool(u_long nodeSize, u_long nodesPerBlock)
+{
+   // Use the requested number of nodes per block
+   initPool(nodeSize, nodesPerBlock);
+}
+
+
+atNodePool::~atNodePool()
+{
+   u_long   i;
+
+   // Release all of the blocks (and with them, every node)
+   for (i = 0; i < num_blocks; i++)
+      free(block_list[i]);
+   free(block_list);
+}
+
+
+void atNodePool::initPool(u_long nodeSize, u_long nodesPerBlock)
+{
+   // Free nodes hold the free list link, so a node has to be at least
+   // big enough for a pointer, and we round the size up so that every
+   // node in a block stays suitably aligned
+   if (nodeSize < sizeof(void *))
+      nodeSize = sizeof(void *);
+   node_size = (nodeSize + sizeof(double) - 1) & ~(sizeof(double) - 1);
+
+   // Make sure each block holds at least one node
+   if (nodesPerBlock < 1)
+      nodesPerBlock = 1;
+   nodes_per_block = nodesPerBlock;
+
+   // No blocks yet (we don't allocate until the first node is needed)
+   block_list = NULL;
+   num_blocks = 0;
+   max_blocks = 0;
+
+   // Nothing carved and nothing on the free list
+   carve_block = 0;
+   carve_index = 0;
+   free_list = NULL;
+
+   // Clear the statistics
+   num_allocated = 0;
+}
+
+
+bool atNodePool::addBlock()
+{
+   void **   newList;
+   void *    newBlock;
+   u_long    newMax;
+
+   // Grow the list of blocks if it's full
+   if (num_blocks == max_blocks)
+   {
+      // Double the list size (starting with a handful of blocks)
+      newMax = max_blocks * 2;
+      if (newMax < 8)
+         newMax = 8;
+      newList = (void **) realloc(block_list, newMax * sizeof(void *));
+      if (newList == NULL)
+         return false;
+
+      // Use the new list
+      block_list = newList;
+      max_blocks = newMax;
+   }
+
+   // Allocate the block itself
+   newBlock = malloc(node_size * nodes_per_block);
+   if (newBlock == NULL)
+      return false;
+
+   // Add it to the end of the list
+   block_list[num_blocks] = newBlock;
+   num_blocks++;
+
+   // Return success
+   return true;
+}
+
+
+void * atNodePool::allocateNode()
+{
+   void *   node;
+
+   // Reuse a freed node if there is one
+   if (free_list != NULL)
+   {
+      // Pop it off the front of the free list (the link is stored in the
+      // node itself)
+      node = free_list;
+      free_list = *((void **) node);
+   }
+   else
+   {
+      // Move on to the next block if the current one is used up (nodes
+      // are carved out of each block in order, which is what lets
+      // freeAllNodes() hand them all back by just rewinding)
+      if ((carve_block < num_blocks) && (carve_index >= nodes_per_block))
+      {
+         carve_block++;
+         carve_index = 0;
+      }
+
+      // We need a new block if we've carved through all of them
+      if (carve_block >= num_blocks)
+      {
+         if (!addBlock())
+         {
+            // We failed to allocate the memory so tell user and return a
+            // failure
+            notify(AT_WARN, "Unable to allocate memory in Node Pool.\n");
+            return NULL;
+         }
+
+         // Start carving the new block
+         carve_block = num_blocks - 1;
+         carve_index = 0;
+      }
+
+      // Carve out the next node
+      node = (void *) ((char *) block_list[carve_block] +
+                       carve_index * node_size);
+      carve_index++;
+   }
+
+   // Count the node and return it
+   num_allocated++;
+   return node;
+}
+
+
+void atNodePool::freeNode(void * node)
+{
+   // Ignore NULL nodes
+   if (node == NULL)
+      return;
+
+   // Push the node onto the front of the free list
+   *((void **) node) = free_list;
+   free_list = node;
+
+   // One fewer node in use
+   num_allocated--;
+}
+
+
+void atNodePool::freeAllNodes()
+{
+   // Rewind to the start of the first block and forget the free list;
+   // the blocks stay around to be carved up again, so refilling the
+   // container afterward doesn't need any allocations
+   carve_block = 0;
+   carve_index = 0;
+   free_list = NULL;
+   num_allocated = 0;
+}
+
+
+u_long atNodePool::getNodeSize()
+{
+   return node_size;
+}
+
+
+u_long atNodePool::getNumAllocated()
+{
+   return num_allocated;
+}
+
+
+u_long atNodePool::getNumBlocks()
+{
+   return num_blocks;
+}
+
@@ -0,0 +1,84 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AT_NODE_POOL_H
+#define AT_NODE_POOL_H
+
+
+// INCLUDES
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/types.h>
+#include "atNotifier.h++"
+#include "atOSDefs.h++"
+
+
+#define AT_NODE_POOL_DEFAULT_BLOCK_SIZE   256
+
+
+// Hands out fixed-size nodes carved from large blocks, so containers that
+// churn many small entries (atList, atMap) don't go to the heap for each
+// one.  Freed nodes go on a free list for reuse, and freeAllNodes()
+// returns every node at once without touching the individual nodes.  A
+// pool can be private to one container or shared by several containers
+// with the same node size (in which case it must outlive all of them,
+// and it's up to them not to call freeAllNodes()).  Not thread-safe.
+class ATLAS_SYM atNodePool : public atNotifier
+{
+   protected:
+      u_long      node_size;
+      u_long      nodes_per_block;
+
+      void **     block_list;
+      u_long      num_blocks;
+      u_long      max_blocks;
+
+      u_long      carve_block;
+      u_long      carve_index;
+
+      void *      free_list;
+
+      u_long      num_allocated;
+
+      void        initPool(u_long nodeSize, u_long nodesPerBlock);
+      bool        addBlock();
+
+   public:
+      atNodePool(u_long nodeSize);
+      atNodePool(u_long nodeSize, u_long nodesPerBlock);
+      virtual ~atNodePool();
+
+      void *     allocateNode();
+      void       freeNode(void * node);
+      void       freeAllNodes();
+
+      u_long     getNodeSize();
+      u_long     getNumAllocated();
+      u_long     getNumBlocks();
+};
+
+#endif
+
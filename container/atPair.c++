@@ -146,3 +146,19 @@ int atPair::compare(atItem * otherItem)
    }
 }
 
+
+u_long atPair::getHashCode()
+{
+   u_long   hash;
+
+   // Combine the items' hash codes (in order, as the pairs are compared
+   // item by item)
+   hash = 0;
+   if (first_item != NULL)
+      hash = first_item->getHashCode();
+   hash *= 31;
+   if (second_item != NULL)
+      hash += second_item->getHashCode();
+
+   return hash;
+}
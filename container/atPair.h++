@@ -55,6 +55,7 @@ class ATLAS_SYM atPair : public atItem
 
       virtual bool   equals(atItem * otherItem);
       virtual int    compare(atItem * otherItem);
+      virtual u_long getHashCode();
 };
 
 
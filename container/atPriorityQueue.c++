@@ -27,8 +27,6 @@
 
 #include "atPriorityQueue.h++"
 
-#include <math.h>
-
 
 atPriorityQueue::atPriorityQueue()
 {
@@ -178,7 +176,7 @@ void atPriorityQueue::bubbleUp(int index)
       return;
 
    // Calculate the index of the parent node.
-   parentIndex = (int)floor((index - 1) / 2.0);
+   parentIndex = (index - 1) / 2;
 
    // If the current item has higher priority than its parent, they need to be
    // swapped.
@@ -203,8 +201,9 @@ void atPriorityQueue::trickleDown(int index)
    bool       rightChildHigher;
    atItem *   swapItem;
 
-   // Calculate the indices of the children of the current node.
-   leftChildIndex = (index * 2);
+   // Calculate the indices of the children of the current node (the root
+   // is at index 0, so its children are at 1 and 2).
+   leftChildIndex = (index * 2) + 1;
    rightChildIndex = leftChildIndex + 1;
 
    // Determine whether the left child has a higher priority than this node.
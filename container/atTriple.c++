@@ -180,3 +180,22 @@ int atTriple::compare(atItem * otherItem)
    }
 }
 
+
+u_long atTriple::getHashCode()
+{
+   u_long   hash;
+
+   // Combine the items' hash codes (in order, as the triples are compared
+   // item by item)
+   hash = 0;
+   if (first_item != NULL)
+      hash = first_item->getHashCode();
+   hash *= 31;
+   if (second_item != NULL)
+      hash += second_item->getHashCode();
+   hash *= 31;
+   if (third_item != NULL)
+      hash += third_item->getHashCode();
+
+   return hash;
+}
@@ -57,6 +57,7 @@ class ATLAS_SYM atTriple : public atItem
 
       virtual bool   equals(atItem * otherItem);
       virtual int    compare(atItem * otherItem);
+      virtual u_long getHashCode();
 };
 
 
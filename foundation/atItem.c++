@@ -25,6 +25,7 @@
 // limitations under the License.
 
 
+#include <math.h>
 #include <string.h>
 #include "atItem.h++"
 
@@ -56,3 +57,39 @@ int atItem::compare(atItem * otherItem)
    return (long ) otherItem - (long ) this;
 }
 
+
+u_long atItem::getHashCode()
+{
+   // Items are only equal to themselves at this level, so hash the
+   // pointer value
+   return (u_long ) this;
+}
+
+
+u_long atItem::hashFloat(float value)
+{
+   uint32_t   bits;
+
+   // Values within the tolerance of each other are equal.  Below 2^-15,
+   // floats are close enough together to be chained by equal values, so
+   // they all have to share a hash code.  From there up, neighbouring
+   // floats are farther apart than the tolerance, so equal values are
+   // identical and their bits can be hashed (this also covers -0.0)
+   if (fabs(value) < 1.0 / 32768.0)
+      return 0;
+   memcpy(&bits, &value, sizeof(bits));
+   return (u_long ) bits;
+}
+
+
+u_long atItem::hashDouble(double value)
+{
+   uint64_t   bits;
+
+   // Same as for floats, but doubles are only farther apart than the
+   // tolerance from 2^14 up
+   if (fabs(value) < 16384.0)
+      return 0;
+   memcpy(&bits, &value, sizeof(bits));
+   return (u_long ) (bits ^ (bits >> 32));
+}
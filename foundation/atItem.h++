@@ -39,12 +39,24 @@
 
 class ATLAS_SYM atItem : public atNotifier
 {
+   protected:
+      // Hash codes for floating-point values that are consistent with
+      // comparing them by AT_DEFAULT_TOLERANCE (for subclasses whose
+      // equals() does that)
+      static u_long    hashFloat(float value);
+      static u_long    hashDouble(double value);
+
    public:
       atItem();
       virtual ~atItem();
 
-      virtual bool   equals(atItem * otherItem);
-      virtual int    compare(atItem * otherItem);
+      virtual bool     equals(atItem * otherItem);
+      virtual int      compare(atItem * otherItem);
+
+      // Hash code for hashed containers (like atHashMap).  Items that
+      // are equal must have the same hash code, so any class that
+      // overrides equals() needs to override this too
+      virtual u_long   getHashCode();
 };
 
 #endif
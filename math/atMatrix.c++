@@ -1500,3 +1500,19 @@ int atMatrix::compare(atItem * otherItem)
    }
 }
 
+// ------------------------------------------------------------------------
+// atItem-derived method.  Return a hash code for the matrix that agrees
+// with equals() (which compares elements within the default tolerance)
+// ------------------------------------------------------------------------
+u_long atMatrix::getHashCode()
+{
+   u_long hash;
+   int    i;
+
+   // Combine the row vectors' hash codes
+   hash = 0;
+   for (i = 0; i < 4; i++)
+      hash = hash * 31 + data[i].getHashCode();
+
+   return hash;
+}
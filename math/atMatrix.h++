@@ -125,6 +125,7 @@ public:
 
     virtual bool      equals(atItem * otherItem);
     virtual int       compare(atItem * otherItem);
+    virtual u_long    getHashCode();
 };
 
 #endif
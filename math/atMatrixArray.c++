@@ -0,0 +1,432 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "atMatrixArray.h++"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "atSIMD.h++"
+
+// ------------------------------------------------------------------------
+// Multiplies two row-major 4x4 matrices (left * right), placing the
+// product in result. The result may be the same storage as either
+// operand.
+// ------------------------------------------------------------------------
+static inline void multiplyMatrices(const double *left, const double *right,
+                                    double *result)
+{
+#if defined(AT_SIMD_AVX)
+    __m256d r0, r1, r2, r3, row[4];
+    int i;
+
+    // Each row of the product is a linear combination of the rows of the
+    // right-hand matrix, weighted by the elements of the matching row of
+    // the left-hand matrix
+    r0 = _mm256_loadu_pd(&right[0]);
+    r1 = _mm256_loadu_pd(&right[4]);
+    r2 = _mm256_loadu_pd(&right[8]);
+    r3 = _mm256_loadu_pd(&right[12]);
+    for (i = 0; i < 4; i++)
+        row[i] = _mm256_add_pd(
+            _mm256_add_pd(
+                _mm256_mul_pd(_mm256_broadcast_sd(&left[i*4 + 0]), r0),
+                _mm256_mul_pd(_mm256_broadcast_sd(&left[i*4 + 1]), r1)),
+            _mm256_add_pd(
+                _mm256_mul_pd(_mm256_broadcast_sd(&left[i*4 + 2]), r2),
+                _mm256_mul_pd(_mm256_broadcast_sd(&left[i*4 + 3]), r3)));
+
+    // Store only after all rows are computed, in case the result overlaps
+    // one of the operands
+    for (i = 0; i < 4; i++)
+        _mm256_storeu_pd(&result[i*4], row[i]);
+#elif defined(AT_SIMD_SSE2)
+    __m128d r0a, r0b, r1a, r1b, r2a, r2b, r3a, r3b, l0, l1, l2, l3;
+    __m128d rowA[4], rowB[4];
+    int i;
+
+    // Same approach as the AVX version, with each row split into two
+    // halves
+    r0a = _mm_loadu_pd(&right[0]);
+    r0b = _mm_loadu_pd(&right[2]);
+    r1a = _mm_loadu_pd(&right[4]);
+    r1b = _mm_loadu_pd(&right[6]);
+    r2a = _mm_loadu_pd(&right[8]);
+    r2b = _mm_loadu_pd(&right[10]);
+    r3a = _mm_loadu_pd(&right[12]);
+    r3b = _mm_loadu_pd(&right[14]);
+    for (i = 0; i < 4; i++)
+    {
+        l0 = _mm_set1_pd(left[i*4 + 0]);
+        l1 = _mm_set1_pd(left[i*4 + 1]);
+        l2 = _mm_set1_pd(left[i*4 + 2]);
+        l3 = _mm_set1_pd(left[i*4 + 3]);
+        rowA[i] = _mm_add_pd(
+            _mm_add_pd(_mm_mul_pd(l0, r0a), _mm_mul_pd(l1, r1a)),
+            _mm_add_pd(_mm_mul_pd(l2, r2a), _mm_mul_pd(l3, r3a)));
+        rowB[i] = _mm_add_pd(
+            _mm_add_pd(_mm_mul_pd(l0, r0b), _mm_mul_pd(l1, r1b)),
+            _mm_add_pd(_mm_mul_pd(l2, r2b), _mm_mul_pd(l3, r3b)));
+    }
+
+    // Store only after all rows are computed
+    for (i = 0; i < 4; i++)
+    {
+        _mm_storeu_pd(&result[i*4], rowA[i]);
+        _mm_storeu_pd(&result[i*4 + 2], rowB[i]);
+    }
+#else
+    double temp[16];
+    int i, j;
+
+    // Plain row-by-column products into a temporary matrix
+    for (i = 0; i < 4; i++)
+        for (j = 0; j < 4; j++)
+            temp[i*4 + j] =
+                (left[i*4 + 0] * right[0*4 + j] +
+                 left[i*4 + 1] * right[1*4 + j]) +
+                (left[i*4 + 2] * right[2*4 + j] +
+                 left[i*4 + 3] * right[3*4 + j]);
+
+    memcpy(result, temp, sizeof(temp));
+#endif
+}
+
+// ------------------------------------------------------------------------
+// Copies an atMatrix into sixteen row-major values
+// ------------------------------------------------------------------------
+static void unpackMatrix(const atMatrix &matrix, double *values)
+{
+    int i, j;
+
+    for (i = 0; i < 4; i++)
+        for (j = 0; j < 4; j++)
+            values[i*4 + j] = matrix.getValue(i, j);
+}
+
+// ------------------------------------------------------------------------
+// Default constructor - Creates an empty matrix array
+// ------------------------------------------------------------------------
+atMatrixArray::atMatrixArray()
+{
+    matrixData = NULL;
+    arraySize = 0;
+    arrayCapacity = 0;
+}
+
+// ------------------------------------------------------------------------
+// Size constructor - Creates an array of the given number of matrices,
+// all cleared to zero
+// ------------------------------------------------------------------------
+atMatrixArray::atMatrixArray(u_long size)
+{
+    matrixData = NULL;
+    arraySize = 0;
+    arrayCapacity = 0;
+
+    setSize(size);
+}
+
+// ------------------------------------------------------------------------
+// Copy constructor
+// ------------------------------------------------------------------------
+atMatrixArray::atMatrixArray(const atMatrixArray &source)
+{
+    matrixData = NULL;
+    arraySize = 0;
+    arrayCapacity = 0;
+
+    copy(source);
+}
+
+// ------------------------------------------------------------------------
+// Destructor
+// ------------------------------------------------------------------------
+atMatrixArray::~atMatrixArray()
+{
+    free(matrixData);
+}
+
+// ------------------------------------------------------------------------
+// Makes this array an exact duplicate of the source array
+// ------------------------------------------------------------------------
+void atMatrixArray::copy(const atMatrixArray &source)
+{
+    // Nothing to do if copying onto ourselves
+    if (this == &source)
+        return;
+
+    // Match the source size, then copy the matrices
+    setSize(source.arraySize);
+    if (arraySize == source.arraySize)
+        memcpy(matrixData, source.matrixData,
+            arraySize * 16 * sizeof(double));
+}
+
+// ------------------------------------------------------------------------
+// Clears every matrix in the array to zero
+// ------------------------------------------------------------------------
+void atMatrixArray::clear()
+{
+    if (arraySize > 0)
+        memset(matrixData, 0, arraySize * 16 * sizeof(double));
+}
+
+// ------------------------------------------------------------------------
+// Changes the number of matrices in the array. Existing matrices are
+// kept (up to the new size) and any new ones are cleared to zero. Memory
+// is only reallocated when the array grows past its current capacity.
+// ------------------------------------------------------------------------
+void atMatrixArray::setSize(u_long size)
+{
+    double *newData;
+
+    // Grow the storage if we need to
+    if (size > arrayCapacity)
+    {
+        newData = (double *) realloc(matrixData,
+            size * 16 * sizeof(double));
+        if (newData == NULL)
+        {
+            printf("atMatrixArray::setSize: Unable to allocate %lu "
+                "matrices\n", size);
+            return;
+        }
+
+        matrixData = newData;
+        arrayCapacity = size;
+    }
+
+    // Clear any matrices that we're adding to the end of the array
+    if (size > arraySize)
+        memset(&matrixData[arraySize * 16], 0,
+            (size - arraySize) * 16 * sizeof(double));
+
+    arraySize = size;
+}
+
+// ------------------------------------------------------------------------
+// Returns the number of matrices in the array
+// ------------------------------------------------------------------------
+u_long atMatrixArray::getSize() const
+{
+    return arraySize;
+}
+
+// ------------------------------------------------------------------------
+// Sets the matrix at the given index
+// ------------------------------------------------------------------------
+void atMatrixArray::setMatrix(u_long index, const atMatrix &matrix)
+{
+    // Bounds checking
+    if (index >= arraySize)
+    {
+        printf("atMatrixArray::setMatrix: Invalid index (%lu)\n", index);
+        return;
+    }
+
+    unpackMatrix(matrix, &matrixData[index * 16]);
+}
+
+// ------------------------------------------------------------------------
+// Returns the matrix at the given index
+// ------------------------------------------------------------------------
+atMatrix atMatrixArray::getMatrix(u_long index) const
+{
+    atMatrix result;
+    int i, j;
+
+    // Bounds checking
+    if (index >= arraySize)
+    {
+        printf("atMatrixArray::getMatrix: Invalid index (%lu)\n", index);
+        return result;
+    }
+
+    for (i = 0; i < 4; i++)
+        for (j = 0; j < 4; j++)
+            result.setValue(i, j, matrixData[index*16 + i*4 + j]);
+
+    return result;
+}
+
+// ------------------------------------------------------------------------
+// Direct access to the sixteen row-major values of the matrix at the
+// given index. The pointer is invalidated by setSize() and copy().
+// ------------------------------------------------------------------------
+double *atMatrixArray::getData(u_long index)
+{
+    // Bounds checking
+    if (index >= arraySize)
+    {
+        printf("atMatrixArray::getData: Invalid index (%lu)\n", index);
+        return NULL;
+    }
+
+    return &matrixData[index * 16];
+}
+
+// ------------------------------------------------------------------------
+// Direct access to the sixteen row-major values of the matrix at the
+// given index. The pointer is invalidated by setSize() and copy().
+// ------------------------------------------------------------------------
+const double *atMatrixArray::getData(u_long index) const
+{
+    // Bounds checking
+    if (index >= arraySize)
+    {
+        printf("atMatrixArray::getData: Invalid index (%lu)\n", index);
+        return NULL;
+    }
+
+    return &matrixData[index * 16];
+}
+
+// ------------------------------------------------------------------------
+// Multiplies every matrix in this array by the given matrix; the operand
+// matrix is considered to be on the left. The results are stored.
+// ------------------------------------------------------------------------
+void atMatrixArray::preMultiply(const atMatrix &operand)
+{
+    double values[16];
+    u_long i;
+
+    unpackMatrix(operand, values);
+    for (i = 0; i < arraySize; i++)
+        multiplyMatrices(values, &matrixData[i * 16], &matrixData[i * 16]);
+}
+
+// ------------------------------------------------------------------------
+// Multiplies each matrix in this array by the corresponding matrix in
+// the operand array; the operand matrices are considered to be on the
+// left. The results are stored.
+// ------------------------------------------------------------------------
+void atMatrixArray::preMultiply(const atMatrixArray &operand)
+{
+    u_long i;
+
+    // Bounds checking
+    if (operand.arraySize != arraySize)
+    {
+        printf("atMatrixArray::preMultiply: Array sizes do not match\n");
+        return;
+    }
+
+    for (i = 0; i < arraySize; i++)
+        multiplyMatrices(&operand.matrixData[i * 16], &matrixData[i * 16],
+            &matrixData[i * 16]);
+}
+
+// ------------------------------------------------------------------------
+// Multiplies every matrix in this array by the given matrix; the operand
+// matrix is considered to be on the right. The results are stored.
+// ------------------------------------------------------------------------
+void atMatrixArray::postMultiply(const atMatrix &operand)
+{
+    double values[16];
+    u_long i;
+
+    unpackMatrix(operand, values);
+    for (i = 0; i < arraySize; i++)
+        multiplyMatrices(&matrixData[i * 16], values, &matrixData[i * 16]);
+}
+
+// ------------------------------------------------------------------------
+// Multiplies each matrix in this array by the corresponding matrix in
+// the operand array; the operand matrices are considered to be on the
+// right. The results are stored.
+// ------------------------------------------------------------------------
+void atMatrixArray::postMultiply(const atMatrixArray &operand)
+{
+    getPostMultiplied(operand, this);
+}
+
+// ------------------------------------------------------------------------
+// Multiplies each matrix in this array by the corresponding matrix in
+// the operand array; the operand matrices are considered to be on the
+// right. The results are placed in the given result array (which is
+// resized to match this one).
+// ------------------------------------------------------------------------
+void atMatrixArray::getPostMultiplied(const atMatrixArray &operand,
+                                      atMatrixArray *result) const
+{
+    u_long i;
+
+    // Bounds checking
+    if (operand.arraySize != arraySize)
+    {
+        printf("atMatrixArray::getPostMultiplied: Array sizes do not "
+            "match\n");
+        return;
+    }
+
+    // Make sure the result is big enough
+    result->setSize(arraySize);
+    if (result->getSize() != arraySize)
+        return;
+
+    for (i = 0; i < arraySize; i++)
+        multiplyMatrices(&matrixData[i * 16], &operand.matrixData[i * 16],
+            &result->matrixData[i * 16]);
+}
+
+// ------------------------------------------------------------------------
+// Assignment operator
+// ------------------------------------------------------------------------
+atMatrixArray &atMatrixArray::operator=(const atMatrixArray &source)
+{
+    copy(source);
+    return *this;
+}
+
+// ------------------------------------------------------------------------
+// Print a textual representation of this array to standard output
+// ------------------------------------------------------------------------
+void atMatrixArray::print() const
+{
+    print(stdout);
+}
+
+// ------------------------------------------------------------------------
+// Print a textual representation of this array to the given file
+// ------------------------------------------------------------------------
+void atMatrixArray::print(FILE *fp) const
+{
+    u_long i;
+    int j;
+    const double *values;
+
+    for (i = 0; i < arraySize; i++)
+    {
+        values = &matrixData[i * 16];
+        for (j = 0; j < 4; j++)
+            fprintf(fp, "[%0.4lf, %0.4lf, %0.4lf, %0.4lf]\n", values[j*4],
+                values[j*4 + 1], values[j*4 + 2], values[j*4 + 3]);
+        fprintf(fp, "\n");
+    }
+}
+
@@ -0,0 +1,84 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AT_MATRIX_ARRAY_HPP
+#define AT_MATRIX_ARRAY_HPP
+
+class atMatrixArray;
+
+#include <stdio.h>
+
+#include "atGlobals.h++"
+#include "atItem.h++"
+#include "atMatrix.h++"
+#include "atOSDefs.h++"
+
+
+class ATLAS_SYM atMatrixArray : public atItem
+{
+private:
+
+    // Matrices are stored back to back in one contiguous block, sixteen
+    // row-major values per matrix
+    double      *matrixData;
+    u_long      arraySize;
+    u_long      arrayCapacity;
+
+public:
+
+                       atMatrixArray();
+                       atMatrixArray(u_long size);
+                       atMatrixArray(const atMatrixArray &source);
+    virtual            ~atMatrixArray();
+
+    void               copy(const atMatrixArray &source);
+    void               clear();
+
+    void               setSize(u_long size);
+    u_long             getSize() const;
+
+    void               setMatrix(u_long index, const atMatrix &matrix);
+    atMatrix           getMatrix(u_long index) const;
+
+    double             *getData(u_long index);
+    const double       *getData(u_long index) const;
+
+    void               preMultiply(const atMatrix &operand);
+    void               preMultiply(const atMatrixArray &operand);
+    void               postMultiply(const atMatrix &operand);
+    void               postMultiply(const atMatrixArray &operand);
+    void               getPostMultiplied(const atMatrixArray &operand,
+                                         atMatrixArray *result) const;
+
+    atMatrixArray      &operator=(const atMatrixArray &source);
+
+    void               print() const;
+    void               print(FILE *fp) const;
+};
+
+#endif
+
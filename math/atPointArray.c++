@@ -0,0 +1,501 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "atPointArray.h++"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "atSIMD.h++"
+#include "atTaskPool.h++"
+
+// Points per piece when a transform is split across a task pool (enough
+// that each piece is worth handing to another thread)
+#define AT_POINT_ARRAY_GRAIN_SIZE 16384
+
+// ------------------------------------------------------------------------
+// Transforms count points by the top three rows of a 4x4 matrix, given
+// as twelve row-major values. The source and destination arrays may be
+// the same arrays.
+// ------------------------------------------------------------------------
+static void xformPoints(const double m[12], u_long count,
+                        const double *srcX, const double *srcY,
+                        const double *srcZ, double *dstX, double *dstY,
+                        double *dstZ)
+{
+    u_long i;
+    double x, y, z;
+
+    i = 0;
+
+#if defined(AT_SIMD_AVX)
+    // Broadcast each matrix element across a register, then transform
+    // four points per iteration
+    __m256d m00 = _mm256_set1_pd(m[0]), m01 = _mm256_set1_pd(m[1]);
+    __m256d m02 = _mm256_set1_pd(m[2]), m03 = _mm256_set1_pd(m[3]);
+    __m256d m10 = _mm256_set1_pd(m[4]), m11 = _mm256_set1_pd(m[5]);
+    __m256d m12 = _mm256_set1_pd(m[6]), m13 = _mm256_set1_pd(m[7]);
+    __m256d m20 = _mm256_set1_pd(m[8]), m21 = _mm256_set1_pd(m[9]);
+    __m256d m22 = _mm256_set1_pd(m[10]), m23 = _mm256_set1_pd(m[11]);
+    __m256d vx, vy, vz;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        vx = _mm256_loadu_pd(&srcX[i]);
+        vy = _mm256_loadu_pd(&srcY[i]);
+        vz = _mm256_loadu_pd(&srcZ[i]);
+
+        _mm256_storeu_pd(&dstX[i], _mm256_add_pd(
+            _mm256_add_pd(_mm256_mul_pd(m00, vx), _mm256_mul_pd(m01, vy)),
+            _mm256_add_pd(_mm256_mul_pd(m02, vz), m03)));
+        _mm256_storeu_pd(&dstY[i], _mm256_add_pd(
+            _mm256_add_pd(_mm256_mul_pd(m10, vx), _mm256_mul_pd(m11, vy)),
+            _mm256_add_pd(_mm256_mul_pd(m12, vz), m13)));
+        _mm256_storeu_pd(&dstZ[i], _mm256_add_pd(
+            _mm256_add_pd(_mm256_mul_pd(m20, vx), _mm256_mul_pd(m21, vy)),
+            _mm256_add_pd(_mm256_mul_pd(m22, vz), m23)));
+    }
+#elif defined(AT_SIMD_SSE2)
+    // Same as above, two points per iteration
+    __m128d m00 = _mm_set1_pd(m[0]), m01 = _mm_set1_pd(m[1]);
+    __m128d m02 = _mm_set1_pd(m[2]), m03 = _mm_set1_pd(m[3]);
+    __m128d m10 = _mm_set1_pd(m[4]), m11 = _mm_set1_pd(m[5]);
+    __m128d m12 = _mm_set1_pd(m[6]), m13 = _mm_set1_pd(m[7]);
+    __m128d m20 = _mm_set1_pd(m[8]), m21 = _mm_set1_pd(m[9]);
+    __m128d m22 = _mm_set1_pd(m[10]), m23 = _mm_set1_pd(m[11]);
+    __m128d vx, vy, vz;
+
+    for (; i + 2 <= count; i += 2)
+    {
+        vx = _mm_loadu_pd(&srcX[i]);
+        vy = _mm_loadu_pd(&srcY[i]);
+        vz = _mm_loadu_pd(&srcZ[i]);
+
+        _mm_storeu_pd(&dstX[i], _mm_add_pd(
+            _mm_add_pd(_mm_mul_pd(m00, vx), _mm_mul_pd(m01, vy)),
+            _mm_add_pd(_mm_mul_pd(m02, vz), m03)));
+        _mm_storeu_pd(&dstY[i], _mm_add_pd(
+            _mm_add_pd(_mm_mul_pd(m10, vx), _mm_mul_pd(m11, vy)),
+            _mm_add_pd(_mm_mul_pd(m12, vz), m13)));
+        _mm_storeu_pd(&dstZ[i], _mm_add_pd(
+            _mm_add_pd(_mm_mul_pd(m20, vx), _mm_mul_pd(m21, vy)),
+            _mm_add_pd(_mm_mul_pd(m22, vz), m23)));
+    }
+#endif
+
+    // Scalar loop for the remaining points (or all of them, if there are
+    // no vector kernels on this platform)
+    for (; i < count; i++)
+    {
+        x = srcX[i];
+        y = srcY[i];
+        z = srcZ[i];
+        dstX[i] = (m[0] * x + m[1] * y) + (m[2] * z + m[3]);
+        dstY[i] = (m[4] * x + m[5] * y) + (m[6] * z + m[7]);
+        dstZ[i] = (m[8] * x + m[9] * y) + (m[10] * z + m[11]);
+    }
+}
+
+// ------------------------------------------------------------------------
+// Runs xformPoints() on pieces of the arrays for atTaskPool::parallelFor()
+// ------------------------------------------------------------------------
+class atPointXformRange : public atTaskRange
+{
+public:
+    const double *matrix;
+    const double *srcX, *srcY, *srcZ;
+    double *dstX, *dstY, *dstZ;
+
+    virtual void runRange(u_long start, u_long end)
+    {
+        xformPoints(matrix, end - start, &srcX[start], &srcY[start],
+            &srcZ[start], &dstX[start], &dstY[start], &dstZ[start]);
+    }
+};
+
+// ------------------------------------------------------------------------
+// Default constructor - Creates an empty point array
+// ------------------------------------------------------------------------
+atPointArray::atPointArray()
+{
+    xData = NULL;
+    yData = NULL;
+    zData = NULL;
+    arraySize = 0;
+    arrayCapacity = 0;
+}
+
+// ------------------------------------------------------------------------
+// Size constructor - Creates an array of the given number of points, all
+// set to the origin
+// ------------------------------------------------------------------------
+atPointArray::atPointArray(u_long size)
+{
+    xData = NULL;
+    yData = NULL;
+    zData = NULL;
+    arraySize = 0;
+    arrayCapacity = 0;
+
+    setSize(size);
+}
+
+// ------------------------------------------------------------------------
+// Copy constructor
+// ------------------------------------------------------------------------
+atPointArray::atPointArray(const atPointArray &source)
+{
+    xData = NULL;
+    yData = NULL;
+    zData = NULL;
+    arraySize = 0;
+    arrayCapacity = 0;
+
+    copy(source);
+}
+
+// ------------------------------------------------------------------------
+// Destructor
+// ------------------------------------------------------------------------
+atPointArray::~atPointArray()
+{
+    free(xData);
+    free(yData);
+    free(zData);
+}
+
+// ------------------------------------------------------------------------
+// Makes this array an exact duplicate of the source array
+// ------------------------------------------------------------------------
+void atPointArray::copy(const atPointArray &source)
+{
+    // Nothing to do if copying onto ourselves
+    if (this == &source)
+        return;
+
+    // Match the source size, then copy each coordinate array
+    setSize(source.arraySize);
+    if (arraySize == source.arraySize)
+    {
+        memcpy(xData, source.xData, arraySize * sizeof(double));
+        memcpy(yData, source.yData, arraySize * sizeof(double));
+        memcpy(zData, source.zData, arraySize * sizeof(double));
+    }
+}
+
+// ------------------------------------------------------------------------
+// Sets every point in the array to the origin
+// ------------------------------------------------------------------------
+void atPointArray::clear()
+{
+    if (arraySize > 0)
+    {
+        memset(xData, 0, arraySize * sizeof(double));
+        memset(yData, 0, arraySize * sizeof(double));
+        memset(zData, 0, arraySize * sizeof(double));
+    }
+}
+
+// ------------------------------------------------------------------------
+// Changes the number of points in the array. Existing points are kept
+// (up to the new size) and any new points are set to the origin. Memory
+// is only reallocated when the array grows past its current capacity.
+// ------------------------------------------------------------------------
+void atPointArray::setSize(u_long size)
+{
+    double *newX, *newY, *newZ;
+
+    // Grow the storage if we need to
+    if (size > arrayCapacity)
+    {
+        newX = (double *) realloc(xData, size * sizeof(double));
+        if (newX != NULL)
+            xData = newX;
+        newY = (double *) realloc(yData, size * sizeof(double));
+        if (newY != NULL)
+            yData = newY;
+        newZ = (double *) realloc(zData, size * sizeof(double));
+        if (newZ != NULL)
+            zData = newZ;
+
+        // If any of the allocations failed, leave the array as it was
+        // (each array is still at least arrayCapacity long)
+        if ((newX == NULL) || (newY == NULL) || (newZ == NULL))
+        {
+            printf("atPointArray::setSize: Unable to allocate %lu points\n",
+                size);
+            return;
+        }
+
+        arrayCapacity = size;
+    }
+
+    // Clear any points that we're adding to the end of the array
+    if (size > arraySize)
+    {
+        memset(&xData[arraySize], 0, (size - arraySize) * sizeof(double));
+        memset(&yData[arraySize], 0, (size - arraySize) * sizeof(double));
+        memset(&zData[arraySize], 0, (size - arraySize) * sizeof(double));
+    }
+
+    arraySize = size;
+}
+
+// ------------------------------------------------------------------------
+// Returns the number of points in the array
+// ------------------------------------------------------------------------
+u_long atPointArray::getSize() const
+{
+    return arraySize;
+}
+
+// ------------------------------------------------------------------------
+// Sets the point at the given index
+// ------------------------------------------------------------------------
+void atPointArray::setPoint(u_long index, double x, double y, double z)
+{
+    // Bounds checking
+    if (index >= arraySize)
+    {
+        printf("atPointArray::setPoint: Invalid index (%lu)\n", index);
+        return;
+    }
+
+    xData[index] = x;
+    yData[index] = y;
+    zData[index] = z;
+}
+
+// ------------------------------------------------------------------------
+// Sets the point at the given index from the first three elements of the
+// given vector
+// ------------------------------------------------------------------------
+void atPointArray::setPoint(u_long index, const atVector &point)
+{
+    // The point must have at least three coordinates
+    if (point.getSize() < 3)
+    {
+        printf("atPointArray::setPoint: Point vector is too small\n");
+        return;
+    }
+
+    setPoint(index, point.getValue(AT_X), point.getValue(AT_Y),
+        point.getValue(AT_Z));
+}
+
+// ------------------------------------------------------------------------
+// Returns the point at the given index as a size 3 vector
+// ------------------------------------------------------------------------
+atVector atPointArray::getPoint(u_long index) const
+{
+    // Bounds checking
+    if (index >= arraySize)
+    {
+        printf("atPointArray::getPoint: Invalid index (%lu)\n", index);
+        return atVector(0.0, 0.0, 0.0);
+    }
+
+    return atVector(xData[index], yData[index], zData[index]);
+}
+
+// ------------------------------------------------------------------------
+// Direct access to the coordinate arrays (each getSize() elements long).
+// The pointers are invalidated by setSize() and copy().
+// ------------------------------------------------------------------------
+double *atPointArray::getXArray()
+{
+    return xData;
+}
+
+double *atPointArray::getYArray()
+{
+    return yData;
+}
+
+double *atPointArray::getZArray()
+{
+    return zData;
+}
+
+const double *atPointArray::getXArray() const
+{
+    return xData;
+}
+
+const double *atPointArray::getYArray() const
+{
+    return yData;
+}
+
+const double *atPointArray::getZArray() const
+{
+    return zData;
+}
+
+// ------------------------------------------------------------------------
+// Transforms every point in the array by the given matrix, keeping the
+// result. Equivalent to calling atMatrix::getPointXform() on each point.
+// ------------------------------------------------------------------------
+void atPointArray::pointXform(const atMatrix &matrix)
+{
+    getPointXform(matrix, this);
+}
+
+// ------------------------------------------------------------------------
+// Transforms every point in the array by the given matrix, placing the
+// results in the given array (which is resized to match this one).
+// Equivalent to calling atMatrix::getPointXform() on each point.
+// ------------------------------------------------------------------------
+void atPointArray::getPointXform(const atMatrix &matrix,
+                                 atPointArray *result) const
+{
+    double m[12];
+    int i, j;
+
+    // Pull the top three rows out of the matrix (the bottom row doesn't
+    // affect the first three coordinates of the result)
+    for (i = 0; i < 3; i++)
+        for (j = 0; j < 4; j++)
+            m[i*4 + j] = matrix.getValue(i, j);
+
+    // Make sure the result is big enough, then run the transform
+    result->setSize(arraySize);
+    if (result->getSize() != arraySize)
+        return;
+    xformPoints(m, arraySize, xData, yData, zData,
+        result->xData, result->yData, result->zData);
+}
+
+// ------------------------------------------------------------------------
+// Transforms every point in the array by the given matrix, keeping the
+// result, with the work split across the threads of the given task pool
+// ------------------------------------------------------------------------
+void atPointArray::pointXform(const atMatrix &matrix, atTaskPool *pool)
+{
+    getPointXform(matrix, this, pool);
+}
+
+// ------------------------------------------------------------------------
+// Transforms every point in the array by the given matrix, placing the
+// results in the given array, with the work split across the threads of
+// the given task pool
+// ------------------------------------------------------------------------
+void atPointArray::getPointXform(const atMatrix &matrix,
+                                 atPointArray *result,
+                                 atTaskPool *pool) const
+{
+    atPointXformRange body;
+    double m[12];
+    int i, j;
+
+    // Pull the top three rows out of the matrix, as above
+    for (i = 0; i < 3; i++)
+        for (j = 0; j < 4; j++)
+            m[i*4 + j] = matrix.getValue(i, j);
+
+    // Make sure the result is big enough, then let the pool run the
+    // transform on pieces of the arrays
+    result->setSize(arraySize);
+    if (result->getSize() != arraySize)
+        return;
+    body.matrix = m;
+    body.srcX = xData;
+    body.srcY = yData;
+    body.srcZ = zData;
+    body.dstX = result->xData;
+    body.dstY = result->yData;
+    body.dstZ = result->zData;
+    pool->parallelFor(0, arraySize, AT_POINT_ARRAY_GRAIN_SIZE, &body);
+}
+
+// ------------------------------------------------------------------------
+// Transforms every point in the array by the given matrix as direction
+// vectors (ignoring the translation), keeping the result. Equivalent to
+// calling atMatrix::getVectorXform() on each point.
+// ------------------------------------------------------------------------
+void atPointArray::vectorXform(const atMatrix &matrix)
+{
+    getVectorXform(matrix, this);
+}
+
+// ------------------------------------------------------------------------
+// Transforms every point in the array by the given matrix as direction
+// vectors (ignoring the translation), placing the results in the given
+// array. Equivalent to calling atMatrix::getVectorXform() on each point.
+// ------------------------------------------------------------------------
+void atPointArray::getVectorXform(const atMatrix &matrix,
+                                  atPointArray *result) const
+{
+    double m[12];
+    int i, j;
+
+    // Pull the upper-left 3x3 out of the matrix, with the translation
+    // column zeroed out
+    for (i = 0; i < 3; i++)
+    {
+        for (j = 0; j < 3; j++)
+            m[i*4 + j] = matrix.getValue(i, j);
+        m[i*4 + 3] = 0.0;
+    }
+
+    // Make sure the result is big enough, then run the transform
+    result->setSize(arraySize);
+    if (result->getSize() != arraySize)
+        return;
+    xformPoints(m, arraySize, xData, yData, zData,
+        result->xData, result->yData, result->zData);
+}
+
+// ------------------------------------------------------------------------
+// Assignment operator
+// ------------------------------------------------------------------------
+atPointArray &atPointArray::operator=(const atPointArray &source)
+{
+    copy(source);
+    return *this;
+}
+
+// ------------------------------------------------------------------------
+// Print a textual representation of this array to standard output
+// ------------------------------------------------------------------------
+void atPointArray::print() const
+{
+    print(stdout);
+}
+
+// ------------------------------------------------------------------------
+// Print a textual representation of this array to the given file
+// ------------------------------------------------------------------------
+void atPointArray::print(FILE *fp) const
+{
+    u_long i;
+
+    for (i = 0; i < arraySize; i++)
+        fprintf(fp, "<%0.4lf, %0.4lf, %0.4lf>\n", xData[i], yData[i],
+            zData[i]);
+}
+
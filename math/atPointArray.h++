@@ -0,0 +1,99 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AT_POINT_ARRAY_HPP
+#define AT_POINT_ARRAY_HPP
+
+class atPointArray;
+
+#include <stdio.h>
+
+#include "atGlobals.h++"
+#include "atItem.h++"
+#include "atMatrix.h++"
+#include "atOSDefs.h++"
+#include "atVector.h++"
+
+class atTaskPool;
+
+
+class ATLAS_SYM atPointArray : public atItem
+{
+private:
+
+    // Points are stored as a structure of arrays (one array per
+    // coordinate) so that the transform kernels can work on several
+    // points at once
+    double      *xData;
+    double      *yData;
+    double      *zData;
+    u_long      arraySize;
+    u_long      arrayCapacity;
+
+public:
+
+                      atPointArray();
+                      atPointArray(u_long size);
+                      atPointArray(const atPointArray &source);
+    virtual           ~atPointArray();
+
+    void              copy(const atPointArray &source);
+    void              clear();
+
+    void              setSize(u_long size);
+    u_long            getSize() const;
+
+    void              setPoint(u_long index, double x, double y, double z);
+    void              setPoint(u_long index, const atVector &point);
+    atVector          getPoint(u_long index) const;
+
+    double            *getXArray();
+    double            *getYArray();
+    double            *getZArray();
+    const double      *getXArray() const;
+    const double      *getYArray() const;
+    const double      *getZArray() const;
+
+    void              pointXform(const atMatrix &matrix);
+    void              getPointXform(const atMatrix &matrix,
+                                    atPointArray *result) const;
+    void              pointXform(const atMatrix &matrix, atTaskPool *pool);
+    void              getPointXform(const atMatrix &matrix,
+                                    atPointArray *result,
+                                    atTaskPool *pool) const;
+    void              vectorXform(const atMatrix &matrix);
+    void              getVectorXform(const atMatrix &matrix,
+                                     atPointArray *result) const;
+
+    atPointArray      &operator=(const atPointArray &source);
+
+    void              print() const;
+    void              print(FILE *fp) const;
+};
+
+#endif
+
@@ -1379,3 +1379,20 @@ int atQuat::compare(atItem * otherItem)
    }
 }
 
+// ------------------------------------------------------------------------
+// atItem derived method.  Return a hash code for the quaternion that
+// agrees with equals() (which compares elements within the default
+// tolerance)
+// ------------------------------------------------------------------------
+u_long atQuat::getHashCode()
+{
+   u_long hash;
+   int    i;
+
+   // Combine the elements' hash codes
+   hash = 0;
+   for (i = 0; i < 4; i++)
+      hash = hash * 31 + hashDouble(data[i]);
+
+   return hash;
+}
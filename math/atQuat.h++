@@ -124,6 +124,7 @@ public:
 
     virtual bool   equals(atItem * otherItem);
     virtual int    compare(atItem * otherItem);
+    virtual u_long getHashCode();
 };
 
 ATLAS_SYM atQuat operator*(double multiplier, atQuat operand);
@@ -0,0 +1,642 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "atQuatArray.h++"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "atSIMD.h++"
+
+// ------------------------------------------------------------------------
+// Normalizes count quaternions. The source and destination arrays may be
+// the same arrays.
+// ------------------------------------------------------------------------
+static void normalizeQuats(u_long count, const double *srcX,
+                           const double *srcY, const double *srcZ,
+                           const double *srcW, double *dstX, double *dstY,
+                           double *dstZ, double *dstW)
+{
+    u_long i;
+    double mag;
+
+    i = 0;
+
+#if defined(AT_SIMD_AVX)
+    __m256d vx, vy, vz, vw, vmag;
+
+    // Four quaternions per iteration
+    for (; i + 4 <= count; i += 4)
+    {
+        vx = _mm256_loadu_pd(&srcX[i]);
+        vy = _mm256_loadu_pd(&srcY[i]);
+        vz = _mm256_loadu_pd(&srcZ[i]);
+        vw = _mm256_loadu_pd(&srcW[i]);
+
+        vmag = _mm256_sqrt_pd(_mm256_add_pd(
+            _mm256_add_pd(_mm256_mul_pd(vx, vx), _mm256_mul_pd(vy, vy)),
+            _mm256_add_pd(_mm256_mul_pd(vz, vz), _mm256_mul_pd(vw, vw))));
+
+        _mm256_storeu_pd(&dstX[i], _mm256_div_pd(vx, vmag));
+        _mm256_storeu_pd(&dstY[i], _mm256_div_pd(vy, vmag));
+        _mm256_storeu_pd(&dstZ[i], _mm256_div_pd(vz, vmag));
+        _mm256_storeu_pd(&dstW[i], _mm256_div_pd(vw, vmag));
+    }
+#elif defined(AT_SIMD_SSE2)
+    __m128d vx, vy, vz, vw, vmag;
+
+    // Two quaternions per iteration
+    for (; i + 2 <= count; i += 2)
+    {
+        vx = _mm_loadu_pd(&srcX[i]);
+        vy = _mm_loadu_pd(&srcY[i]);
+        vz = _mm_loadu_pd(&srcZ[i]);
+        vw = _mm_loadu_pd(&srcW[i]);
+
+        vmag = _mm_sqrt_pd(_mm_add_pd(
+            _mm_add_pd(_mm_mul_pd(vx, vx), _mm_mul_pd(vy, vy)),
+            _mm_add_pd(_mm_mul_pd(vz, vz), _mm_mul_pd(vw, vw))));
+
+        _mm_storeu_pd(&dstX[i], _mm_div_pd(vx, vmag));
+        _mm_storeu_pd(&dstY[i], _mm_div_pd(vy, vmag));
+        _mm_storeu_pd(&dstZ[i], _mm_div_pd(vz, vmag));
+        _mm_storeu_pd(&dstW[i], _mm_div_pd(vw, vmag));
+    }
+#endif
+
+    // Scalar loop for whatever is left
+    for (; i < count; i++)
+    {
+        mag = sqrt((srcX[i] * srcX[i] + srcY[i] * srcY[i]) +
+                   (srcZ[i] * srcZ[i] + srcW[i] * srcW[i]));
+        dstX[i] = srcX[i] / mag;
+        dstY[i] = srcY[i] / mag;
+        dstZ[i] = srcZ[i] / mag;
+        dstW[i] = srcW[i] / mag;
+    }
+}
+
+// ------------------------------------------------------------------------
+// Default constructor - Creates an empty quaternion array
+// ------------------------------------------------------------------------
+atQuatArray::atQuatArray()
+{
+    xData = NULL;
+    yData = NULL;
+    zData = NULL;
+    wData = NULL;
+    arraySize = 0;
+    arrayCapacity = 0;
+}
+
+// ------------------------------------------------------------------------
+// Size constructor - Creates an array of the given number of quaternions,
+// all cleared to zero
+// ------------------------------------------------------------------------
+atQuatArray::atQuatArray(u_long size)
+{
+    xData = NULL;
+    yData = NULL;
+    zData = NULL;
+    wData = NULL;
+    arraySize = 0;
+    arrayCapacity = 0;
+
+    setSize(size);
+}
+
+// ------------------------------------------------------------------------
+// Copy constructor
+// ------------------------------------------------------------------------
+atQuatArray::atQuatArray(const atQuatArray &source)
+{
+    xData = NULL;
+    yData = NULL;
+    zData = NULL;
+    wData = NULL;
+    arraySize = 0;
+    arrayCapacity = 0;
+
+    copy(source);
+}
+
+// ------------------------------------------------------------------------
+// Destructor
+// ------------------------------------------------------------------------
+atQuatArray::~atQuatArray()
+{
+    free(xData);
+    free(yData);
+    free(zData);
+    free(wData);
+}
+
+// ------------------------------------------------------------------------
+// Makes this array an exact duplicate of the source array
+// ------------------------------------------------------------------------
+void atQuatArray::copy(const atQuatArray &source)
+{
+    // Nothing to do if copying onto ourselves
+    if (this == &source)
+        return;
+
+    // Match the source size, then copy each component array
+    setSize(source.arraySize);
+    if (arraySize == source.arraySize)
+    {
+        memcpy(xData, source.xData, arraySize * sizeof(double));
+        memcpy(yData, source.yData, arraySize * sizeof(double));
+        memcpy(zData, source.zData, arraySize * sizeof(double));
+        memcpy(wData, source.wData, arraySize * sizeof(double));
+    }
+}
+
+// ------------------------------------------------------------------------
+// Clears every quaternion in the array to zero
+// ------------------------------------------------------------------------
+void atQuatArray::clear()
+{
+    if (arraySize > 0)
+    {
+        memset(xData, 0, arraySize * sizeof(double));
+        memset(yData, 0, arraySize * sizeof(double));
+        memset(zData, 0, arraySize * sizeof(double));
+        memset(wData, 0, arraySize * sizeof(double));
+    }
+}
+
+// ------------------------------------------------------------------------
+// Changes the number of quaternions in the array. Existing quaternions
+// are kept (up to the new size) and any new ones are cleared to zero.
+// Memory is only reallocated when the array grows past its current
+// capacity.
+// ------------------------------------------------------------------------
+void atQuatArray::setSize(u_long size)
+{
+    double *newX, *newY, *newZ, *newW;
+
+    // Grow the storage if we need to
+    if (size > arrayCapacity)
+    {
+        newX = (double *) realloc(xData, size * sizeof(double));
+        if (newX != NULL)
+            xData = newX;
+        newY = (double *) realloc(yData, size * sizeof(double));
+        if (newY != NULL)
+            yData = newY;
+        newZ = (double *) realloc(zData, size * sizeof(double));
+        if (newZ != NULL)
+            zData = newZ;
+        newW = (double *) realloc(wData, size * sizeof(double));
+        if (newW != NULL)
+            wData = newW;
+
+        // If any of the allocations failed, leave the array as it was
+        // (each array is still at least arrayCapacity long)
+        if ((newX == NULL) || (newY == NULL) || (newZ == NULL) ||
+            (newW == NULL))
+        {
+            printf("atQuatArray::setSize: Unable to allocate %lu quats\n",
+                size);
+            return;
+        }
+
+        arrayCapacity = size;
+    }
+
+    // Clear any quaternions that we're adding to the end of the array
+    if (size > arraySize)
+    {
+        memset(&xData[arraySize], 0, (size - arraySize) * sizeof(double));
+        memset(&yData[arraySize], 0, (size - arraySize) * sizeof(double));
+        memset(&zData[arraySize], 0, (size - arraySize) * sizeof(double));
+        memset(&wData[arraySize], 0, (size - arraySize) * sizeof(double));
+    }
+
+    arraySize = size;
+}
+
+// ------------------------------------------------------------------------
+// Returns the number of quaternions in the array
+// ------------------------------------------------------------------------
+u_long atQuatArray::getSize() const
+{
+    return arraySize;
+}
+
+// ------------------------------------------------------------------------
+// Sets the quaternion at the given index
+// ------------------------------------------------------------------------
+void atQuatArray::setQuat(u_long index, double x, double y, double z,
+                          double w)
+{
+    // Bounds checking
+    if (index >= arraySize)
+    {
+        printf("atQuatArray::setQuat: Invalid index (%lu)\n", index);
+        return;
+    }
+
+    xData[index] = x;
+    yData[index] = y;
+    zData[index] = z;
+    wData[index] = w;
+}
+
+// ------------------------------------------------------------------------
+// Sets the quaternion at the given index
+// ------------------------------------------------------------------------
+void atQuatArray::setQuat(u_long index, const atQuat &quat)
+{
+    setQuat(index, quat[AT_X], quat[AT_Y], quat[AT_Z], quat[AT_W]);
+}
+
+// ------------------------------------------------------------------------
+// Returns the quaternion at the given index
+// ------------------------------------------------------------------------
+atQuat atQuatArray::getQuat(u_long index) const
+{
+    // Bounds checking
+    if (index >= arraySize)
+    {
+        printf("atQuatArray::getQuat: Invalid index (%lu)\n", index);
+        return atQuat();
+    }
+
+    return atQuat(xData[index], yData[index], zData[index], wData[index]);
+}
+
+// ------------------------------------------------------------------------
+// Direct access to the component arrays (each getSize() elements long).
+// The pointers are invalidated by setSize() and copy().
+// ------------------------------------------------------------------------
+double *atQuatArray::getXArray()
+{
+    return xData;
+}
+
+double *atQuatArray::getYArray()
+{
+    return yData;
+}
+
+double *atQuatArray::getZArray()
+{
+    return zData;
+}
+
+double *atQuatArray::getWArray()
+{
+    return wData;
+}
+
+const double *atQuatArray::getXArray() const
+{
+    return xData;
+}
+
+const double *atQuatArray::getYArray() const
+{
+    return yData;
+}
+
+const double *atQuatArray::getZArray() const
+{
+    return zData;
+}
+
+const double *atQuatArray::getWArray() const
+{
+    return wData;
+}
+
+// ------------------------------------------------------------------------
+// Normalizes every quaternion in the array, keeping the result
+// ------------------------------------------------------------------------
+void atQuatArray::normalize()
+{
+    normalizeQuats(arraySize, xData, yData, zData, wData,
+        xData, yData, zData, wData);
+}
+
+// ------------------------------------------------------------------------
+// Places a normalized copy of every quaternion in the array into the
+// given array (which is resized to match this one)
+// ------------------------------------------------------------------------
+void atQuatArray::getNormalized(atQuatArray *result) const
+{
+    result->setSize(arraySize);
+    if (result->getSize() != arraySize)
+        return;
+    normalizeQuats(arraySize, xData, yData, zData, wData,
+        result->xData, result->yData, result->zData, result->wData);
+}
+
+// ------------------------------------------------------------------------
+// Spherical linear interpolation between each quaternion in this array
+// (as the source) and the corresponding quaternion in the destination
+// array, placing the results in the given result array. Equivalent to
+// calling atQuat::slerp() on each pair. The trigonometry doesn't map
+// onto the vector units, so this runs as a scalar loop over the
+// component arrays.
+// ------------------------------------------------------------------------
+void atQuatArray::slerp(const atQuatArray &destination, double parameter,
+                        atQuatArray *result) const
+{
+    u_long i;
+    double sx, sy, sz, sw, dx, dy, dz, dw;
+    double magSquared, mag, dotProd, theta, sinTheta, q1val, q2val;
+
+    // Bounds checking
+    if ((parameter < 0.0) || (parameter > 1.0))
+    {
+        printf("atQuatArray::slerp: 'parameter' must be in range "
+            "0.0 - 1.0\n");
+        return;
+    }
+    if (destination.arraySize != arraySize)
+    {
+        printf("atQuatArray::slerp: Array sizes do not match\n");
+        return;
+    }
+
+    // Make sure the result is big enough
+    result->setSize(arraySize);
+    if (result->getSize() != arraySize)
+        return;
+
+    for (i = 0; i < arraySize; i++)
+    {
+        sx = xData[i];
+        sy = yData[i];
+        sz = zData[i];
+        sw = wData[i];
+        dx = destination.xData[i];
+        dy = destination.yData[i];
+        dz = destination.zData[i];
+        dw = destination.wData[i];
+
+        // Force both quats to be unit length
+        magSquared = sx*sx + sy*sy + sz*sz + sw*sw;
+        if (!AT_EQUAL(magSquared, 1.0))
+        {
+            mag = sqrt(magSquared);
+            sx /= mag;
+            sy /= mag;
+            sz /= mag;
+            sw /= mag;
+        }
+        magSquared = dx*dx + dy*dy + dz*dz + dw*dw;
+        if (!AT_EQUAL(magSquared, 1.0))
+        {
+            mag = sqrt(magSquared);
+            dx /= mag;
+            dy /= mag;
+            dz /= mag;
+            dw /= mag;
+        }
+
+        // Take the shortest path around the sphere by negating the
+        // destination if the angle between them is over 180 degrees
+        dotProd = sx*dx + sy*dy + sz*dz + sw*dw;
+        if (dotProd < 0.0)
+        {
+            dx = -dx;
+            dy = -dy;
+            dz = -dz;
+            dw = -dw;
+            dotProd = -dotProd;
+        }
+
+        // If the two rotations are the same, the result is the source
+        if (dotProd > (1.0 - AT_DEFAULT_TOLERANCE))
+        {
+            q1val = 1.0;
+            q2val = 0.0;
+        }
+        else
+        {
+            // Scale each quaternion based on the parameter value
+            theta = acos(dotProd);
+            sinTheta = sin(theta);
+            q1val = sin((1.0 - parameter) * theta) / sinTheta;
+            q2val = sin(parameter * theta) / sinTheta;
+        }
+
+        // Combine the two
+        result->xData[i] = sx * q1val + dx * q2val;
+        result->yData[i] = sy * q1val + dy * q2val;
+        result->zData[i] = sz * q1val + dz * q2val;
+        result->wData[i] = sw * q1val + dw * q2val;
+    }
+}
+
+// ------------------------------------------------------------------------
+// Normalized linear interpolation between each quaternion in this array
+// (as the source) and the corresponding quaternion in the destination
+// array, placing the results in the given result array. Equivalent to
+// calling atQuat::nlerp() on each pair.
+// ------------------------------------------------------------------------
+void atQuatArray::nlerp(const atQuatArray &destination, double parameter,
+                        atQuatArray *result) const
+{
+    u_long i;
+    double sx, sy, sz, sw, dx, dy, dz, dw, dotProd;
+
+    // Bounds checking
+    if ((parameter < 0.0) || (parameter > 1.0))
+    {
+        printf("atQuatArray::nlerp: 'parameter' must be in range "
+            "0.0 - 1.0\n");
+        return;
+    }
+    if (destination.arraySize != arraySize)
+    {
+        printf("atQuatArray::nlerp: Array sizes do not match\n");
+        return;
+    }
+
+    // Make sure the result is big enough
+    result->setSize(arraySize);
+    if (result->getSize() != arraySize)
+        return;
+
+    i = 0;
+
+#if defined(AT_SIMD_AVX)
+    __m256d vsx, vsy, vsz, vsw, vdx, vdy, vdz, vdw, vdot, vsign;
+    __m256d vparam = _mm256_set1_pd(parameter);
+    __m256d vzero = _mm256_setzero_pd();
+    __m256d vsignBit = _mm256_set1_pd(-0.0);
+
+    // Four pairs per iteration
+    for (; i + 4 <= arraySize; i += 4)
+    {
+        vsx = _mm256_loadu_pd(&xData[i]);
+        vsy = _mm256_loadu_pd(&yData[i]);
+        vsz = _mm256_loadu_pd(&zData[i]);
+        vsw = _mm256_loadu_pd(&wData[i]);
+        vdx = _mm256_loadu_pd(&destination.xData[i]);
+        vdy = _mm256_loadu_pd(&destination.yData[i]);
+        vdz = _mm256_loadu_pd(&destination.zData[i]);
+        vdw = _mm256_loadu_pd(&destination.wData[i]);
+
+        // Flip the sign of each destination whose dot product with its
+        // source is negative (shortest path)
+        vdot = _mm256_add_pd(
+            _mm256_add_pd(_mm256_mul_pd(vsx, vdx), _mm256_mul_pd(vsy, vdy)),
+            _mm256_add_pd(_mm256_mul_pd(vsz, vdz), _mm256_mul_pd(vsw, vdw)));
+        vsign = _mm256_and_pd(_mm256_cmp_pd(vdot, vzero, _CMP_LT_OQ),
+            vsignBit);
+        vdx = _mm256_xor_pd(vdx, vsign);
+        vdy = _mm256_xor_pd(vdy, vsign);
+        vdz = _mm256_xor_pd(vdz, vsign);
+        vdw = _mm256_xor_pd(vdw, vsign);
+
+        // Linear interpolation on each component (into the destination
+        // registers, which we don't need any more)
+        vdx = _mm256_add_pd(vsx, _mm256_mul_pd(vparam,
+            _mm256_sub_pd(vdx, vsx)));
+        vdy = _mm256_add_pd(vsy, _mm256_mul_pd(vparam,
+            _mm256_sub_pd(vdy, vsy)));
+        vdz = _mm256_add_pd(vsz, _mm256_mul_pd(vparam,
+            _mm256_sub_pd(vdz, vsz)));
+        vdw = _mm256_add_pd(vsw, _mm256_mul_pd(vparam,
+            _mm256_sub_pd(vdw, vsw)));
+
+        _mm256_storeu_pd(&result->xData[i], vdx);
+        _mm256_storeu_pd(&result->yData[i], vdy);
+        _mm256_storeu_pd(&result->zData[i], vdz);
+        _mm256_storeu_pd(&result->wData[i], vdw);
+    }
+#elif defined(AT_SIMD_SSE2)
+    __m128d vsx, vsy, vsz, vsw, vdx, vdy, vdz, vdw, vdot, vsign;
+    __m128d vparam = _mm_set1_pd(parameter);
+    __m128d vzero = _mm_setzero_pd();
+    __m128d vsignBit = _mm_set1_pd(-0.0);
+
+    // Two pairs per iteration
+    for (; i + 2 <= arraySize; i += 2)
+    {
+        vsx = _mm_loadu_pd(&xData[i]);
+        vsy = _mm_loadu_pd(&yData[i]);
+        vsz = _mm_loadu_pd(&zData[i]);
+        vsw = _mm_loadu_pd(&wData[i]);
+        vdx = _mm_loadu_pd(&destination.xData[i]);
+        vdy = _mm_loadu_pd(&destination.yData[i]);
+        vdz = _mm_loadu_pd(&destination.zData[i]);
+        vdw = _mm_loadu_pd(&destination.wData[i]);
+
+        // Flip the sign of each destination whose dot product with its
+        // source is negative (shortest path)
+        vdot = _mm_add_pd(
+            _mm_add_pd(_mm_mul_pd(vsx, vdx), _mm_mul_pd(vsy, vdy)),
+            _mm_add_pd(_mm_mul_pd(vsz, vdz), _mm_mul_pd(vsw, vdw)));
+        vsign = _mm_and_pd(_mm_cmplt_pd(vdot, vzero), vsignBit);
+        vdx = _mm_xor_pd(vdx, vsign);
+        vdy = _mm_xor_pd(vdy, vsign);
+        vdz = _mm_xor_pd(vdz, vsign);
+        vdw = _mm_xor_pd(vdw, vsign);
+
+        // Linear interpolation on each component
+        vdx = _mm_add_pd(vsx, _mm_mul_pd(vparam, _mm_sub_pd(vdx, vsx)));
+        vdy = _mm_add_pd(vsy, _mm_mul_pd(vparam, _mm_sub_pd(vdy, vsy)));
+        vdz = _mm_add_pd(vsz, _mm_mul_pd(vparam, _mm_sub_pd(vdz, vsz)));
+        vdw = _mm_add_pd(vsw, _mm_mul_pd(vparam, _mm_sub_pd(vdw, vsw)));
+
+        _mm_storeu_pd(&result->xData[i], vdx);
+        _mm_storeu_pd(&result->yData[i], vdy);
+        _mm_storeu_pd(&result->zData[i], vdz);
+        _mm_storeu_pd(&result->wData[i], vdw);
+    }
+#endif
+
+    // Scalar loop for whatever is left
+    for (; i < arraySize; i++)
+    {
+        sx = xData[i];
+        sy = yData[i];
+        sz = zData[i];
+        sw = wData[i];
+        dx = destination.xData[i];
+        dy = destination.yData[i];
+        dz = destination.zData[i];
+        dw = destination.wData[i];
+
+        // Shortest path
+        dotProd = (sx*dx + sy*dy) + (sz*dz + sw*dw);
+        if (dotProd < 0.0)
+        {
+            dx = -dx;
+            dy = -dy;
+            dz = -dz;
+            dw = -dw;
+        }
+
+        // Linear interpolation on each component
+        result->xData[i] = sx + parameter * (dx - sx);
+        result->yData[i] = sy + parameter * (dy - sy);
+        result->zData[i] = sz + parameter * (dz - sz);
+        result->wData[i] = sw + parameter * (dw - sw);
+    }
+
+    // Normalize all of the results in one pass
+    normalizeQuats(arraySize, result->xData, result->yData, result->zData,
+        result->wData, result->xData, result->yData, result->zData,
+        result->wData);
+}
+
+// ------------------------------------------------------------------------
+// Assignment operator
+// ------------------------------------------------------------------------
+atQuatArray &atQuatArray::operator=(const atQuatArray &source)
+{
+    copy(source);
+    return *this;
+}
+
+// ------------------------------------------------------------------------
+// Print a textual representation of this array to standard output
+// ------------------------------------------------------------------------
+void atQuatArray::print() const
+{
+    print(stdout);
+}
+
+// ------------------------------------------------------------------------
+// Print a textual representation of this array to the given file
+// ------------------------------------------------------------------------
+void atQuatArray::print(FILE *fp) const
+{
+    u_long i;
+
+    for (i = 0; i < arraySize; i++)
+        fprintf(fp, "<%0.4lf, %0.4lf, %0.4lf, %0.4lf>\n", xData[i],
+            yData[i], zData[i], wData[i]);
+}
+
@@ -0,0 +1,97 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AT_QUAT_ARRAY_HPP
+#define AT_QUAT_ARRAY_HPP
+
+class atQuatArray;
+
+#include <stdio.h>
+
+#include "atGlobals.h++"
+#include "atItem.h++"
+#include "atOSDefs.h++"
+#include "atQuat.h++"
+
+
+class ATLAS_SYM atQuatArray : public atItem
+{
+private:
+
+    // Quaternions are stored as a structure of arrays (one array per
+    // component, vector portion first, as in atQuat) so that the kernels
+    // can work on several quaternions at once
+    double      *xData;
+    double      *yData;
+    double      *zData;
+    double      *wData;
+    u_long      arraySize;
+    u_long      arrayCapacity;
+
+public:
+
+                     atQuatArray();
+                     atQuatArray(u_long size);
+                     atQuatArray(const atQuatArray &source);
+    virtual          ~atQuatArray();
+
+    void             copy(const atQuatArray &source);
+    void             clear();
+
+    void             setSize(u_long size);
+    u_long           getSize() const;
+
+    void             setQuat(u_long index, double x, double y, double z,
+                             double w);
+    void             setQuat(u_long index, const atQuat &quat);
+    atQuat           getQuat(u_long index) const;
+
+    double           *getXArray();
+    double           *getYArray();
+    double           *getZArray();
+    double           *getWArray();
+    const double     *getXArray() const;
+    const double     *getYArray() const;
+    const double     *getZArray() const;
+    const double     *getWArray() const;
+
+    void             normalize();
+    void             getNormalized(atQuatArray *result) const;
+
+    void             slerp(const atQuatArray &destination, double parameter,
+                           atQuatArray *result) const;
+    void             nlerp(const atQuatArray &destination, double parameter,
+                           atQuatArray *result) const;
+
+    atQuatArray      &operator=(const atQuatArray &source);
+
+    void             print() const;
+    void             print(FILE *fp) const;
+};
+
+#endif
+
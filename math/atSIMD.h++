@@ -0,0 +1,51 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AT_SIMD_HPP
+#define AT_SIMD_HPP
+
+
+// Selects the vector instruction set used by the batch math kernels
+// (atPointArray, atQuatArray and atMatrixArray).  AVX is only used when
+// the compiler is told to target it (e.g. -mavx, or enableAVX=yes in the
+// SConstruct); SSE2 is always available on 64-bit x86.  Every other
+// platform (or a build with AT_SIMD_DISABLED defined) uses the scalar
+// loops.
+#if defined(AT_SIMD_DISABLED)
+   // No vector kernels
+#elif defined(__AVX__)
+   #include <immintrin.h>
+   #define AT_SIMD_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || \
+      (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+   #include <emmintrin.h>
+   #define AT_SIMD_SSE2
+#endif
+
+
+#endif
+
@@ -996,3 +996,20 @@ int atVector::compare(atItem * otherItem)
       return atItem::compare(otherItem);
    }
 }
+
+// ------------------------------------------------------------------------
+// atItem derived method.  Return a hash code for the vector that agrees
+// with equals() (which compares elements within the default tolerance)
+// ------------------------------------------------------------------------
+u_long atVector::getHashCode()
+{
+   u_long hash;
+   int    i;
+
+   // Combine the size with each element's hash code
+   hash = vecSize;
+   for (i = 0; i < vecSize; i++)
+      hash = hash * 31 + hashDouble(data[i]);
+
+   return hash;
+}
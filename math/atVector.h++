@@ -104,6 +104,7 @@ public:
 
     virtual bool    equals(atItem * otherItem);
     virtual int     compare(atItem * otherItem);
+    virtual u_long  getHashCode();
 };
 
 ATLAS_SYM atVector operator*(double multiplier, atVector operand);
@@ -0,0 +1,119 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// WaitOnAddress() needs Windows 8 or later, so ask for it before any of
+// the system headers are included
+#if defined(_MSC_VER) && !defined(_WIN32_WINNT)
+   #define _WIN32_WINNT   0x0602
+#endif
+
+#include "atAtomic.h++"
+
+
+#if defined(__linux__) || defined(__ANDROID__)
+   #include <time.h>
+   #include <unistd.h>
+   #include <sys/syscall.h>
+   #include <linux/futex.h>
+
+   void atomicWait(atAtomic * value, uint32_t expected, 
+                   u_long timeoutMicrosecs)
+   {
+      struct timespec   timeout;
+
+      // Wait on the futex (we don't use the "private" futex operations
+      // because the word may be in memory shared with another process).
+      // The kernel checks the value again before sleeping, so a wake that
+      // happens between our caller's check and this call isn't lost.
+      if (timeoutMicrosecs == 0)
+      {
+         syscall(SYS_futex, value, FUTEX_WAIT, expected, NULL, NULL, 0);
+      }
+      else
+      {
+         timeout.tv_sec = timeoutMicrosecs / 1000000;
+         timeout.tv_nsec = (timeoutMicrosecs % 1000000) * 1000;
+         syscall(SYS_futex, value, FUTEX_WAIT, expected, &timeout, NULL, 0);
+      }
+   }
+
+
+   void atomicWake(atAtomic * value)
+   {
+      // Wake everybody waiting on this word
+      syscall(SYS_futex, value, FUTEX_WAKE, 0x7fffffff, NULL, NULL, 0);
+   }
+#else
+   #include "atTime.h++"
+
+   #ifdef _MSC_VER
+      #define WIN32_LEAN_AND_MEAN
+      #include <windows.h>
+   #else
+      #include <unistd.h>
+   #endif
+
+   // How long to sleep between checks of the word when polling
+   #define AT_ATOMIC_POLL_USECS   100
+
+   void atomicWait(atAtomic * value, uint32_t expected, 
+                   u_long timeoutMicrosecs)
+   {
+      uint64_t   start;
+
+      // No futex here, so keep checking the word until it changes or we
+      // time out (timing against the monotonic clock, since the sleeps
+      // below can take much longer than asked for)
+      start = getMonotonicTime();
+      while ((atomicLoad(value) == expected) &&
+             ((timeoutMicrosecs == 0) ||
+              ((getMonotonicTime() - start) / 1000 < timeoutMicrosecs)))
+      {
+         #ifdef _MSC_VER
+            // WaitOnAddress() returns as soon as a thread in this process
+            // wakes the word, but a wake from another process can't reach
+            // it, so only wait a millisecond (its shortest wait) at a time
+            WaitOnAddress(value, &expected, sizeof(expected), 1);
+         #else
+            usleep(AT_ATOMIC_POLL_USECS);
+         #endif
+      }
+   }
+
+
+   void atomicWake(atAtomic * value)
+   {
+      #ifdef _MSC_VER
+         // Wake the threads in this process waiting on the word (any in
+         // other processes will see the change on their next check)
+         WakeByAddressAll((PVOID ) value);
+      #else
+         // Nothing to do; waiters are polling
+      #endif
+   }
+#endif
+
@@ -0,0 +1,198 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AT_ATOMIC_H
+#define AT_ATOMIC_H
+
+
+#include <sys/types.h>
+#include "atIntTypes.h++"
+#include "atSymbols.h++"
+
+
+// Atomic operations on 32-bit words.  These are safe to use on memory
+// shared between processes as well as between threads.  Loads have
+// acquire semantics and stores have release semantics, which is what
+// the lock-free queues need to publish data from one side to the other.
+// The 64-bit loads and stores (for counters that one thread updates and
+// others read) are only atomic; they don't order anything else.
+#ifdef _MSC_VER
+   #define WIN32_LEAN_AND_MEAN
+   #include <windows.h>
+   #include <intrin.h>
+
+   typedef volatile uint32_t   atAtomic;
+
+   static inline uint32_t atomicLoad(atAtomic * value)
+   {
+      uint32_t   result;
+
+      // Volatile reads on x86/x64 have acquire semantics; the barrier
+      // keeps the compiler from moving anything above the read
+      result = *value;
+      _ReadWriteBarrier();
+      return result;
+   }
+
+   static inline void atomicStore(atAtomic * value, uint32_t newValue)
+   {
+      // Volatile writes on x86/x64 have release semantics
+      _ReadWriteBarrier();
+      *value = newValue;
+   }
+
+   static inline uint32_t atomicAdd(atAtomic * value, uint32_t amount)
+   {
+      // Return the value before the addition
+      return (uint32_t ) InterlockedExchangeAdd((volatile LONG *) value, 
+                                                (LONG ) amount);
+   }
+
+   static inline bool atomicCompareAndSwap(atAtomic * value, 
+                                           uint32_t expected,
+                                           uint32_t newValue)
+   {
+      return (InterlockedCompareExchange((volatile LONG *) value,
+                                         (LONG ) newValue,
+                                         (LONG ) expected) ==
+              (LONG ) expected);
+   }
+
+   static inline void atomicFence()
+   {
+      MemoryBarrier();
+   }
+
+   static inline void atomicPause()
+   {
+      YieldProcessor();
+   }
+
+   typedef volatile uint64_t   atAtomic64;
+
+   static inline uint64_t atomicLoad64(atAtomic64 * value)
+   {
+      #ifdef _WIN64
+         // Aligned 64-bit reads are atomic on x64
+         return *value;
+      #else
+         // A compare-and-swap that never changes anything reads all 64
+         // bits at once
+         return (uint64_t ) InterlockedCompareExchange64(
+            (volatile LONG64 *) value, 0, 0);
+      #endif
+   }
+
+   static inline void atomicStore64(atAtomic64 * value, uint64_t newValue)
+   {
+      #ifdef _WIN64
+         // Aligned 64-bit writes are atomic on x64
+         *value = newValue;
+      #else
+         InterlockedExchange64((volatile LONG64 *) value, 
+                               (LONG64 ) newValue);
+      #endif
+   }
+#else
+   typedef volatile uint32_t   atAtomic;
+
+   static inline uint32_t atomicLoad(atAtomic * value)
+   {
+      return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+   }
+
+   static inline void atomicStore(atAtomic * value, uint32_t newValue)
+   {
+      __atomic_store_n(value, newValue, __ATOMIC_RELEASE);
+   }
+
+   static inline uint32_t atomicAdd(atAtomic * value, uint32_t amount)
+   {
+      // Return the value before the addition
+      return __atomic_fetch_add(value, amount, __ATOMIC_ACQ_REL);
+   }
+
+   static inline bool atomicCompareAndSwap(atAtomic * value, 
+                                           uint32_t expected,
+                                           uint32_t newValue)
+   {
+      return __atomic_compare_exchange_n(value, &expected, newValue, false,
+                                         __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+   }
+
+   static inline void atomicFence()
+   {
+      __atomic_thread_fence(__ATOMIC_SEQ_CST);
+   }
+
+   static inline void atomicPause()
+   {
+      #if defined(__i386__) || defined(__x86_64__)
+         __builtin_ia32_pause();
+      #endif
+   }
+
+   // 32-bit targets only align 64-bit values to 4 bytes in structures,
+   // which isn't enough to access them atomically
+   typedef volatile uint64_t   atAtomic64 __attribute__((aligned(8)));
+
+   static inline uint64_t atomicLoad64(atAtomic64 * value)
+   {
+      return __atomic_load_n(value, __ATOMIC_RELAXED);
+   }
+
+   static inline void atomicStore64(atAtomic64 * value, uint64_t newValue)
+   {
+      __atomic_store_n(value, newValue, __ATOMIC_RELAXED);
+   }
+#endif
+
+
+// Blocks the caller while the given word still holds the expected value,
+// for at most the given number of microseconds (zero waits forever).
+// Returns as soon as another thread or process calls atomicWake() on the
+// same word.  Under Linux (and Android) this is a futex, so a waiter
+// costs nothing until it is woken.  Under Windows it uses WaitOnAddress(),
+// which is only woken from the same process (a wake from another process
+// is noticed within a millisecond or so); elsewhere it falls back to
+// polling.
+#ifdef __cplusplus
+   extern "C"
+   {
+      ATLAS_SYM void   atomicWait(atAtomic * value, uint32_t expected,
+                                  u_long timeoutMicrosecs);
+      ATLAS_SYM void   atomicWake(atAtomic * value);
+   }
+#else
+   ATLAS_SYM void   atomicWait(atAtomic * value, uint32_t expected,
+                               u_long timeoutMicrosecs);
+   ATLAS_SYM void   atomicWake(atAtomic * value);
+#endif
+
+
+#endif
+
@@ -315,6 +315,62 @@ static char *   atPersonalPaths[AT_FILE_NUM_PERSONAL_PATHS] = { 0 };
       return atPersonalPaths[key];
    }
 
+
+   bool mapFile(char * path, char ** data, u_long * size)
+   {
+      HANDLE          file;
+      HANDLE          mapping;
+      LARGE_INTEGER   fileSize;
+
+      // Nothing mapped yet
+      *data = NULL;
+      *size = 0;
+
+      // Open the file and find out how big it is
+      file = CreateFile(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+      if (file == INVALID_HANDLE_VALUE)
+         return false;
+      if ((!GetFileSizeEx(file, &fileSize)) ||
+          (fileSize.QuadPart > (LONGLONG ) ((u_long ) -1)))
+      {
+         CloseHandle(file);
+         return false;
+      }
+
+      // Empty files can't be mapped, but there's nothing to map anyway
+      if (fileSize.QuadPart == 0)
+      {
+         CloseHandle(file);
+         return true;
+      }
+
+      // Map the file copy-on-write (the view keeps the file open, so we
+      // can close the handles once it's mapped)
+      mapping = CreateFileMapping(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+      if (mapping != NULL)
+      {
+         *data = (char *) MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+         CloseHandle(mapping);
+      }
+      CloseHandle(file);
+
+      // Return the mapping if it worked
+      if (*data == NULL)
+         return false;
+      *size = (u_long ) fileSize.QuadPart;
+      return true;
+   }
+
+
+   void unmapFile(char * data, u_long size)
+   {
+      // Release the view (if there is one)
+      if (data != NULL)
+         UnmapViewOfFile(data);
+   }
+
+
 #else
 
    #include <glob.h>
@@ -322,7 +378,9 @@ static char *   atPersonalPaths[AT_FILE_NUM_PERSONAL_PATHS] = { 0 };
    #include <stdio.h>
    #include <stdlib.h>
    #include <string.h>
+   #include <fcntl.h>
    #include <unistd.h>
+   #include <sys/mman.h>
    #include <sys/stat.h>
    #include <sys/types.h>
 
@@ -644,5 +702,55 @@ static char *   atPersonalPaths[AT_FILE_NUM_PERSONAL_PATHS] = { 0 };
    }
 
 
+   bool mapFile(char * path, char ** data, u_long * size)
+   {
+      struct stat   fileStat;
+      void *        mapping;
+      int           fd;
+
+      // Nothing mapped yet
+      *data = NULL;
+      *size = 0;
+
+      // Open the file and find out how big it is
+      fd = open(path, O_RDONLY);
+      if (fd < 0)
+         return false;
+      if ((fstat(fd, &fileStat) != 0) || (!S_ISREG(fileStat.st_mode)))
+      {
+         close(fd);
+         return false;
+      }
+
+      // Empty files can't be mapped, but there's nothing to map anyway
+      if (fileStat.st_size == 0)
+      {
+         close(fd);
+         return true;
+      }
+
+      // Map the file privately, so any changes stay in our copy (the
+      // mapping keeps the file open, so we can close it once it's mapped)
+      mapping = mmap(NULL, fileStat.st_size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE, fd, 0);
+      close(fd);
+
+      // Return the mapping if it worked
+      if (mapping == MAP_FAILED)
+         return false;
+      *data = (char *) mapping;
+      *size = (u_long ) fileStat.st_size;
+      return true;
+   }
+
+
+   void unmapFile(char * data, u_long size)
+   {
+      // Release the mapping (if there is one)
+      if (data != NULL)
+         munmap(data, size);
+   }
+
+
 #endif
 
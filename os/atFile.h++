@@ -37,6 +37,7 @@
 #ifdef _MSC_VER
    #include <direct.h>
    #include <io.h>
+   #include <winsock2.h>
 
    #define chdir    _chdir
    #define access   _access
@@ -51,6 +52,7 @@
    #define EXEC_EXTENSION        ".exe"
    #define ICON_EXTENSION        ".ico"
 #elif __ANDROID__
+   #include <sys/types.h>
    #include <unistd.h>
 
    #define DIRECTORY_SEPARATOR   '/'
@@ -60,6 +62,7 @@
    #define EXEC_EXTENSION        ""
    #define ICON_EXTENSION        ".png"
 #else
+   #include <sys/types.h>
    #include <unistd.h>
 
    #define DIRECTORY_SEPARATOR   '/'
@@ -85,6 +88,10 @@ enum atPersonalPathKey
 };
 
 
+// mapFile() maps a whole file into memory for reading.  The mapping is
+// copy-on-write, so the memory can be changed without the changes ever
+// reaching the file.  An empty file maps to a NULL pointer with a size of
+// zero.  Use unmapFile() to release it
 #ifdef __cplusplus
    extern "C"
    {
@@ -92,12 +99,16 @@ enum atPersonalPathKey
       ATLAS_SYM bool     createDirectory(char * path);
       ATLAS_SYM int      listFiles(char * path, char ** results, int count);
       ATLAS_SYM char *   getPersonalPath(atPersonalPathKey key);
+      ATLAS_SYM bool     mapFile(char * path, char ** data, u_long * size);
+      ATLAS_SYM void     unmapFile(char * data, u_long size);
    }
 #else
    ATLAS_SYM bool     isDirectory(char * path);
    ATLAS_SYM bool     createDirectory(char * path);
    ATLAS_SYM int      listFiles(char * path, char ** results, int count);
    ATLAS_SYM char *   getPersonalPath(atPersonalPathKey key);
+   ATLAS_SYM bool     mapFile(char * path, char ** data, u_long * size);
+   ATLAS_SYM void     unmapFile(char * data, u_long size);
 #endif
 
 
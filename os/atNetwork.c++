@@ -149,3 +149,168 @@
    }
 #endif
 
+
+#if defined(__linux__) && !defined(__ANDROID__)
+   // Number of packets handed to the kernel per recvmmsg()/sendmmsg()
+   #define AT_NET_PACKET_BATCH   64
+
+   int receivePackets(Socket socket, SocketPacket * packets, int count)
+   {
+      struct mmsghdr   headers[AT_NET_PACKET_BATCH];
+      struct iovec     vectors[AT_NET_PACKET_BATCH];
+      int              total;
+      int              batch;
+      int              received;
+      int              flags;
+      int              i;
+
+      // Receive in batches.  The first call waits for a packet if the
+      // socket is blocking (MSG_WAITFORONE stops it waiting after that),
+      // and later calls only pick up what's already queued
+      total = 0;
+      flags = MSG_WAITFORONE;
+      while (total < count)
+      {
+         // Point the kernel at the next group of slots
+         batch = count - total;
+         if (batch > AT_NET_PACKET_BATCH)
+            batch = AT_NET_PACKET_BATCH;
+         memset(headers, 0, batch * sizeof(struct mmsghdr));
+         for (i = 0; i < batch; i++)
+         {
+            vectors[i].iov_base = packets[total + i].buffer;
+            vectors[i].iov_len = packets[total + i].capacity;
+            headers[i].msg_hdr.msg_iov = &vectors[i];
+            headers[i].msg_hdr.msg_iovlen = 1;
+            headers[i].msg_hdr.msg_name = &packets[total + i].address;
+            headers[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+         }
+
+         // Get whatever is there (an error after we already have some
+         // packets just means there's nothing more to get)
+         received = recvmmsg(socket, headers, batch, flags, NULL);
+         if (received <= 0)
+            return (total > 0) ? total : received;
+
+         // Record the packet lengths
+         for (i = 0; i < received; i++)
+            packets[total + i].length = headers[i].msg_len;
+         total += received;
+
+         // Stop if the socket ran dry, otherwise keep going without
+         // waiting
+         if (received < batch)
+            break;
+         flags = MSG_DONTWAIT;
+      }
+
+      return total;
+   }
+
+
+   int sendPackets(Socket socket, SocketPacket * packets, int count,
+                   struct sockaddr_in * defaultAddress)
+   {
+      struct mmsghdr   headers[AT_NET_PACKET_BATCH];
+      struct iovec     vectors[AT_NET_PACKET_BATCH];
+      int              total;
+      int              batch;
+      int              sent;
+      int              i;
+
+      // Send in batches
+      total = 0;
+      while (total < count)
+      {
+         // Describe the next group of packets
+         batch = count - total;
+         if (batch > AT_NET_PACKET_BATCH)
+            batch = AT_NET_PACKET_BATCH;
+         memset(headers, 0, batch * sizeof(struct mmsghdr));
+         for (i = 0; i < batch; i++)
+         {
+            vectors[i].iov_base = packets[total + i].buffer;
+            vectors[i].iov_len = packets[total + i].length;
+            headers[i].msg_hdr.msg_iov = &vectors[i];
+            headers[i].msg_hdr.msg_iovlen = 1;
+            if (packets[total + i].address.sin_family != 0)
+               headers[i].msg_hdr.msg_name = &packets[total + i].address;
+            else
+               headers[i].msg_hdr.msg_name = defaultAddress;
+            headers[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+         }
+
+         // Send them (stop at the first packet that couldn't go)
+         sent = sendmmsg(socket, headers, batch, 0);
+         if (sent <= 0)
+            return (total > 0) ? total : sent;
+         total += sent;
+         if (sent < batch)
+            break;
+      }
+
+      return total;
+   }
+#else
+   static bool isReadable(Socket socket)
+   {
+      fd_set           readFds;
+      struct timeval   timeout;
+
+      // Poll the socket without waiting
+      FD_ZERO(&readFds);
+      FD_SET(socket, &readFds);
+      timeout.tv_sec = 0;
+      timeout.tv_usec = 0;
+      return (select(socket + 1, &readFds, NULL, NULL, &timeout) > 0);
+   }
+
+
+   int receivePackets(Socket socket, SocketPacket * packets, int count)
+   {
+      socklen_t   addressLength;
+      int         received;
+      int         total;
+
+      // No batched call here, so receive one packet at a time.  Only the
+      // first one may wait (if the socket is blocking)
+      total = 0;
+      while ((total < count) && ((total == 0) || (isReadable(socket))))
+      {
+         addressLength = sizeof(struct sockaddr_in);
+         received = recvfrom(socket, (char *) packets[total].buffer,
+                             packets[total].capacity, 0,
+                             (struct sockaddr *) &packets[total].address,
+                             &addressLength);
+         if (received < 0)
+            return (total > 0) ? total : received;
+         packets[total].length = received;
+         total++;
+      }
+
+      return total;
+   }
+
+
+   int sendPackets(Socket socket, SocketPacket * packets, int count,
+                   struct sockaddr_in * defaultAddress)
+   {
+      struct sockaddr_in *   address;
+      int                    total;
+
+      // Send one packet at a time
+      for (total = 0; total < count; total++)
+      {
+         if (packets[total].address.sin_family != 0)
+            address = &packets[total].address;
+         else
+            address = defaultAddress;
+         if (sendto(socket, (const char *) packets[total].buffer,
+                    packets[total].length, 0, (struct sockaddr *) address,
+                    sizeof(struct sockaddr_in)) < 0)
+            return (total > 0) ? total : -1;
+      }
+
+      return total;
+   }
+#endif
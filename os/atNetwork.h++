@@ -107,6 +107,19 @@
 #endif
 
 
+// One datagram slot for the batched send and receive calls.  On receive,
+// the buffer is filled (up to its capacity) and the length and sender's
+// address are set; on send, the first length bytes go to the address
+// (or to the default address, if this one's family is zero)
+typedef struct
+{
+   u_char *             buffer;
+   u_long               capacity;
+   u_long               length;
+   struct sockaddr_in   address;
+} SocketPacket;
+
+
 #ifdef __cplusplus
    extern "C"
    {
@@ -122,6 +135,12 @@
       ATLAS_SYM const char *   netAddrToStr(int family, void * src, 
                                             char * dst, int dstLen);
       ATLAS_SYM int            strToNetAddr(int family, char * src, void * dst);
+
+      ATLAS_SYM int   receivePackets(Socket socket, SocketPacket * packets,
+                                     int count);
+      ATLAS_SYM int   sendPackets(Socket socket, SocketPacket * packets,
+                                  int count, 
+                                  struct sockaddr_in * defaultAddress);
    }
 #else
    ATLAS_SYM void   initNetwork();
@@ -136,6 +155,11 @@
    ATLAS_SYM const char *   netAddrToStr(int family, void * src, 
                                          char * dst, int dstLen);
    ATLAS_SYM int            strToNetAddr(int family, char * src, void * dst);
+
+   ATLAS_SYM int   receivePackets(Socket socket, SocketPacket * packets,
+                                  int count);
+   ATLAS_SYM int   sendPackets(Socket socket, SocketPacket * packets,
+                               int count, struct sockaddr_in * defaultAddress);
 #endif
 
 
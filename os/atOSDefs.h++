@@ -39,6 +39,7 @@
 #if defined(__AT_BLUETOOTH_ENABLED__)
 #include "atBluetooth.h++"
 #endif
+#include "atAtomic.h++"
 #include "atByteSwap.h++"
 #include "atDynamic.h++"
 #include "atErrno.h++"
@@ -47,6 +48,7 @@
 #include "atIntTypes.h++"
 #include "atLang.h++"
 #include "atNetwork.h++"
+#include "atPoll.h++"
 #include "atSem.h++"
 #include "atShm.h++"
 #include "atSleep.h++"
@@ -0,0 +1,312 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <stdlib.h>
+#include "atPoll.h++"
+
+
+#if defined(__linux__) || defined(__ANDROID__)
+   #include <sys/epoll.h>
+
+   struct atPollSet
+   {
+      int                    epoll_fd;
+      struct epoll_event *   ready_events;
+      int                    ready_capacity;
+   };
+
+
+   static uint32_t toEpollEvents(u_long events)
+   {
+      uint32_t   epollEvents;
+
+      // Translate our flags into epoll's (errors and hang-ups are always
+      // reported by epoll so there's nothing to ask for there)
+      epollEvents = 0;
+      if (events & AT_POLL_READ)
+         epollEvents |= EPOLLIN;
+      if (events & AT_POLL_WRITE)
+         epollEvents |= EPOLLOUT;
+
+      return epollEvents;
+   }
+
+
+   atPollSet * pollSetCreate()
+   {
+      atPollSet *   set;
+
+      // Create the epoll instance
+      set = (atPollSet *) calloc(1, sizeof(atPollSet));
+      set->epoll_fd = epoll_create(64);
+      if (set->epoll_fd < 0)
+      {
+         free(set);
+         return NULL;
+      }
+
+      return set;
+   }
+
+
+   void pollSetDestroy(atPollSet * set)
+   {
+      // Close the epoll instance and free our event space
+      close(set->epoll_fd);
+      free(set->ready_events);
+      free(set);
+   }
+
+
+   bool pollSetAdd(atPollSet * set, Socket socket, int id, u_long events)
+   {
+      struct epoll_event   event;
+
+      // Register the socket
+      memset(&event, 0, sizeof(event));
+      event.events = toEpollEvents(events);
+      event.data.u64 = 0;
+      event.data.fd = id;
+      return (epoll_ctl(set->epoll_fd, EPOLL_CTL_ADD, socket, &event) == 0);
+   }
+
+
+   bool pollSetModify(atPollSet * set, Socket socket, int id, u_long events)
+   {
+      struct epoll_event   event;
+
+      // Change what we're waiting for on the socket
+      memset(&event, 0, sizeof(event));
+      event.events = toEpollEvents(events);
+      event.data.u64 = 0;
+      event.data.fd = id;
+      return (epoll_ctl(set->epoll_fd, EPOLL_CTL_MOD, socket, &event) == 0);
+   }
+
+
+   void pollSetRemove(atPollSet * set, Socket socket)
+   {
+      struct epoll_event   event;
+
+      // Unregister the socket (older kernels want a non-NULL event even
+      // though it's ignored)
+      memset(&event, 0, sizeof(event));
+      epoll_ctl(set->epoll_fd, EPOLL_CTL_DEL, socket, &event);
+   }
+
+
+   int pollSetWait(atPollSet * set, atPollEvent * events, int maxEvents,
+                   int timeoutMillisecs)
+   {
+      int   count;
+      int   i;
+
+      // Make sure we have room for the kernel to report into
+      if (maxEvents > set->ready_capacity)
+      {
+         set->ready_events = (struct epoll_event *) 
+            realloc(set->ready_events, maxEvents * sizeof(struct epoll_event));
+         set->ready_capacity = maxEvents;
+      }
+
+      // Wait for something to happen (a signal interrupting us just means
+      // nothing is ready yet)
+      count = epoll_wait(set->epoll_fd, set->ready_events, maxEvents,
+                         timeoutMillisecs);
+      if (count < 0)
+         return (errno == EINTR) ? 0 : -1;
+
+      // Translate the results
+      for (i = 0; i < count; i++)
+      {
+         events[i].id = set->ready_events[i].data.fd;
+         events[i].events = 0;
+         if (set->ready_events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP))
+            events[i].events |= AT_POLL_READ;
+         if (set->ready_events[i].events & EPOLLOUT)
+            events[i].events |= AT_POLL_WRITE;
+         if (set->ready_events[i].events & (EPOLLERR | EPOLLHUP))
+            events[i].events |= AT_POLL_ERROR;
+      }
+
+      return count;
+   }
+#else
+   typedef struct
+   {
+      Socket   socket;
+      int      id;
+      u_long   events;
+   } atPollEntry;
+
+   struct atPollSet
+   {
+      atPollEntry *   entries;
+      int             num_entries;
+      int             entry_capacity;
+   };
+
+
+   static int findEntry(atPollSet * set, Socket socket)
+   {
+      int   i;
+
+      // Search for the socket
+      for (i = 0; i < set->num_entries; i++)
+         if (set->entries[i].socket == socket)
+            return i;
+
+      return -1;
+   }
+
+
+   atPollSet * pollSetCreate()
+   {
+      // Nothing to set up beyond an empty list of sockets
+      return (atPollSet *) calloc(1, sizeof(atPollSet));
+   }
+
+
+   void pollSetDestroy(atPollSet * set)
+   {
+      free(set->entries);
+      free(set);
+   }
+
+
+   bool pollSetAdd(atPollSet * set, Socket socket, int id, u_long events)
+   {
+      // Select can't handle sockets beyond its set size (this limit
+      // doesn't apply to Winsock, which counts sockets instead)
+      #ifndef _MSC_VER
+         if (socket >= FD_SETSIZE)
+            return false;
+      #endif
+      if (set->num_entries >= FD_SETSIZE)
+         return false;
+
+      // Grow the list if we need to
+      if (set->num_entries == set->entry_capacity)
+      {
+         set->entry_capacity = (set->entry_capacity == 0) ? 
+            64 : set->entry_capacity * 2;
+         set->entries = (atPollEntry *) 
+            realloc(set->entries, set->entry_capacity * sizeof(atPollEntry));
+      }
+
+      // Add the socket
+      set->entries[set->num_entries].socket = socket;
+      set->entries[set->num_entries].id = id;
+      set->entries[set->num_entries].events = events;
+      set->num_entries++;
+      return true;
+   }
+
+
+   bool pollSetModify(atPollSet * set, Socket socket, int id, u_long events)
+   {
+      int   index;
+
+      // Find and update the socket's entry
+      index = findEntry(set, socket);
+      if (index < 0)
+         return false;
+      set->entries[index].id = id;
+      set->entries[index].events = events;
+      return true;
+   }
+
+
+   void pollSetRemove(atPollSet * set, Socket socket)
+   {
+      int   index;
+
+      // Move the last entry into the removed one's place
+      index = findEntry(set, socket);
+      if (index >= 0)
+      {
+         set->num_entries--;
+         set->entries[index] = set->entries[set->num_entries];
+      }
+   }
+
+
+   int pollSetWait(atPollSet * set, atPollEvent * events, int maxEvents,
+                   int timeoutMillisecs)
+   {
+      fd_set           readFds;
+      fd_set           writeFds;
+      fd_set           errorFds;
+      struct timeval   timeout;
+      Socket           maxSocket;
+      int              count;
+      int              i;
+
+      // Build up the sets of sockets to check
+      FD_ZERO(&readFds);
+      FD_ZERO(&writeFds);
+      FD_ZERO(&errorFds);
+      maxSocket = 0;
+      for (i = 0; i < set->num_entries; i++)
+      {
+         if (set->entries[i].events & AT_POLL_READ)
+            FD_SET(set->entries[i].socket, &readFds);
+         if (set->entries[i].events & AT_POLL_WRITE)
+            FD_SET(set->entries[i].socket, &writeFds);
+         FD_SET(set->entries[i].socket, &errorFds);
+         if (set->entries[i].socket > maxSocket)
+            maxSocket = set->entries[i].socket;
+      }
+
+      // Wait (a negative timeout means wait forever)
+      timeout.tv_sec = timeoutMillisecs / 1000;
+      timeout.tv_usec = (timeoutMillisecs % 1000) * 1000;
+      count = select(maxSocket + 1, &readFds, &writeFds, &errorFds,
+                     (timeoutMillisecs < 0) ? NULL : &timeout);
+      if (count <= 0)
+         return count;
+
+      // Report whichever sockets are ready
+      count = 0;
+      for (i = 0; (i < set->num_entries) && (count < maxEvents); i++)
+      {
+         events[count].id = set->entries[i].id;
+         events[count].events = 0;
+         if (FD_ISSET(set->entries[i].socket, &readFds))
+            events[count].events |= AT_POLL_READ;
+         if (FD_ISSET(set->entries[i].socket, &writeFds))
+            events[count].events |= AT_POLL_WRITE;
+         if (FD_ISSET(set->entries[i].socket, &errorFds))
+            events[count].events |= AT_POLL_ERROR;
+         if (events[count].events != 0)
+            count++;
+      }
+
+      return count;
+   }
+#endif
+
@@ -0,0 +1,88 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AT_POLL_H
+#define AT_POLL_H
+
+
+#include "atIntTypes.h++"
+#include "atNetwork.h++"
+#include "atSymbols.h++"
+
+
+// Readiness flags for sockets registered with a poll set
+#define AT_POLL_READ    0x01
+#define AT_POLL_WRITE   0x02
+#define AT_POLL_ERROR   0x04
+
+
+// A set of sockets that can be waited on together.  Under Linux (and
+// Android) this is an epoll instance, so waiting costs the same no matter
+// how many sockets are registered; elsewhere it falls back to select()
+typedef struct atPollSet   atPollSet;
+
+// A readiness event returned by pollSetWait().  The ID is whatever the
+// caller gave when the socket was registered
+typedef struct
+{
+   int      id;
+   u_long   events;
+} atPollEvent;
+
+
+#ifdef __cplusplus
+   extern "C"
+   {
+      ATLAS_SYM atPollSet *   pollSetCreate();
+      ATLAS_SYM void          pollSetDestroy(atPollSet * set);
+
+      ATLAS_SYM bool   pollSetAdd(atPollSet * set, Socket socket, int id,
+                                  u_long events);
+      ATLAS_SYM bool   pollSetModify(atPollSet * set, Socket socket, int id,
+                                     u_long events);
+      ATLAS_SYM void   pollSetRemove(atPollSet * set, Socket socket);
+
+      ATLAS_SYM int    pollSetWait(atPollSet * set, atPollEvent * events,
+                                   int maxEvents, int timeoutMillisecs);
+   }
+#else
+   ATLAS_SYM atPollSet *   pollSetCreate();
+   ATLAS_SYM void          pollSetDestroy(atPollSet * set);
+
+   ATLAS_SYM bool   pollSetAdd(atPollSet * set, Socket socket, int id,
+                               u_long events);
+   ATLAS_SYM bool   pollSetModify(atPollSet * set, Socket socket, int id,
+                                  u_long events);
+   ATLAS_SYM void   pollSetRemove(atPollSet * set, Socket socket);
+
+   ATLAS_SYM int    pollSetWait(atPollSet * set, atPollEvent * events,
+                                int maxEvents, int timeoutMillisecs);
+#endif
+
+
+#endif
+
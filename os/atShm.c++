@@ -191,7 +191,7 @@
    int shmDetach(u_char * mem)
    {
       // Detach from the shared memory
-      shmdt(mem);
+      return shmdt(mem);
    }
 #endif
 
@@ -25,6 +25,12 @@
 // limitations under the License.
 
 
+// Thread affinity under Linux is a GNU extension, so ask for it before
+// any of the system headers are included
+#if defined(__linux__) && !defined(__ANDROID__) && !defined(_GNU_SOURCE)
+   #define _GNU_SOURCE
+#endif
+
 #include "atErrno.h++"
 #include "atThread.h++"
 
@@ -162,3 +168,243 @@
    }
 #endif
 
+
+#ifdef _MSC_VER
+   #define WIN32_LEAN_AND_MEAN
+   #include <windows.h>
+   #include <process.h>
+   #include <stdlib.h>
+
+   // What a new thread needs to know to get started
+   typedef struct
+   {
+      ThreadFunction   thread_function;
+      void *           thread_arg;
+   } ThreadStart;
+
+   u_long getNumProcessors()
+   {
+      SYSTEM_INFO   info;
+
+      // Ask the system how many processors there are
+      GetSystemInfo(&info);
+      if (info.dwNumberOfProcessors < 1)
+         return 1;
+      return info.dwNumberOfProcessors;
+   }
+
+
+   bool pinCurrentThread(u_long processor)
+   {
+      // The affinity mask has one bit per processor
+      if (processor >= sizeof(DWORD_PTR) * 8)
+         return false;
+      return (SetThreadAffinityMask(GetCurrentThread(), 
+                                    ((DWORD_PTR ) 1) << processor) != 0);
+   }
+
+
+   static unsigned __stdcall runThreadFunction(void * startPtr)
+   {
+      ThreadStart      start;
+
+      // Take what we need from the start information (it was allocated
+      // for us), then run the thread's function
+      start = *((ThreadStart *) startPtr);
+      free(startPtr);
+      start.thread_function(start.thread_arg);
+      return 0;
+   }
+
+
+   bool threadCreate(ThreadID * id, ThreadFunction function, void * arg)
+   {
+      ThreadStart *   start;
+
+      // The system calls thread functions differently, so the new thread
+      // starts off in one of our own that calls the real one
+      start = (ThreadStart *) malloc(sizeof(ThreadStart));
+      if (start == NULL)
+         return false;
+      start->thread_function = function;
+      start->thread_arg = arg;
+
+      // Start the thread (through the C runtime, so it's set up for the
+      // thread as well)
+      *id = (HANDLE ) _beginthreadex(NULL, 0, runThreadFunction, start, 0,
+                                     NULL);
+      if (*id == 0)
+      {
+         free(start);
+         return false;
+      }
+      return true;
+   }
+
+
+   bool threadJoin(ThreadID id)
+   {
+      // Wait for the thread to finish, then let go of it
+      if (WaitForSingleObject(id, INFINITE) != WAIT_OBJECT_0)
+         return false;
+      CloseHandle(id);
+      return true;
+   }
+
+
+   void threadMutexInit(ThreadMutex * mutex)
+   {
+      InitializeSRWLock(mutex);
+   }
+
+
+   void threadMutexDestroy(ThreadMutex * mutex)
+   {
+      // Slim locks don't hold on to anything
+   }
+
+
+   void threadMutexLock(ThreadMutex * mutex)
+   {
+      AcquireSRWLockExclusive(mutex);
+   }
+
+
+   void threadMutexUnlock(ThreadMutex * mutex)
+   {
+      ReleaseSRWLockExclusive(mutex);
+   }
+
+
+   static BOOL CALLBACK runOnceFunction(PINIT_ONCE once, PVOID function,
+                                        PVOID * context)
+   {
+      // Call the function we were handed
+      ((ThreadOnceFunction ) function)();
+      return TRUE;
+   }
+
+
+   void threadOnce(ThreadOnce * once, ThreadOnceFunction function)
+   {
+      InitOnceExecuteOnce(once, runOnceFunction, (PVOID ) function, NULL);
+   }
+
+
+   bool threadKeyCreate(ThreadKey * key, ThreadKeyDestructor destructor)
+   {
+      // Fiber-local storage is used instead of thread-local storage,
+      // because only it calls a destructor when the thread exits
+      *key = FlsAlloc(destructor);
+      return (*key != FLS_OUT_OF_INDEXES);
+   }
+
+
+   void * threadKeyGet(ThreadKey key)
+   {
+      return FlsGetValue(key);
+   }
+
+
+   bool threadKeySet(ThreadKey key, void * value)
+   {
+      return (FlsSetValue(key, value) != 0);
+   }
+#else
+   #include <unistd.h>
+
+   #if defined(__linux__) && !defined(__ANDROID__)
+      #include <sched.h>
+   #endif
+
+   u_long getNumProcessors()
+   {
+      long   count;
+
+      // Ask the system how many processors are online
+      count = sysconf(_SC_NPROCESSORS_ONLN);
+      if (count < 1)
+         return 1;
+      return (u_long ) count;
+   }
+
+
+   bool pinCurrentThread(u_long processor)
+   {
+      #if defined(__linux__) && !defined(__ANDROID__)
+         cpu_set_t   cpuSet;
+
+         // Allow this thread on only the one processor
+         if (processor >= CPU_SETSIZE)
+            return false;
+         CPU_ZERO(&cpuSet);
+         CPU_SET(processor, &cpuSet);
+         return (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet),
+                                        &cpuSet) == 0);
+      #else
+         // No way to pin threads here (Mac OS only takes hints about
+         // which threads should share a cache)
+         return false;
+      #endif
+   }
+
+
+   bool threadCreate(ThreadID * id, ThreadFunction function, void * arg)
+   {
+      return (pthread_create(id, NULL, function, arg) == 0);
+   }
+
+
+   bool threadJoin(ThreadID id)
+   {
+      return (pthread_join(id, NULL) == 0);
+   }
+
+
+   void threadMutexInit(ThreadMutex * mutex)
+   {
+      pthread_mutex_init(mutex, NULL);
+   }
+
+
+   void threadMutexDestroy(ThreadMutex * mutex)
+   {
+      pthread_mutex_destroy(mutex);
+   }
+
+
+   void threadMutexLock(ThreadMutex * mutex)
+   {
+      pthread_mutex_lock(mutex);
+   }
+
+
+   void threadMutexUnlock(ThreadMutex * mutex)
+   {
+      pthread_mutex_unlock(mutex);
+   }
+
+
+   void threadOnce(ThreadOnce * once, ThreadOnceFunction function)
+   {
+      pthread_once(once, function);
+   }
+
+
+   bool threadKeyCreate(ThreadKey * key, ThreadKeyDestructor destructor)
+   {
+      return (pthread_key_create(key, destructor) == 0);
+   }
+
+
+   void * threadKeyGet(ThreadKey key)
+   {
+      return pthread_getspecific(key);
+   }
+
+
+   bool threadKeySet(ThreadKey key, void * value)
+   {
+      return (pthread_setspecific(key, value) == 0);
+   }
+#endif
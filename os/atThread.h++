@@ -31,6 +31,40 @@
 
 #include "atSymbols.h++"
 
+#ifdef _MSC_VER
+   #include <winsock2.h>
+   #include <windows.h>
+
+   typedef HANDLE      ThreadID;
+   typedef SRWLOCK     ThreadMutex;
+   typedef INIT_ONCE   ThreadOnce;
+   typedef DWORD       ThreadKey;
+
+   #define THREAD_MUTEX_INITIALIZER   SRWLOCK_INIT
+   #define THREAD_ONCE_INITIALIZER    INIT_ONCE_STATIC_INIT
+
+   // Key destructors are called by the system, so they have to use its
+   // calling convention
+   #define THREAD_CALLBACK            WINAPI
+#else
+   #include <sys/types.h>
+   #include <pthread.h>
+
+   typedef pthread_t         ThreadID;
+   typedef pthread_mutex_t   ThreadMutex;
+   typedef pthread_once_t    ThreadOnce;
+   typedef pthread_key_t     ThreadKey;
+
+   #define THREAD_MUTEX_INITIALIZER   PTHREAD_MUTEX_INITIALIZER
+   #define THREAD_ONCE_INITIALIZER    PTHREAD_ONCE_INIT
+
+   #define THREAD_CALLBACK
+#endif
+
+typedef void * (*ThreadFunction)(void * arg);
+typedef void (*ThreadOnceFunction)();
+typedef void (THREAD_CALLBACK * ThreadKeyDestructor)(void * value);
+
 
 #if defined(__ANDROID__) || defined(__IOS__)
    #include <pthread.h>
@@ -81,5 +115,75 @@
 #endif
 
 
+// Returns the number of processors that are online (always at least one)
+// and restricts the calling thread to run only on the given processor
+// (numbered from zero).  Pinning isn't available everywhere; where it
+// isn't, pinCurrentThread() just returns false.
+#ifdef __cplusplus
+   extern "C"
+   {
+      ATLAS_SYM u_long   getNumProcessors();
+      ATLAS_SYM bool     pinCurrentThread(u_long processor);
+   }
+#else
+   ATLAS_SYM u_long   getNumProcessors();
+   ATLAS_SYM bool     pinCurrentThread(u_long processor);
+#endif
+
+
+// Starts a thread running the given function (with the given argument),
+// and waits for a thread to finish
+#ifdef __cplusplus
+   extern "C"
+   {
+      ATLAS_SYM bool     threadCreate(ThreadID * id, ThreadFunction function,
+                                      void * arg);
+      ATLAS_SYM bool     threadJoin(ThreadID id);
+   }
+#else
+   ATLAS_SYM bool     threadCreate(ThreadID * id, ThreadFunction function,
+                                   void * arg);
+   ATLAS_SYM bool     threadJoin(ThreadID id);
+#endif
+
+
+// Mutexes, one-time initialization and thread-local values.  A mutex or
+// once flag can be set up statically with THREAD_MUTEX_INITIALIZER or
+// THREAD_ONCE_INITIALIZER (mutexes can also be set up with
+// threadMutexInit()).  A thread key holds a separate value for each
+// thread; when a thread exits with a value set, the key's destructor (if
+// any) is called with that value.
+#ifdef __cplusplus
+   extern "C"
+   {
+      ATLAS_SYM void     threadMutexInit(ThreadMutex * mutex);
+      ATLAS_SYM void     threadMutexDestroy(ThreadMutex * mutex);
+      ATLAS_SYM void     threadMutexLock(ThreadMutex * mutex);
+      ATLAS_SYM void     threadMutexUnlock(ThreadMutex * mutex);
+
+      ATLAS_SYM void     threadOnce(ThreadOnce * once,
+                                    ThreadOnceFunction function);
+
+      ATLAS_SYM bool     threadKeyCreate(ThreadKey * key,
+                                         ThreadKeyDestructor destructor);
+      ATLAS_SYM void *   threadKeyGet(ThreadKey key);
+      ATLAS_SYM bool     threadKeySet(ThreadKey key, void * value);
+   }
+#else
+   ATLAS_SYM void     threadMutexInit(ThreadMutex * mutex);
+   ATLAS_SYM void     threadMutexDestroy(ThreadMutex * mutex);
+   ATLAS_SYM void     threadMutexLock(ThreadMutex * mutex);
+   ATLAS_SYM void     threadMutexUnlock(ThreadMutex * mutex);
+
+   ATLAS_SYM void     threadOnce(ThreadOnce * once,
+                                 ThreadOnceFunction function);
+
+   ATLAS_SYM bool     threadKeyCreate(ThreadKey * key,
+                                      ThreadKeyDestructor destructor);
+   ATLAS_SYM void *   threadKeyGet(ThreadKey key);
+   ATLAS_SYM bool     threadKeySet(ThreadKey key, void * value);
+#endif
+
+
 #endif
 
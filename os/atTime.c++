@@ -180,5 +180,51 @@
       // Returning 0 for a success (I never fail!)
       return 0;
    }
-#endif
 
+
+   uint64_t getMonotonicTime()
+   {
+      LARGE_INTEGER   counter;
+      LARGE_INTEGER   frequency;
+
+      // The performance counter is monotonic (even where it isn't
+      // reliable enough for gettimeofday() above, it's fine for short
+      // intervals)
+      QueryPerformanceCounter(&counter);
+      QueryPerformanceFrequency(&frequency);
+
+      // Convert to nanoseconds (splitting off the whole seconds first so
+      // the multiplication can't overflow)
+      return (uint64_t ) (counter.QuadPart / frequency.QuadPart) *
+                1000000000 +
+             (uint64_t ) (counter.QuadPart % frequency.QuadPart) *
+                1000000000 / frequency.QuadPart;
+   }
+#elif __APPLE__
+   #include <mach/mach_time.h>
+   #include "atTime.h++"
+
+   uint64_t getMonotonicTime()
+   {
+      static mach_timebase_info_data_t   timebase;
+
+      // Get the conversion from ticks to nanoseconds the first time
+      if (timebase.denom == 0)
+         mach_timebase_info(&timebase);
+
+      // Convert the absolute time to nanoseconds
+      return mach_absolute_time() * timebase.numer / timebase.denom;
+   }
+#else
+   #include <time.h>
+   #include "atTime.h++"
+
+   uint64_t getMonotonicTime()
+   {
+      struct timespec   now;
+
+      // Read the monotonic clock and convert it to nanoseconds
+      clock_gettime(CLOCK_MONOTONIC, &now);
+      return (uint64_t ) now.tv_sec * 1000000000 + (uint64_t ) now.tv_nsec;
+   }
+#endif
@@ -29,6 +29,7 @@
 #define AT_TIME_H
 
 
+#include "atIntTypes.h++"
 #include "atSymbols.h++"
 
 
@@ -71,5 +72,18 @@
 #endif
 
 
+// Returns the time in nanoseconds from a clock that never jumps (unlike
+// gettimeofday(), it isn't affected by changes to the system time).  The
+// starting point is arbitrary, so this is only good for measuring
+// intervals.
+#ifdef __cplusplus
+   extern "C"
+   {
+      ATLAS_SYM uint64_t   getMonotonicTime();
+   }
+#else
+   ATLAS_SYM uint64_t   getMonotonicTime();
 #endif
 
+
+#endif
@@ -96,3 +96,9 @@ int atChar::compare(atItem * otherItem)
    }
 }
 
+
+u_long atChar::getHashCode()
+{
+   // The value itself makes a fine hash code
+   return (u_long ) char_value;
+}
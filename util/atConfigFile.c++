@@ -29,24 +29,155 @@
 #include <stdlib.h>
 #include <string.h>
 #include "atConfigFile.h++"
+#include "atFile.h++"
+
+
+// How many entries the mapped mode's arrays start with (they double in
+// size whenever they fill up)
+#define AT_CONFIG_INITIAL_ENTRIES   1024
+
+
+static bool growArray(void ** array, u_long * capacity, u_long entrySize)
+{
+   void *   newArray;
+   u_long   newCapacity;
+
+   // Double the array (or start it off)
+   if (*capacity == 0)
+      newCapacity = AT_CONFIG_INITIAL_ENTRIES;
+   else
+      newCapacity = *capacity * 2;
+   newArray = realloc(*array, newCapacity * entrySize);
+   if (newArray == NULL)
+      return false;
+
+   // Use the new array
+   *array = newArray;
+   *capacity = newCapacity;
+   return true;
+}
+
+
+static u_long hashKey(char * key)
+{
+   u_long   hash;
+
+   // FNV-1a hash of the key's characters
+   hash = 2166136261u;
+   while (*key != '\0')
+   {
+      hash ^= (u_char ) *key;
+      hash *= 16777619u;
+      key++;
+   }
+
+   return hash;
+}
+
+
+static char * findDelimiter(char * start, char * end, const char * delimiters)
+{
+   char *   current;
+
+   // Return the first character in the range that's a delimiter (or the
+   // end of the range if there isn't one)
+   for (current = start; current < end; current++)
+   {
+      if ((*current != '\0') && (strchr(delimiters, *current) != NULL))
+         return current;
+   }
+   return end;
+}
+
+
+static char * getMappedWord(char ** position, char * lineEnd,
+                            const char * delimiters, u_long * length)
+{
+   char *   start;
+   char *   end;
+
+   // Skip any delimiters, then find the end of the word (this works just
+   // like atStringTokenizer, which the streaming mode uses)
+   start = *position;
+   while ((start < lineEnd) && (*start != '\0') &&
+          (strchr(delimiters, *start) != NULL))
+      start++;
+   if (start >= lineEnd)
+   {
+      *position = lineEnd;
+      return NULL;
+   }
+   end = findDelimiter(start, lineEnd, delimiters);
+
+   // Move past the word and the delimiter that ended it
+   *length = (u_long ) (end - start);
+   if (end < lineEnd)
+      *position = end + 1;
+   else
+      *position = lineEnd;
+   return start;
+}
 
 
 atConfigFile::atConfigFile(char * filename)
 {
-   FILE *          infile;
-   char            line[255];
-   atString *      lineToken;
-   atTupleKey *    key;
-   atTupleHead *   head;
-   atString *      arg;
+   // Streaming is the default
+   initConfigFile(filename, AT_CONFIG_FILE_STREAM);
+}
+
 
+atConfigFile::atConfigFile(char * filename, atConfigFileMode mode)
+{
+   // Load the file the way we were asked to
+   initConfigFile(filename, mode);
+}
+
+
+void atConfigFile::initConfigFile(char * filename, atConfigFileMode mode)
+{
    // Initialize the tuple list to be empty
+   file_mode = mode;
    tuple_list = NULL;
    tuple_list_end = NULL;
 
    // Initialize the tokenizer
    current_tokenizer = NULL;
 
+   // Nothing mapped or indexed yet
+   map_data = NULL;
+   map_size = 0;
+   mapped_keys = NULL;
+   num_mapped_keys = 0;
+   mapped_keys_capacity = 0;
+   key_index = NULL;
+   key_index_size = 0;
+   mapped_tuples = NULL;
+   num_mapped_tuples = 0;
+   mapped_tuples_capacity = 0;
+   mapped_arguments = NULL;
+   num_mapped_arguments = 0;
+   mapped_arguments_capacity = 0;
+   spilled_tokens = NULL;
+   num_spilled_tokens = 0;
+   spilled_tokens_capacity = 0;
+
+   // Load the file
+   if (file_mode == AT_CONFIG_FILE_MAPPED)
+      loadMapped(filename);
+   else
+      loadStream(filename);
+}
+
+
+void atConfigFile::loadStream(char * filename)
+{
+   FILE *          infile;
+   char            line[AT_CONFIG_LINE_LENGTH];
+   atString *      lineToken;
+   atTupleKey *    key;
+   atTupleHead *   head;
+   atString *      arg;
+
    // Open the config file
    if ( (infile = fopen(filename, "r")) == NULL )
    {
@@ -108,6 +239,73 @@ atConfigFile::atConfigFile(char * filename)
 }
 
 
+void atConfigFile::loadMapped(char * filename)
+{
+   char *          position;
+   char *          fileEnd;
+   char *          lineEnd;
+   char *          newline;
+   u_long          lineLength;
+   char *          lineToken;
+   atMappedKey *   key;
+   char *          arg;
+
+   // Map the config file
+   if (!mapFile(filename, &map_data, &map_size))
+   {
+      // Warn the user if we failed to map it
+      notify(AT_WARN, "Can't open configuration file (%s)!\n", filename);
+      return;
+   }
+
+   // Go through the file a line at a time
+   position = map_data;
+   fileEnd = map_data + map_size;
+   while (position < fileEnd)
+   {
+      // Lines end after their newline or when they're too long, just as
+      // fgets() would read them.  A last line without a newline is skipped,
+      // as the streaming mode hits the end of the file reading it
+      lineLength = (u_long ) (fileEnd - position);
+      if (lineLength > AT_CONFIG_LINE_LENGTH - 1)
+         lineLength = AT_CONFIG_LINE_LENGTH - 1;
+      newline = (char *) memchr(position, '\n', lineLength);
+      if (newline != NULL)
+         lineEnd = newline + 1;
+      else if (lineLength == AT_CONFIG_LINE_LENGTH - 1)
+         lineEnd = position + lineLength;
+      else
+         break;
+
+      // Get a token from the line
+      lineToken = getMappedToken(&position, lineEnd);
+
+      // If we received something and it's not the comment character (#)
+      if ((lineToken != NULL) && (lineToken[0] != '#'))
+      {
+         // Find the key for this line.  Create one if needed, then add a
+         // new tuple to it
+         key = findMappedKey(lineToken);
+         if (key == NULL)
+            key = addMappedKey(lineToken, hashKey(lineToken));
+         if ((key != NULL) && (addMappedTuple(key)))
+         {
+            // Add all of the arguments to the tuple
+            arg = getMappedToken(&position, lineEnd);
+            while (arg != NULL)
+            {
+               addMappedArgument(arg);
+               arg = getMappedToken(&position, lineEnd);
+            }
+         }
+      }
+
+      // On to the next line
+      position = lineEnd;
+   }
+}
+
+
 atConfigFile::~atConfigFile()
 {
    atTupleKey *        currentKey;
@@ -116,11 +314,22 @@ atConfigFile::~atConfigFile()
    atTupleKey *        oldKey;
    atTupleHead *       oldHead;
    atTupleArgument *   oldArg;
+   u_long              i;
 
    // Cleanup the tokenizer
    if (current_tokenizer != NULL)
       delete current_tokenizer;
 
+   // Release the mapping and the arrays that point into it
+   unmapFile(map_data, map_size);
+   free(mapped_keys);
+   free(key_index);
+   free(mapped_tuples);
+   free(mapped_arguments);
+   for (i = 0; i < num_spilled_tokens; i++)
+      free(spilled_tokens[i]);
+   free(spilled_tokens);
+
    // Go through all the keys in the list
    currentKey = tuple_list;
    while (currentKey != NULL)
@@ -329,10 +538,273 @@ atTupleArgument * atConfigFile::addArgument(atTupleHead * head, char * arg)
 }
 
 
+char * atConfigFile::getMappedToken(char ** position, char * lineEnd)
+{
+   char *   token;
+   char *   rest;
+   u_long   length;
+   u_long   restLength;
+
+   // Get the token
+   token = getMappedWord(position, lineEnd, " \t\r\n", &length);
+   if (token == NULL)
+      return NULL;
+
+   // No quote so return everything
+   if (token[0] != '"')
+      return endMappedToken(token, length, lineEnd);
+
+   // Check to see if the quoted string is actually just a single word
+   // (meaning the word ended with the second quote), and drop the quotes
+   // if so
+   if (token[length-1] == '"')
+   {
+      if (length == 1)
+         return endMappedToken(&token[1], 0, lineEnd);
+      else
+         return endMappedToken(&token[1], length - 2, lineEnd);
+   }
+
+   // Get the next part of the string (until the terminating quote), or
+   // settle for what we have if there isn't one
+   rest = getMappedWord(position, lineEnd, "\"\r\n", &restLength);
+   if (rest == NULL)
+      return endMappedToken(&token[1], length - 1, lineEnd);
+
+   // Put the two pieces back together with a single space, as the
+   // streaming mode does (the delimiter between them was used up, so this
+   // can all be done in place)
+   token[length] = ' ';
+   if (rest != &token[length+1])
+      memmove(&token[length+1], rest, restLength);
+   return endMappedToken(&token[1], length + restLength, lineEnd);
+}
+
+
+char * atConfigFile::endMappedToken(char * token, u_long length,
+                                    char * lineEnd)
+{
+   char *   copy;
+
+   // Usually the token is followed by a delimiter we've already used, so
+   // we just terminate the token there
+   if (&token[length] < lineEnd)
+   {
+      token[length] = '\0';
+      return token;
+   }
+
+   // The token runs right up to the end of a line that was cut short (or
+   // the end of the file), so there's nowhere to put the terminator;
+   // this is rare, so just make a copy
+   if ((num_spilled_tokens == spilled_tokens_capacity) &&
+       (!growArray((void **) &spilled_tokens, &spilled_tokens_capacity,
+                   sizeof(char *))))
+   {
+      notify(AT_WARN, "Unable to allocate memory!\n");
+      return NULL;
+   }
+   copy = (char *) malloc(length + 1);
+   if (copy == NULL)
+   {
+      notify(AT_WARN, "Unable to allocate memory!\n");
+      return NULL;
+   }
+   memcpy(copy, token, length);
+   copy[length] = '\0';
+   spilled_tokens[num_spilled_tokens] = copy;
+   num_spilled_tokens++;
+   return copy;
+}
+
+
+atMappedKey * atConfigFile::findMappedKey(char * key)
+{
+   u_long   hash;
+   u_long   slot;
+   long     keyNumber;
+
+   // Nothing to find if there aren't any keys
+   if (key_index_size == 0)
+      return NULL;
+
+   // Look through the index, starting where the key's hash puts it, until
+   // we find the key or an empty slot
+   hash = hashKey(key);
+   slot = hash & (key_index_size - 1);
+   while ((keyNumber = key_index[slot]) >= 0)
+   {
+      if ((mapped_keys[keyNumber].hash == hash) &&
+          (strcmp(mapped_keys[keyNumber].key, key) == 0))
+         return &mapped_keys[keyNumber];
+      slot = (slot + 1) & (key_index_size - 1);
+   }
+
+   // We didn't find it so return NULL
+   return NULL;
+}
+
+
+atMappedKey * atConfigFile::addMappedKey(char * key, u_long hash)
+{
+   long *          newIndex;
+   u_long          newSize;
+   u_long          slot;
+   u_long          i;
+   atMappedKey *   newKey;
+
+   // Make sure there's room for another key
+   if ((num_mapped_keys == mapped_keys_capacity) &&
+       (!growArray((void **) &mapped_keys, &mapped_keys_capacity,
+                   sizeof(atMappedKey))))
+   {
+      notify(AT_WARN, "Unable to allocate memory!\n");
+      return NULL;
+   }
+
+   // Keep the index no more than half full (so searches stay short),
+   // rebuilding it at twice the size when it gets there
+   if ((num_mapped_keys + 1) * 2 > key_index_size)
+   {
+      if (key_index_size == 0)
+         newSize = AT_CONFIG_INITIAL_ENTRIES;
+      else
+         newSize = key_index_size * 2;
+      newIndex = (long *) malloc(newSize * sizeof(long));
+      if (newIndex == NULL)
+      {
+         notify(AT_WARN, "Unable to allocate memory!\n");
+         return NULL;
+      }
+      for (i = 0; i < newSize; i++)
+         newIndex[i] = -1;
+      for (i = 0; i < num_mapped_keys; i++)
+      {
+         slot = mapped_keys[i].hash & (newSize - 1);
+         while (newIndex[slot] >= 0)
+            slot = (slot + 1) & (newSize - 1);
+         newIndex[slot] = (long ) i;
+      }
+      free(key_index);
+      key_index = newIndex;
+      key_index_size = newSize;
+   }
+
+   // Initialize record for new key
+   newKey = &mapped_keys[num_mapped_keys];
+   newKey->key = key;
+   newKey->hash = hash;
+   newKey->tupleList = -1;
+   newKey->tupleListEnd = -1;
+   newKey->currentTuple = -1;
+
+   // Add it to the index
+   slot = hash & (key_index_size - 1);
+   while (key_index[slot] >= 0)
+      slot = (slot + 1) & (key_index_size - 1);
+   key_index[slot] = (long ) num_mapped_keys;
+   num_mapped_keys++;
+
+   // Return a pointer to this key (used in adding tuples of arguments)
+   return newKey;
+}
+
+
+bool atConfigFile::addMappedTuple(atMappedKey * key)
+{
+   atMappedTuple *   tuple;
+   long              tupleNumber;
+
+   // Make sure there's room for another tuple
+   if ((num_mapped_tuples == mapped_tuples_capacity) &&
+       (!growArray((void **) &mapped_tuples, &mapped_tuples_capacity,
+                   sizeof(atMappedTuple))))
+   {
+      notify(AT_WARN, "Unable to allocate memory!\n");
+      return false;
+   }
+
+   // The tuple's arguments will be the ones added from here on
+   tupleNumber = (long ) num_mapped_tuples;
+   tuple = &mapped_tuples[tupleNumber];
+   tuple->firstArgument = num_mapped_arguments;
+   tuple->numArguments = 0;
+   tuple->next = -1;
+   num_mapped_tuples++;
+
+   // Add the tuple to the end of the key's list
+   if (key->tupleListEnd < 0)
+   {
+      // First tuple, so the current tuple pointer starts here too
+      key->tupleList = tupleNumber;
+      key->tupleListEnd = tupleNumber;
+      key->currentTuple = tupleNumber;
+   }
+   else
+   {
+      mapped_tuples[key->tupleListEnd].next = tupleNumber;
+      key->tupleListEnd = tupleNumber;
+   }
+
+   return true;
+}
+
+
+bool atConfigFile::addMappedArgument(char * arg)
+{
+   // Skip arguments we couldn't get
+   if (arg == NULL)
+      return false;
+
+   // Make sure there's room for another argument
+   if ((num_mapped_arguments == mapped_arguments_capacity) &&
+       (!growArray((void **) &mapped_arguments, &mapped_arguments_capacity,
+                   sizeof(char *))))
+   {
+      notify(AT_WARN, "Unable to allocate memory!\n");
+      return false;
+   }
+
+   // Add it to the latest tuple (its arguments are always the last ones)
+   mapped_arguments[num_mapped_arguments] = arg;
+   num_mapped_arguments++;
+   mapped_tuples[num_mapped_tuples - 1].numArguments++;
+   return true;
+}
+
+
 bool atConfigFile::getNextTuple(char * key, int * argc, char * argv[])
 {
    atTupleKey *        tupleKey;
    atTupleArgument *   arg;
+   atMappedKey *       mappedKey;
+   atMappedTuple *     tuple;
+   u_long              i;
+
+   // In mapped mode, the key comes from the index and the arguments are
+   // already in an array
+   if (file_mode == AT_CONFIG_FILE_MAPPED)
+   {
+      // Search for key.  If not found, return error
+      mappedKey = findMappedKey(key);
+      if (mappedKey == NULL)
+      {
+         *argc = 0;
+         return false;
+      }
+
+      // If pointer is at end of list already, return error
+      if (mappedKey->currentTuple < 0)
+         return false;
+
+      // Copy the argument pointers and advance to the next tuple
+      tuple = &mapped_tuples[mappedKey->currentTuple];
+      for (i = 0; i < tuple->numArguments; i++)
+         argv[i] = mapped_arguments[tuple->firstArgument + i];
+      *argc = (int ) tuple->numArguments;
+      mappedKey->currentTuple = tuple->next;
+      return true;
+   }
 
    // Search for key.  If not found, return error
    tupleKey = findKey(key);
@@ -371,7 +843,19 @@ bool atConfigFile::getNextTuple(char * key, int * argc, char * argv[])
 
 bool atConfigFile::resetTupleList(char * key)
 {
-   atTupleKey *   tupleKey;
+   atTupleKey *    tupleKey;
+   atMappedKey *   mappedKey;
+
+   // In mapped mode, find the key in the index and move its current
+   // tuple back to the first one
+   if (file_mode == AT_CONFIG_FILE_MAPPED)
+   {
+      mappedKey = findMappedKey(key);
+      if (mappedKey == NULL)
+         return false;
+      mappedKey->currentTuple = mappedKey->tupleList;
+      return true;
+   }
 
    // Find the corresponding key in the list
    tupleKey = findKey(key);
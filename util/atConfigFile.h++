@@ -38,6 +38,23 @@
 #define AT_MAX_KEY_LENGTH        256
 #define AT_MAX_ARGUMENT_LENGTH   256
 
+// Lines are read in pieces of at most this many bytes (less one), so
+// longer lines are treated as several lines
+#define AT_CONFIG_LINE_LENGTH    255
+
+
+// How the file is loaded.  Streaming reads the file a line at a time and
+// copies every key and argument.  Mapping maps the file into memory and
+// tokenizes it where it lies, indexing the keys in a hash table and
+// pointing the arguments straight into the mapping; it's much faster for
+// large files, but holds the whole file in memory.  Both give exactly the
+// same tuples
+enum atConfigFileMode
+{
+   AT_CONFIG_FILE_STREAM,
+   AT_CONFIG_FILE_MAPPED
+};
+
 
 typedef struct atCfgArgument
 {
@@ -61,23 +78,76 @@ typedef struct atCfgKey
    struct atCfgKey *   next;
 } atTupleKey;
 
+typedef struct atCfgMappedTuple
+{
+   u_long   firstArgument;
+   u_long   numArguments;
+   long     next;
+} atMappedTuple;
+
+typedef struct atCfgMappedKey
+{
+   char *   key;
+   u_long   hash;
+   long     tupleList;
+   long     tupleListEnd;
+   long     currentTuple;
+} atMappedKey;
+
 
 class ATLAS_SYM atConfigFile : public atNotifier
 {
    protected:
+      atConfigFileMode      file_mode;
+
       atTupleKey *          tuple_list;
       atTupleKey *          tuple_list_end;
 
       atStringTokenizer *   current_tokenizer;
 
+      char *                map_data;
+      u_long                map_size;
+
+      atMappedKey *         mapped_keys;
+      u_long                num_mapped_keys;
+      u_long                mapped_keys_capacity;
+      long *                key_index;
+      u_long                key_index_size;
+
+      atMappedTuple *       mapped_tuples;
+      u_long                num_mapped_tuples;
+      u_long                mapped_tuples_capacity;
+
+      char **               mapped_arguments;
+      u_long                num_mapped_arguments;
+      u_long                mapped_arguments_capacity;
+
+      char **               spilled_tokens;
+      u_long                num_spilled_tokens;
+      u_long                spilled_tokens_capacity;
+
+      void                initConfigFile(char * filename,
+                                         atConfigFileMode mode);
+
+      void                loadStream(char * filename);
       atString *          getToken();
       atTupleKey *        findKey(char * key);
       atTupleKey *        addKey(char * key);
       atTupleHead *       addTuple(atTupleKey * key);
       atTupleArgument *   addArgument(atTupleHead * head, char * arg);
 
+      void                loadMapped(char * filename);
+      char *              getMappedToken(char ** position, char * lineEnd);
+      char *              endMappedToken(char * token, u_long length,
+                                         char * lineEnd);
+      atMappedKey *       findMappedKey(char * key);
+      atMappedKey *       addMappedKey(char * key, u_long hash);
+      bool                addMappedTuple(atMappedKey * key);
+      bool                addMappedArgument(char * arg);
+
    public:
       atConfigFile(char * filename);
+      atConfigFile(char * filename, atConfigFileMode mode);
       ~atConfigFile();
 
       virtual bool   getNextTuple(char * key, int * argc, char * argv[]);
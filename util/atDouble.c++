@@ -115,3 +115,10 @@ int atDouble::compare(atItem * otherItem)
    }
 }
 
+
+u_long atDouble::getHashCode()
+{
+   // Values are compared within a tolerance, so let atItem work out a
+   // hash code that agrees with that
+   return hashDouble(double_value);
+}
@@ -115,3 +115,10 @@ int atFloat::compare(atItem * otherItem)
    }
 }
 
+
+u_long atFloat::getHashCode()
+{
+   // Values are compared within a tolerance, so let atItem work out a
+   // hash code that agrees with that
+   return hashFloat(float_value);
+}
@@ -96,3 +96,9 @@ int atInt::compare(atItem * otherItem)
    }
 }
 
+
+u_long atInt::getHashCode()
+{
+   // The value itself makes a fine hash code
+   return (u_long ) int_value;
+}
@@ -96,3 +96,9 @@ int atLong::compare(atItem * otherItem)
    }
 }
 
+
+u_long atLong::getHashCode()
+{
+   // The value itself makes a fine hash code
+   return (u_long ) long_value;
+}
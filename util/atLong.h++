@@ -46,6 +46,7 @@ class ATLAS_SYM atLong : public atItem
 
       virtual bool   equals(atItem * otherItem);
       virtual int    compare(atItem * otherItem);
+      virtual u_long getHashCode();
 };
 
 
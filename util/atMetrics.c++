@@ -0,0 +1,565 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdlib.h>
+#include <string.h>
+#include "atAtomic.h++"
+#include "atMetrics.h++"
+#include "atThread.h++"
+
+
+// TYPES
+// The running totals for one metric within one thread.  Only the thread
+// itself ever writes these, but snapshots read them from other threads,
+// so every access is atomic
+typedef struct
+{
+   atAtomic64   count;
+   atAtomic64   sum;
+   atAtomic64   min;
+   atAtomic64   max;
+   atAtomic64   buckets[AT_METRICS_NUM_BUCKETS];
+} atMetricData;
+
+// Plain totals for one metric (a copy of a thread's running totals, or
+// the sum of several)
+typedef struct
+{
+   uint64_t   count;
+   uint64_t   sum;
+   uint64_t   min;
+   uint64_t   max;
+   uint64_t   buckets[AT_METRICS_NUM_BUCKETS];
+} atMetricTotals;
+
+// Everything one thread has recorded (these are kept in a list so
+// snapshots can find them).  The epoch says which reset the totals
+// started after; they only count while it matches the current one
+typedef struct atMetricsThreadData
+{
+   atMetricData                   metrics[AT_METRICS_MAX_METRICS];
+   atAtomic                       reset_epoch;
+   struct atMetricsThreadData *   next;
+   struct atMetricsThreadData *   previous;
+} atMetricsThreadData;
+
+// Names and types of ATLAS' own metrics (in atMetricID order)
+typedef struct
+{
+   const char *   name;
+   atMetricType   type;
+} atMetricInfo;
+
+
+// GLOBAL VARIABLES
+static const atMetricInfo   at_metrics_builtin[AT_METRIC_NUM_BUILTIN] =
+{
+   { "udp.messages_read", AT_METRIC_COUNTER },
+   { "udp.bytes_read", AT_METRIC_COUNTER },
+   { "udp.messages_written", AT_METRIC_COUNTER },
+   { "udp.bytes_written", AT_METRIC_COUNTER },
+
+   { "tcp.messages_read", AT_METRIC_COUNTER },
+   { "tcp.bytes_read", AT_METRIC_COUNTER },
+   { "tcp.messages_written", AT_METRIC_COUNTER },
+   { "tcp.bytes_written", AT_METRIC_COUNTER },
+
+   { "shared_queue.messages_enqueued", AT_METRIC_COUNTER },
+   { "shared_queue.bytes_enqueued", AT_METRIC_COUNTER },
+   { "shared_queue.messages_dequeued", AT_METRIC_COUNTER },
+   { "shared_queue.bytes_dequeued", AT_METRIC_COUNTER },
+   { "shared_queue.depth_bytes", AT_METRIC_HISTOGRAM },
+   { "shared_queue.full", AT_METRIC_COUNTER },
+   { "shared_queue.reallocations", AT_METRIC_COUNTER },
+   { "shared_queue.lock_wait_ns", AT_METRIC_HISTOGRAM },
+
+   { "thread_queue.messages_enqueued", AT_METRIC_COUNTER },
+   { "thread_queue.bytes_enqueued", AT_METRIC_COUNTER },
+   { "thread_queue.messages_dequeued", AT_METRIC_COUNTER },
+   { "thread_queue.bytes_dequeued", AT_METRIC_COUNTER },
+   { "thread_queue.depth_bytes", AT_METRIC_HISTOGRAM },
+   { "thread_queue.full", AT_METRIC_COUNTER },
+   { "thread_queue.reallocations", AT_METRIC_COUNTER },
+   { "thread_queue.lock_wait_ns", AT_METRIC_HISTOGRAM },
+
+   { "xml.documents", AT_METRIC_COUNTER },
+   { "xml.parse_time_ns", AT_METRIC_HISTOGRAM }
+};
+
+static ThreadMutex            at_metrics_mutex = THREAD_MUTEX_INITIALIZER;
+static ThreadOnce             at_metrics_once = THREAD_ONCE_INITIALIZER;
+static ThreadKey              at_metrics_key;
+
+static char                   at_metrics_names[AT_METRICS_MAX_METRICS]
+                                              [AT_METRICS_MAX_NAME];
+static atMetricType           at_metrics_types[AT_METRICS_MAX_METRICS];
+static u_long                 at_metrics_count = 0;
+
+static atMetricsThreadData *  at_metrics_threads = NULL;
+static atMetricTotals         at_metrics_retired[AT_METRICS_MAX_METRICS];
+static atAtomic               at_metrics_epoch = 0;
+
+
+// LOCAL FUNCTIONS
+static void loadMetricData(atMetricTotals * totals, atMetricData * data)
+{
+   int   i;
+
+   // Read the count first (the owning thread updates it last, so the
+   // rest is at least as new)
+   totals->count = atomicLoad64(&data->count);
+   totals->sum = atomicLoad64(&data->sum);
+   totals->min = atomicLoad64(&data->min);
+   totals->max = atomicLoad64(&data->max);
+   for (i = 0; i < AT_METRICS_NUM_BUCKETS; i++)
+      totals->buckets[i] = atomicLoad64(&data->buckets[i]);
+}
+
+
+static void mergeMetricTotals(atMetricTotals * total, atMetricTotals * data)
+{
+   int   i;
+
+   // Nothing to add if nothing was recorded
+   if (data->count == 0)
+      return;
+
+   // Combine the extremes (if the total is still empty, just take them)
+   if ((total->count == 0) || (data->min < total->min))
+      total->min = data->min;
+   if ((total->count == 0) || (data->max > total->max))
+      total->max = data->max;
+
+   // Add up everything else
+   total->count += data->count;
+   total->sum += data->sum;
+   for (i = 0; i < AT_METRICS_NUM_BUCKETS; i++)
+      total->buckets[i] += data->buckets[i];
+}
+
+
+static void THREAD_CALLBACK retireThreadData(void * threadData)
+{
+   atMetricsThreadData *   data;
+   atMetricTotals          totals;
+   int                     i;
+
+   // The thread is exiting, so fold its totals into the ones kept for
+   // threads that are gone (unless they're from before the last reset),
+   // then unlink and free its block
+   data = (atMetricsThreadData *) threadData;
+   threadMutexLock(&at_metrics_mutex);
+   if (atomicLoad(&data->reset_epoch) == atomicLoad(&at_metrics_epoch))
+   {
+      for (i = 0; i < AT_METRICS_MAX_METRICS; i++)
+      {
+         loadMetricData(&totals, &data->metrics[i]);
+         mergeMetricTotals(&at_metrics_retired[i], &totals);
+      }
+   }
+   if (data->previous != NULL)
+      data->previous->next = data->next;
+   else
+      at_metrics_threads = data->next;
+   if (data->next != NULL)
+      data->next->previous = data->previous;
+   threadMutexUnlock(&at_metrics_mutex);
+   free(data);
+}
+
+
+static void initMetrics()
+{
+   int   i;
+
+   // Create the key that finds each thread's block (and cleans it up
+   // when the thread exits)
+   threadKeyCreate(&at_metrics_key, retireThreadData);
+
+   // Register ATLAS' own metrics
+   for (i = 0; i < AT_METRIC_NUM_BUILTIN; i++)
+   {
+      strncpy(at_metrics_names[i], at_metrics_builtin[i].name,
+              AT_METRICS_MAX_NAME - 1);
+      at_metrics_types[i] = at_metrics_builtin[i].type;
+   }
+   at_metrics_count = AT_METRIC_NUM_BUILTIN;
+}
+
+
+static atMetricsThreadData * getThreadData()
+{
+   atMetricsThreadData *   data;
+
+   // Make sure everything is set up
+   threadOnce(&at_metrics_once, initMetrics);
+
+   // See if this thread already has a block
+   data = (atMetricsThreadData *) threadKeyGet(at_metrics_key);
+   if (data != NULL)
+      return data;
+
+   // This is the first thing this thread has recorded, so give it a
+   // block of its own
+   data = (atMetricsThreadData *) calloc(1, sizeof(atMetricsThreadData));
+   if (data == NULL)
+      return NULL;
+
+   // Add it to the front of the list (under the lock, since snapshots
+   // walk the list), starting it off in the current epoch
+   threadMutexLock(&at_metrics_mutex);
+   atomicStore(&data->reset_epoch, atomicLoad(&at_metrics_epoch));
+   data->next = at_metrics_threads;
+   data->previous = NULL;
+   if (at_metrics_threads != NULL)
+      at_metrics_threads->previous = data;
+   at_metrics_threads = data;
+   threadMutexUnlock(&at_metrics_mutex);
+
+   // Remember it for next time
+   threadKeySet(at_metrics_key, data);
+   return data;
+}
+
+
+static atMetricData * getMetricData(atMetricID id)
+{
+   atMetricsThreadData *   data;
+   uint32_t                epoch;
+
+   // Ignore invalid metrics
+   if (((int ) id < 0) || ((int ) id >= AT_METRICS_MAX_METRICS))
+      return NULL;
+
+   // Get this thread's block
+   data = getThreadData();
+   if (data == NULL)
+      return NULL;
+
+   // If there's been a reset since this thread last recorded something,
+   // clear out its totals now (reset() leaves this to each thread, since
+   // only the thread itself writes its block).  Snapshots leave the block
+   // out until its epoch is brought up to date, so they never see it
+   // half cleared
+   epoch = atomicLoad(&at_metrics_epoch);
+   if (atomicLoad(&data->reset_epoch) != epoch)
+   {
+      memset((void *) data->metrics, 0, sizeof(data->metrics));
+      atomicStore(&data->reset_epoch, epoch);
+   }
+
+   // Return the metric's totals
+   return &data->metrics[id];
+}
+
+
+static int getBucket(uint64_t value)
+{
+   int   bucket;
+
+   // Zero gets its own bucket
+   if (value == 0)
+      return 0;
+
+   // Otherwise, the bucket is the number of significant bits
+   #if defined(__GNUC__)
+      bucket = 64 - __builtin_clzll(value);
+   #else
+      bucket = 0;
+      while (value != 0)
+      {
+         bucket++;
+         value >>= 1;
+      }
+   #endif
+
+   // The largest values share the last bucket
+   if (bucket >= AT_METRICS_NUM_BUCKETS)
+      bucket = AT_METRICS_NUM_BUCKETS - 1;
+   return bucket;
+}
+
+
+static atMetricID registerMetric(const char * name, atMetricType type)
+{
+   atMetricID   id;
+   u_long       i;
+
+   // Make sure everything is set up
+   threadOnce(&at_metrics_once, initMetrics);
+
+   // Registering the same name again gives back the same metric (so
+   // several modules can share one)
+   threadMutexLock(&at_metrics_mutex);
+   for (i = 0; i < at_metrics_count; i++)
+   {
+      if (strcmp(at_metrics_names[i], name) == 0)
+      {
+         threadMutexUnlock(&at_metrics_mutex);
+         return (atMetricID ) i;
+      }
+   }
+
+   // Fail if we're out of room
+   if (at_metrics_count >= AT_METRICS_MAX_METRICS)
+   {
+      threadMutexUnlock(&at_metrics_mutex);
+      return AT_METRIC_INVALID;
+   }
+
+   // Add the new metric
+   id = (atMetricID ) at_metrics_count;
+   strncpy(at_metrics_names[id], name, AT_METRICS_MAX_NAME - 1);
+   at_metrics_names[id][AT_METRICS_MAX_NAME - 1] = '\0';
+   at_metrics_types[id] = type;
+   at_metrics_count++;
+   threadMutexUnlock(&at_metrics_mutex);
+
+   // Return the new metric's ID
+   return id;
+}
+
+
+atMetricID atMetrics::registerCounter(const char * name)
+{
+   return registerMetric(name, AT_METRIC_COUNTER);
+}
+
+
+atMetricID atMetrics::registerHistogram(const char * name)
+{
+   return registerMetric(name, AT_METRIC_HISTOGRAM);
+}
+
+
+void atMetrics::addCount(atMetricID id, uint64_t amount)
+{
+   atMetricData *   metric;
+
+   // Get this thread's totals for the metric
+   metric = getMetricData(id);
+   if (metric == NULL)
+      return;
+
+   // Add up the amount and count the update (nobody else writes these,
+   // so there's no need for an atomic add)
+   atomicStore64(&metric->sum, atomicLoad64(&metric->sum) + amount);
+   atomicStore64(&metric->count, atomicLoad64(&metric->count) + 1);
+}
+
+
+void atMetrics::recordValue(atMetricID id, uint64_t value)
+{
+   atMetricData *   metric;
+   atAtomic64 *     bucket;
+   uint64_t         count;
+
+   // Get this thread's totals for the metric
+   metric = getMetricData(id);
+   if (metric == NULL)
+      return;
+
+   // Update the extremes
+   count = atomicLoad64(&metric->count);
+   if ((count == 0) || (value < atomicLoad64(&metric->min)))
+      atomicStore64(&metric->min, value);
+   if ((count == 0) || (value > atomicLoad64(&metric->max)))
+      atomicStore64(&metric->max, value);
+
+   // Add the value to the totals and the distribution, and count it last
+   // of all
+   bucket = &metric->buckets[getBucket(value)];
+   atomicStore64(bucket, atomicLoad64(bucket) + 1);
+   atomicStore64(&metric->sum, atomicLoad64(&metric->sum) + value);
+   atomicStore64(&metric->count, count + 1);
+}
+
+
+void atMetrics::getSnapshot(atMetricsSnapshot * snapshot)
+{
+   atMetricsThreadData *   data;
+   atMetricTotals          total;
+   atMetricTotals          threadTotal;
+   uint32_t                epoch;
+   u_long                  i;
+
+   // Make sure everything is set up
+   threadOnce(&at_metrics_once, initMetrics);
+
+   // Start with a clean snapshot
+   memset(snapshot, 0, sizeof(atMetricsSnapshot));
+   snapshot->snapshot_time = getMonotonicTime();
+
+   // Add up each metric over the threads that are gone and the threads
+   // that are still running (leaving out any thread that hasn't caught up
+   // with the last reset, as everything it has is from before it)
+   threadMutexLock(&at_metrics_mutex);
+   epoch = atomicLoad(&at_metrics_epoch);
+   snapshot->num_metrics = at_metrics_count;
+   for (i = 0; i < at_metrics_count; i++)
+   {
+      // Total up this metric
+      memset(&total, 0, sizeof(total));
+      mergeMetricTotals(&total, &at_metrics_retired[i]);
+      for (data = at_metrics_threads; data != NULL; data = data->next)
+      {
+         if (atomicLoad(&data->reset_epoch) == epoch)
+         {
+            loadMetricData(&threadTotal, &data->metrics[i]);
+            mergeMetricTotals(&total, &threadTotal);
+         }
+      }
+
+      // Fill in the snapshot's entry
+      strcpy(snapshot->metrics[i].name, at_metrics_names[i]);
+      snapshot->metrics[i].type = at_metrics_types[i];
+      snapshot->metrics[i].count = total.count;
+      snapshot->metrics[i].sum = total.sum;
+      snapshot->metrics[i].min = total.min;
+      snapshot->metrics[i].max = total.max;
+      memcpy(snapshot->metrics[i].buckets, total.buckets,
+             sizeof(total.buckets));
+   }
+   threadMutexUnlock(&at_metrics_mutex);
+}
+
+
+uint64_t atMetrics::getPercentile(atMetricValue * value, double percentile)
+{
+   uint64_t   target;
+   uint64_t   seen;
+   uint64_t   upperBound;
+   int        i;
+
+   // Nothing recorded, nothing to report
+   if (value->count == 0)
+      return 0;
+
+   // Figure out how many values are at or below the percentile
+   target = (uint64_t ) (percentile / 100.0 * (double ) value->count);
+   if (target < 1)
+      target = 1;
+   if (target > value->count)
+      target = value->count;
+
+   // Find the bucket that holds the target value
+   seen = 0;
+   for (i = 0; i < AT_METRICS_NUM_BUCKETS; i++)
+   {
+      seen += value->buckets[i];
+      if (seen >= target)
+         break;
+   }
+
+   // Report the top of that bucket (but never more than the largest value
+   // actually recorded)
+   if (i == 0)
+      upperBound = 0;
+   else if (i >= AT_METRICS_NUM_BUCKETS - 1)
+      upperBound = value->max;
+   else
+      upperBound = ((uint64_t ) 1 << i) - 1;
+   if (upperBound > value->max)
+      upperBound = value->max;
+   return upperBound;
+}
+
+
+void atMetrics::dump(FILE * output)
+{
+   atMetricsSnapshot *   snapshot;
+   atMetricValue *       value;
+   u_long                i;
+
+   // Default to the standard output
+   if (output == NULL)
+      output = stdout;
+
+   // Snapshots are fairly large, so don't put this one on the stack
+   snapshot = (atMetricsSnapshot *) malloc(sizeof(atMetricsSnapshot));
+   if (snapshot == NULL)
+      return;
+   getSnapshot(snapshot);
+
+   // Print one line for each metric that has recorded something
+   for (i = 0; i < snapshot->num_metrics; i++)
+   {
+      value = &snapshot->metrics[i];
+      if (value->count == 0)
+         continue;
+
+      // Counters just have a total, histograms have the distribution too
+      if (value->type == AT_METRIC_COUNTER)
+      {
+         fprintf(output, "%-36s %20llu\n", value->name,
+                 (unsigned long long) value->sum);
+      }
+      else
+      {
+         fprintf(output, "%-36s count %llu mean %.1f min %llu p50 %llu "
+                 "p99 %llu max %llu\n", value->name,
+                 (unsigned long long) value->count,
+                 (double ) value->sum / (double ) value->count,
+                 (unsigned long long) value->min,
+                 (unsigned long long) getPercentile(value, 50.0),
+                 (unsigned long long) getPercentile(value, 99.0),
+                 (unsigned long long) value->max);
+      }
+   }
+
+   // Done with the snapshot
+   free(snapshot);
+}
+
+
+void atMetrics::reset()
+{
+   // Make sure everything is set up
+   threadOnce(&at_metrics_once, initMetrics);
+
+   // Clear the totals for threads that are gone, and start a new epoch
+   // so that each running thread clears its own totals the next time it
+   // records something (the registered metrics stay registered)
+   threadMutexLock(&at_metrics_mutex);
+   memset(at_metrics_retired, 0, sizeof(at_metrics_retired));
+   atomicAdd(&at_metrics_epoch, 1);
+   threadMutexUnlock(&at_metrics_mutex);
+}
+
+
+atMetricsTimer::atMetricsTimer(atMetricID id)
+{
+   // Remember which histogram gets the time and when we started
+   metric_id = id;
+   start_time = getMonotonicTime();
+}
+
+
+atMetricsTimer::~atMetricsTimer()
+{
+   // Record the time since we were created
+   atMetrics::recordValue(metric_id, getMonotonicTime() - start_time);
+}
@@ -0,0 +1,176 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AT_METRICS_HPP
+#define AT_METRICS_HPP
+
+
+#include <stdio.h>
+#include "atOSDefs.h++"
+
+
+// CONSTANTS
+#define AT_METRICS_MAX_METRICS   64
+#define AT_METRICS_NUM_BUCKETS   64
+#define AT_METRICS_MAX_NAME      64
+
+#define AT_METRIC_INVALID        ((atMetricID ) -1)
+
+
+// The metrics recorded by ATLAS itself.  Applications can register more
+// of their own (up to AT_METRICS_MAX_METRICS in all), which are numbered
+// after these.  Times are in nanoseconds and queue depths are in bytes.
+enum atMetricID
+{
+   AT_METRIC_UDP_MESSAGES_READ,
+   AT_METRIC_UDP_BYTES_READ,
+   AT_METRIC_UDP_MESSAGES_WRITTEN,
+   AT_METRIC_UDP_BYTES_WRITTEN,
+
+   AT_METRIC_TCP_MESSAGES_READ,
+   AT_METRIC_TCP_BYTES_READ,
+   AT_METRIC_TCP_MESSAGES_WRITTEN,
+   AT_METRIC_TCP_BYTES_WRITTEN,
+
+   AT_METRIC_SHARED_QUEUE_MESSAGES_ENQUEUED,
+   AT_METRIC_SHARED_QUEUE_BYTES_ENQUEUED,
+   AT_METRIC_SHARED_QUEUE_MESSAGES_DEQUEUED,
+   AT_METRIC_SHARED_QUEUE_BYTES_DEQUEUED,
+   AT_METRIC_SHARED_QUEUE_DEPTH,
+   AT_METRIC_SHARED_QUEUE_FULL,
+   AT_METRIC_SHARED_QUEUE_REALLOCATIONS,
+   AT_METRIC_SHARED_QUEUE_LOCK_WAIT,
+
+   AT_METRIC_THREAD_QUEUE_MESSAGES_ENQUEUED,
+   AT_METRIC_THREAD_QUEUE_BYTES_ENQUEUED,
+   AT_METRIC_THREAD_QUEUE_MESSAGES_DEQUEUED,
+   AT_METRIC_THREAD_QUEUE_BYTES_DEQUEUED,
+   AT_METRIC_THREAD_QUEUE_DEPTH,
+   AT_METRIC_THREAD_QUEUE_FULL,
+   AT_METRIC_THREAD_QUEUE_REALLOCATIONS,
+   AT_METRIC_THREAD_QUEUE_LOCK_WAIT,
+
+   AT_METRIC_XML_DOCUMENTS,
+   AT_METRIC_XML_PARSE_TIME,
+
+   AT_METRIC_NUM_BUILTIN
+};
+
+
+// Counters just add up amounts (messages, bytes, events).  Histograms
+// also keep the minimum, maximum and a power-of-two distribution of the
+// recorded values (bucket i holds values from 2^(i-1) up to 2^i - 1, with
+// bucket 0 holding zeroes).
+enum atMetricType
+{
+   AT_METRIC_COUNTER,
+   AT_METRIC_HISTOGRAM
+};
+
+
+// TYPES
+// The totals for one metric (summed across all threads)
+typedef struct
+{
+   char           name[AT_METRICS_MAX_NAME];
+   atMetricType   type;
+
+   uint64_t       count;
+   uint64_t       sum;
+   uint64_t       min;
+   uint64_t       max;
+   uint64_t       buckets[AT_METRICS_NUM_BUCKETS];
+} atMetricValue;
+
+
+// Everything recorded at a given moment
+typedef struct
+{
+   uint64_t        snapshot_time;
+   u_long          num_metrics;
+   atMetricValue   metrics[AT_METRICS_MAX_METRICS];
+} atMetricsSnapshot;
+
+
+// Lightweight performance counters and histograms.  Each thread records
+// into its own block of memory, so recording never takes a lock or
+// contends with other threads; snapshots add up the blocks of every
+// thread that has recorded something (values from threads that are
+// still running may be a few updates behind).  A reset doesn't touch
+// the blocks of running threads; each thread clears its own block the
+// next time it records something, and snapshots leave the block out
+// until then.
+//
+// ATLAS only records its own metrics when compiled with
+// __AT_METRICS_ENABLED__ (enableMetrics=yes for scons).  Otherwise, the
+// AT_METRICS_* macros below compile to nothing, and snapshots only show
+// what the application recorded by calling atMetrics directly.
+class ATLAS_SYM atMetrics
+{
+   public:
+      static atMetricID   registerCounter(const char * name);
+      static atMetricID   registerHistogram(const char * name);
+
+      static void         addCount(atMetricID id, uint64_t amount);
+      static void         recordValue(atMetricID id, uint64_t value);
+
+      static void         getSnapshot(atMetricsSnapshot * snapshot);
+      static uint64_t     getPercentile(atMetricValue * value,
+                                        double percentile);
+      static void         dump(FILE * output);
+      static void         reset();
+};
+
+
+// Records the time between its construction and destruction into a
+// histogram (meant to be declared on the stack at the top of the scope
+// being timed)
+class ATLAS_SYM atMetricsTimer
+{
+   private:
+      atMetricID   metric_id;
+      uint64_t     start_time;
+
+   public:
+      atMetricsTimer(atMetricID id);
+      ~atMetricsTimer();
+};
+
+
+// Instrumentation hooks for hot paths (these disappear completely when
+// metrics aren't enabled)
+#ifdef __AT_METRICS_ENABLED__
+   #define AT_METRICS_COUNT(id, amount)   atMetrics::addCount(id, amount)
+   #define AT_METRICS_RECORD(id, value)   atMetrics::recordValue(id, value)
+   #define AT_METRICS_TIMER(name, id)     atMetricsTimer name(id)
+#else
+   #define AT_METRICS_COUNT(id, amount)   ((void ) 0)
+   #define AT_METRICS_RECORD(id, value)   ((void ) 0)
+   #define AT_METRICS_TIMER(name, id)
+#endif
+
+
+#endif
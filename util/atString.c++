@@ -408,6 +408,27 @@ int atString::compare(atItem * otherItem)
 }
 
 
+u_long atString::getHashCode()
+{
+   u_long   hash;
+   char *   ch;
+
+   // FNV-1a hash of the characters (up to the terminator, since that's
+   // as far as equals() looks)
+   hash = 2166136261UL;
+   if (local_string != NULL)
+   {
+      for (ch = local_string; *ch != '\0'; ch++)
+      {
+         hash ^= (u_char ) *ch;
+         hash *= 16777619UL;
+      }
+   }
+
+   return hash;
+}
+
+
 atString & atString::operator=(const atString & stringToCopy)
 {
    // Avoid setting the string in the case of a self-assignment
@@ -73,6 +73,7 @@ class ATLAS_SYM atString : public atItem
 
       virtual bool           equals(atItem * otherItem);
       virtual int            compare(atItem * otherItem);
+      virtual u_long         getHashCode();
       
       virtual atString &     operator=(const atString & stringToCopy);
 };
@@ -352,6 +352,27 @@ int atStringBuffer::compare(atItem * otherItem)
 }
 
 
+u_long atStringBuffer::getHashCode()
+{
+   u_long   hash;
+   char *   ch;
+
+   // Use the same hash as atString (FNV-1a of the characters), since
+   // we're equal to an atString holding the same text
+   hash = 2166136261UL;
+   if (local_buffer != NULL)
+   {
+      for (ch = local_buffer; *ch != '\0'; ch++)
+      {
+         hash ^= (u_char ) *ch;
+         hash *= 16777619UL;
+      }
+   }
+
+   return hash;
+}
+
+
 atStringBuffer & atStringBuffer::operator=(const atString & stringToCopy)
 {
    // Copy the string from the given atString
@@ -375,4 +396,3 @@ atStringBuffer & atStringBuffer::operator=(
    // Return this object to allow for chaining assignment
    return *this;
 }
-
@@ -75,6 +75,7 @@ class ATLAS_SYM atStringBuffer : public atItem
 
       virtual bool               equals(atItem * otherItem);
       virtual int                compare(atItem * otherItem);
+      virtual u_long             getHashCode();
 
       virtual atStringBuffer &   operator=(const atString & stringToCopy);
       virtual atStringBuffer &   operator=(
@@ -0,0 +1,58 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AT_TASK_HPP
+#define AT_TASK_HPP
+
+
+#include "atNotifier.h++"
+#include "atOSDefs.h++"
+
+
+class atTaskGroup;
+
+
+// A piece of work for an atTaskPool.  Derive from this class and do the
+// work in run(), which may be called from any of the pool's threads.
+// Results can be left in the derived class and read back once the task's
+// group is done, so a task and its group together work like a future.
+class ATLAS_SYM atTask : public atNotifier
+{
+   protected:
+      atTaskGroup *   task_group;
+      bool            delete_when_done;
+
+      friend class atTaskPool;
+
+   public:
+      atTask();
+      virtual ~atTask();
+
+      virtual void   run() = 0;
+};
+
+
+#endif
@@ -0,0 +1,70 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "atTaskGroup.h++"
+
+
+atTaskGroup::atTaskGroup()
+{
+   // Nothing to wait for yet
+   pending_tasks = 0;
+}
+
+
+atTaskGroup::~atTaskGroup()
+{
+   // Tasks would be left pointing at a group that's gone
+   if (atomicLoad(&pending_tasks) != 0)
+      notify(AT_WARN, "Task group destroyed with tasks still pending.\n");
+}
+
+
+void atTaskGroup::addTask()
+{
+   // One more task to wait for
+   atomicAdd(&pending_tasks, 1);
+}
+
+
+void atTaskGroup::finishTask()
+{
+   // Count the task as done, and if it was the last one, wake up anyone
+   // sleeping in atTaskPool::wait()
+   if (atomicAdd(&pending_tasks, (uint32_t ) -1) == 1)
+      atomicWake(&pending_tasks);
+}
+
+
+u_long atTaskGroup::getNumPending()
+{
+   return atomicLoad(&pending_tasks);
+}
+
+
+bool atTaskGroup::isDone()
+{
+   return (atomicLoad(&pending_tasks) == 0);
+}
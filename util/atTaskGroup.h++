@@ -0,0 +1,58 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AT_TASK_GROUP_HPP
+#define AT_TASK_GROUP_HPP
+
+
+#include "atAtomic.h++"
+#include "atNotifier.h++"
+#include "atOSDefs.h++"
+
+
+// Counts the tasks submitted to an atTaskPool that haven't finished yet.
+// A group can be reused once it's done; use atTaskPool::wait() to wait
+// for it (which runs tasks while waiting, instead of just blocking).
+class ATLAS_SYM atTaskGroup : public atNotifier
+{
+   protected:
+      atAtomic   pending_tasks;
+
+      void       addTask();
+      void       finishTask();
+
+      friend class atTaskPool;
+
+   public:
+      atTaskGroup();
+      virtual ~atTaskGroup();
+
+      u_long     getNumPending();
+      bool       isDone();
+};
+
+
+#endif
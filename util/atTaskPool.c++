@@ -0,0 +1,653 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "atTaskPool.h++"
+#include "atThread.h++"
+
+
+// CONSTANTS
+#define AT_TASK_POOL_DEQUE_MASK    (AT_TASK_POOL_DEQUE_SIZE - 1)
+#define AT_TASK_POOL_CACHE_LINE    64
+
+// How many pieces (per thread) to split a range into when the caller
+// leaves the grain size up to us
+#define AT_TASK_POOL_PIECES        8
+
+
+// TYPES
+typedef atTask * volatile   atTaskSlot;
+
+// A worker thread and its deque (the last one in the pool belongs to
+// no thread and holds the tasks submitted from outside).  The owner works
+// at the bottom of the deque and thieves take from the top; the two ends
+// are kept on separate cache lines, as are the workers, so that threads
+// working on their own deques don't slow each other down
+struct atTaskWorker
+{
+   atAtomic       deque_top;
+   u_char         top_padding[AT_TASK_POOL_CACHE_LINE];
+   atAtomic       deque_bottom;
+   u_char         bottom_padding[AT_TASK_POOL_CACHE_LINE];
+
+   atTaskSlot *   deque_tasks;
+   atTaskPool *   task_pool;
+   u_long         worker_index;
+   uint32_t       steal_seed;
+   ThreadID       worker_thread;
+   bool           thread_started;
+   u_char         worker_padding[AT_TASK_POOL_CACHE_LINE];
+};
+
+// Runs one piece of a parallelFor(), handing off the upper half of its
+// range to the pool until what's left is no bigger than the grain size
+class atTaskPoolRange : public atTask
+{
+   protected:
+      atTaskPool *    task_pool;
+      atTaskGroup *   range_group;
+      atTaskRange *   range_body;
+      u_long          range_start;
+      u_long          range_end;
+      u_long          grain_size;
+
+   public:
+      atTaskPoolRange(atTaskPool * pool, atTaskGroup * group,
+                      atTaskRange * body, u_long start, u_long end,
+                      u_long grainSize, bool deleteWhenDone)
+      {
+         task_pool = pool;
+         range_group = group;
+         range_body = body;
+         range_start = start;
+         range_end = end;
+         grain_size = grainSize;
+         delete_when_done = deleteWhenDone;
+      }
+
+      virtual void run()
+      {
+         u_long   middle;
+
+         // The half we hand off goes on our own deque, where we'll find
+         // it again if nobody steals it first
+         while (range_end - range_start > grain_size)
+         {
+            middle = range_start + (range_end - range_start) / 2;
+            task_pool->submit(new atTaskPoolRange(task_pool, range_group,
+                                                  range_body, middle,
+                                                  range_end, grain_size,
+                                                  true),
+                              range_group);
+            range_end = middle;
+         }
+
+         // Do what's left ourselves
+         range_body->runRange(range_start, range_end);
+      }
+};
+
+// Runs one piece of a parallelReduce() on its own copy of the body
+class atTaskPoolReduce : public atTask
+{
+   protected:
+      atTaskReduce *   reduce_body;
+      u_long           range_start;
+      u_long           range_end;
+
+   public:
+      atTaskPoolReduce(atTaskReduce * body, u_long start, u_long end)
+      {
+         reduce_body = body;
+         range_start = start;
+         range_end = end;
+         delete_when_done = true;
+      }
+
+      virtual void run()
+      {
+         reduce_body->runRange(range_start, range_end);
+      }
+};
+
+
+// GLOBAL VARIABLES
+static ThreadOnce   at_task_pool_once = THREAD_ONCE_INITIALIZER;
+static ThreadKey    at_task_pool_key;
+
+
+// LOCAL FUNCTIONS
+static void createWorkerKey()
+{
+   // Each worker thread keeps a pointer to its atTaskWorker here
+   threadKeyCreate(&at_task_pool_key, NULL);
+}
+
+
+static u_long chooseGrainSize(u_long count, u_long numWorkers)
+{
+   u_long   grainSize;
+
+   // Give every thread (including the one waiting) several pieces, so
+   // there's something to steal when some pieces take longer than others
+   grainSize = count / ((numWorkers + 1) * AT_TASK_POOL_PIECES);
+   if (grainSize == 0)
+      return 1;
+   return grainSize;
+}
+
+
+static bool pushDeque(atTaskWorker * worker, atTask * task)
+{
+   uint32_t   bottom;
+   uint32_t   top;
+
+   // Only the owner pushes, so the bottom can't change under us (the top
+   // only moves up, so if anything we'll think the deque is fuller than
+   // it is)
+   bottom = atomicLoad(&worker->deque_bottom);
+   top = atomicLoad(&worker->deque_top);
+   if (bottom - top >= AT_TASK_POOL_DEQUE_SIZE)
+      return false;
+
+   // Store the task, then publish it by moving the bottom
+   worker->deque_tasks[bottom & AT_TASK_POOL_DEQUE_MASK] = task;
+   atomicStore(&worker->deque_bottom, bottom + 1);
+   return true;
+}
+
+
+static atTask * popDeque(atTaskWorker * worker)
+{
+   uint32_t   bottom;
+   uint32_t   top;
+   atTask *   task;
+
+   // Claim the bottom task before looking at the top, so a thief can't
+   // take it at the same time without one of us noticing
+   bottom = atomicLoad(&worker->deque_bottom) - 1;
+   atomicStore(&worker->deque_bottom, bottom);
+   atomicFence();
+   top = atomicLoad(&worker->deque_top);
+
+   // Put the bottom back if the deque was empty
+   if ((int32_t ) (bottom - top) < 0)
+   {
+      atomicStore(&worker->deque_bottom, bottom + 1);
+      return NULL;
+   }
+
+   // If there are other tasks, thieves can't reach this one
+   task = worker->deque_tasks[bottom & AT_TASK_POOL_DEQUE_MASK];
+   if (bottom != top)
+      return task;
+
+   // It's the last task, so race any thieves for it by taking it from the
+   // top as they would, then leave the deque empty either way
+   if (!atomicCompareAndSwap(&worker->deque_top, top, top + 1))
+      task = NULL;
+   atomicStore(&worker->deque_bottom, bottom + 1);
+   return task;
+}
+
+
+static atTask * stealDeque(atTaskWorker * worker)
+{
+   uint32_t   bottom;
+   uint32_t   top;
+   atTask *   task;
+
+   // See if there's anything to take
+   top = atomicLoad(&worker->deque_top);
+   atomicFence();
+   bottom = atomicLoad(&worker->deque_bottom);
+   if ((int32_t ) (bottom - top) <= 0)
+      return NULL;
+
+   // Read the top task and try to claim it.  If someone else got there
+   // first, we give up and let the caller look elsewhere (the slot may
+   // even have been reused by then, but what we read is thrown away)
+   task = worker->deque_tasks[top & AT_TASK_POOL_DEQUE_MASK];
+   if (!atomicCompareAndSwap(&worker->deque_top, top, top + 1))
+      return NULL;
+   return task;
+}
+
+
+atTaskPool::atTaskPool()
+{
+   // One worker for each processor except the one we're running on (the
+   // thread that waits for the work will help out)
+   initPool(getNumProcessors() - 1, false);
+}
+
+
+atTaskPool::atTaskPool(u_long numWorkers)
+{
+   // Start the given number of workers
+   initPool(numWorkers, false);
+}
+
+
+atTaskPool::atTaskPool(u_long numWorkers, bool pinWorkers)
+{
+   // Start the given number of workers, pinned to processors if requested
+   initPool(numWorkers, pinWorkers);
+}
+
+
+atTaskPool::~atTaskPool()
+{
+   atTask *   task;
+   u_long     i;
+
+   // Tell the workers to stop once they run out of tasks, and wake up any
+   // that are asleep
+   atomicStore(&shutting_down, 1);
+   atomicAdd(&work_signal, 1);
+   atomicWake(&work_signal);
+
+   // Wait for them to finish
+   for (i = 0; i < num_workers; i++)
+   {
+      if (task_workers[i].thread_started)
+         threadJoin(task_workers[i].worker_thread);
+   }
+
+   // Run anything still queued ourselves (all of it, if there were no
+   // workers), so every task is still deleted if it should be and counted
+   // against its group, and nobody waiting on a group is left hanging
+   while ((task = findTask(NULL)) != NULL)
+      runTask(task);
+
+   // Clean up the deques
+   for (i = 0; i <= num_workers; i++)
+      delete [] task_workers[i].deque_tasks;
+   delete [] task_workers;
+}
+
+
+void atTaskPool::initPool(u_long numWorkers, bool pinWorkers)
+{
+   atTaskWorker *   worker;
+   u_long           i;
+
+   // Make sure the key that tells workers apart from other threads exists
+   threadOnce(&at_task_pool_once, createWorkerKey);
+
+   // Nothing going on yet
+   num_workers = numWorkers;
+   pin_workers = pinWorkers;
+   submit_lock = 0;
+   work_signal = 0;
+   num_sleeping = 0;
+   shutting_down = 0;
+
+   // Set up a deque for each worker, plus one for tasks submitted from
+   // other threads
+   task_workers = new atTaskWorker[num_workers + 1];
+   for (i = 0; i <= num_workers; i++)
+   {
+      worker = &task_workers[i];
+      worker->deque_top = 0;
+      worker->deque_bottom = 0;
+      worker->deque_tasks = new atTaskSlot[AT_TASK_POOL_DEQUE_SIZE];
+      worker->task_pool = this;
+      worker->worker_index = i;
+      worker->steal_seed = (uint32_t ) (i + 1) * 2654435761u;
+      worker->thread_started = false;
+   }
+
+   // Start the workers
+   for (i = 0; i < num_workers; i++)
+   {
+      worker = &task_workers[i];
+      if (threadCreate(&worker->worker_thread, workerMain, worker))
+         worker->thread_started = true;
+      else
+         notify(AT_ERROR, "Unable to start task pool worker %lu.\n", i);
+   }
+}
+
+
+void * atTaskPool::workerMain(void * workerPtr)
+{
+   atTaskWorker *   worker;
+
+   // Hand off to the pool that owns this worker
+   worker = (atTaskWorker *) workerPtr;
+   worker->task_pool->runWorker(worker);
+   return NULL;
+}
+
+
+void atTaskPool::runWorker(atTaskWorker * worker)
+{
+   atTask *   task;
+   uint32_t   signal;
+   u_long     idleCount;
+
+   // Pin ourselves to a processor if asked to (leaving the first one for
+   // the thread that created the pool)
+   if (pin_workers)
+   {
+      if (!pinCurrentThread((worker->worker_index + 1) % getNumProcessors()))
+         notify(AT_WARN, "Unable to pin task pool worker %lu.\n",
+                worker->worker_index);
+   }
+
+   // Mark this thread as one of our workers, so tasks it submits go on
+   // its own deque
+   threadKeySet(at_task_pool_key, worker);
+
+   // Run tasks until the pool shuts down and there are none left
+   idleCount = 0;
+   while (true)
+   {
+      // Run anything we can find
+      task = findTask(worker);
+      if (task != NULL)
+      {
+         runTask(task);
+         idleCount = 0;
+         continue;
+      }
+
+      // Stop once the pool is shutting down and we're out of work (the
+      // other workers run whatever their own tasks add)
+      if (atomicLoad(&shutting_down) != 0)
+         break;
+
+      // Keep looking for a while, in case more work shows up soon
+      if (idleCount < AT_TASK_POOL_SPIN_COUNT)
+      {
+         idleCount++;
+         atomicPause();
+         continue;
+      }
+
+      // Go to sleep until more work is submitted.  We note the signal
+      // first and look one last time after counting ourselves as asleep,
+      // so anything submitted in between still wakes us up
+      signal = atomicLoad(&work_signal);
+      atomicAdd(&num_sleeping, 1);
+      atomicFence();
+      task = findTask(worker);
+      if ((task == NULL) && (atomicLoad(&shutting_down) == 0))
+         atomicWait(&work_signal, signal, AT_TASK_POOL_SLEEP_USECS);
+      atomicAdd(&num_sleeping, (uint32_t ) -1);
+
+      // If we woke up to nothing, we go straight back to sleep next time
+      if (task != NULL)
+      {
+         runTask(task);
+         idleCount = 0;
+      }
+   }
+
+   threadKeySet(at_task_pool_key, NULL);
+}
+
+
+atTaskWorker * atTaskPool::getCurrentWorker()
+{
+   atTaskWorker *   worker;
+
+   // Return our worker if this is one of our threads (NULL otherwise)
+   worker = (atTaskWorker *) threadKeyGet(at_task_pool_key);
+   if ((worker != NULL) && (worker->task_pool == this))
+      return worker;
+   return NULL;
+}
+
+
+void atTaskPool::pushTask(atTask * task)
+{
+   atTaskWorker *   worker;
+   bool             pushed;
+
+   // Workers push onto their own deques; everyone else shares the last
+   // one, taking turns being its owner
+   worker = getCurrentWorker();
+   if (worker != NULL)
+      pushed = pushDeque(worker, task);
+   else
+   {
+      while (!atomicCompareAndSwap(&submit_lock, 0, 1))
+         atomicPause();
+      pushed = pushDeque(&task_workers[num_workers], task);
+      atomicStore(&submit_lock, 0);
+   }
+
+   // Let the workers know, or just run the task now if there was no room
+   if (pushed)
+      signalWork();
+   else
+      runTask(task);
+}
+
+
+atTask * atTaskPool::findTask(atTaskWorker * worker)
+{
+   atTaskWorker *   victim;
+   atTask *         task;
+   u_long           first;
+   u_long           i;
+
+   // Our own tasks come first (newest first, as they're the most likely
+   // to still be in the cache)
+   if (worker != NULL)
+   {
+      task = popDeque(worker);
+      if (task != NULL)
+         return task;
+   }
+
+   // Then anything submitted from outside the pool
+   task = stealDeque(&task_workers[num_workers]);
+   if ((task != NULL) || (num_workers == 0))
+      return task;
+
+   // Then try stealing from the other workers, starting with a random one
+   // so that thieves spread out
+   first = 0;
+   if (worker != NULL)
+   {
+      worker->steal_seed ^= worker->steal_seed << 13;
+      worker->steal_seed ^= worker->steal_seed >> 17;
+      worker->steal_seed ^= worker->steal_seed << 5;
+      first = worker->steal_seed % num_workers;
+   }
+   for (i = 0; i < num_workers; i++)
+   {
+      victim = &task_workers[(first + i) % num_workers];
+      if (victim != worker)
+      {
+         task = stealDeque(victim);
+         if (task != NULL)
+            return task;
+      }
+   }
+
+   // Nothing to do
+   return NULL;
+}
+
+
+void atTaskPool::runTask(atTask * task)
+{
+   atTaskGroup *   group;
+
+   // Get what we need from the task first, as it may be gone once it's
+   // run (either deleted below or by whoever's waiting on the group)
+   group = task->task_group;
+   if (task->delete_when_done)
+   {
+      task->run();
+      delete task;
+   }
+   else
+      task->run();
+
+   // Count it as done
+   if (group != NULL)
+      group->finishTask();
+}
+
+
+void atTaskPool::signalWork()
+{
+   // Bump the signal, and wake up the sleeping workers if there are any
+   // (the fence makes sure a worker going to sleep sees either the new
+   // signal or that we saw it counted as asleep)
+   atomicAdd(&work_signal, 1);
+   atomicFence();
+   if (atomicLoad(&num_sleeping) > 0)
+      atomicWake(&work_signal);
+}
+
+
+u_long atTaskPool::getNumWorkers()
+{
+   return num_workers;
+}
+
+
+void atTaskPool::submit(atTask * task, atTaskGroup * group)
+{
+   // Count the task against its group (if any) before anyone can run it
+   task->task_group = group;
+   if (group != NULL)
+      group->addTask();
+
+   // Queue it up
+   pushTask(task);
+}
+
+
+void atTaskPool::wait(atTaskGroup * group)
+{
+   atTaskWorker *   worker;
+   atTask *         task;
+   uint32_t         pending;
+   u_long           idleCount;
+
+   // Help out with whatever tasks are around until the group is done
+   // (they may not be the group's own, but running them gets us there
+   // just as soon, and stops workers waiting on their own children from
+   // tying up the pool)
+   worker = getCurrentWorker();
+   idleCount = 0;
+   while ((pending = atomicLoad(&group->pending_tasks)) != 0)
+   {
+      task = findTask(worker);
+      if (task != NULL)
+      {
+         runTask(task);
+         idleCount = 0;
+      }
+      else if (idleCount < AT_TASK_POOL_SPIN_COUNT)
+      {
+         idleCount++;
+         atomicPause();
+      }
+      else
+      {
+         // The rest of the group's tasks are all running elsewhere, so
+         // sleep until the last one finishes (but check for new tasks
+         // now and then)
+         atomicWait(&group->pending_tasks, pending,
+                    AT_TASK_POOL_SLEEP_USECS / 10);
+      }
+   }
+}
+
+
+void atTaskPool::parallelFor(u_long start, u_long end, u_long grainSize,
+                             atTaskRange * body)
+{
+   atTaskGroup   group;
+
+   // Nothing to do for an empty range
+   if (end <= start)
+      return;
+   if (grainSize == 0)
+      grainSize = chooseGrainSize(end - start, num_workers);
+
+   // Split up the range from here (the pieces we hand off are split
+   // further by whoever picks them up), then wait for all the pieces
+   atTaskPoolRange root(this, &group, body, start, end, grainSize, false);
+   root.run();
+   wait(&group);
+}
+
+
+void atTaskPool::parallelReduce(u_long start, u_long end, u_long grainSize,
+                                atTaskReduce * body)
+{
+   atTaskGroup      group;
+   atTaskReduce **  bodies;
+   u_long           numPieces;
+   u_long           pieceStart;
+   u_long           pieceEnd;
+   u_long           i;
+
+   // Nothing to do for an empty range
+   if (end <= start)
+      return;
+   if (grainSize == 0)
+      grainSize = chooseGrainSize(end - start, num_workers);
+
+   // Give each piece its own body (the first piece uses the original)
+   numPieces = (end - start - 1) / grainSize + 1;
+   bodies = new atTaskReduce *[numPieces];
+   bodies[0] = body;
+   for (i = 1; i < numPieces; i++)
+      bodies[i] = body->split();
+
+   // Hand off all the pieces but the first, which we run ourselves, then
+   // wait for the rest
+   for (i = 1; i < numPieces; i++)
+   {
+      pieceStart = start + i * grainSize;
+      pieceEnd = pieceStart + grainSize;
+      if ((pieceEnd > end) || (pieceEnd < pieceStart))
+         pieceEnd = end;
+      submit(new atTaskPoolReduce(bodies[i], pieceStart, pieceEnd), &group);
+   }
+   pieceEnd = start + grainSize;
+   if ((pieceEnd > end) || (pieceEnd < start))
+      pieceEnd = end;
+   body->runRange(start, pieceEnd);
+   wait(&group);
+
+   // Fold the results together in order
+   for (i = 1; i < numPieces; i++)
+   {
+      body->join(bodies[i]);
+      delete bodies[i];
+   }
+   delete [] bodies;
+}
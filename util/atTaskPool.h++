@@ -0,0 +1,105 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AT_TASK_POOL_HPP
+#define AT_TASK_POOL_HPP
+
+
+#include "atAtomic.h++"
+#include "atNotifier.h++"
+#include "atOSDefs.h++"
+#include "atTask.h++"
+#include "atTaskGroup.h++"
+#include "atTaskRange.h++"
+
+
+// Tasks each worker's deque can hold (a power of two); tasks submitted
+// when a deque is full are just run on the spot
+#define AT_TASK_POOL_DEQUE_SIZE    4096
+
+// How many times an idle thread looks for work before going to sleep,
+// and how long it sleeps before looking again on its own
+#define AT_TASK_POOL_SPIN_COUNT    2000
+#define AT_TASK_POOL_SLEEP_USECS   10000
+
+
+struct atTaskWorker;
+
+
+// Runs tasks on a fixed set of worker threads.  Each worker has its own
+// deque of tasks: it pushes and pops tasks at one end, and idle workers
+// steal from the other end of someone else's.  Tasks submitted from
+// outside the pool go into a shared deque that every worker steals from.
+// Threads waiting on a group (including inside parallelFor() and
+// parallelReduce()) run tasks too, so a pool with no workers at all
+// simply runs everything on the waiting thread.  Destroying the pool
+// runs any tasks still queued before it returns.
+class ATLAS_SYM atTaskPool : public atNotifier
+{
+   protected:
+      atTaskWorker *   task_workers;
+      u_long           num_workers;
+      bool             pin_workers;
+
+      atAtomic         submit_lock;
+      atAtomic         work_signal;
+      atAtomic         num_sleeping;
+      atAtomic         shutting_down;
+
+      void             initPool(u_long numWorkers, bool pinWorkers);
+
+      static void *    workerMain(void * workerPtr);
+      void             runWorker(atTaskWorker * worker);
+
+      atTaskWorker *   getCurrentWorker();
+      void             pushTask(atTask * task);
+      atTask *         findTask(atTaskWorker * worker);
+      void             runTask(atTask * task);
+      void             signalWork();
+
+   public:
+      atTaskPool();
+      atTaskPool(u_long numWorkers);
+      atTaskPool(u_long numWorkers, bool pinWorkers);
+      virtual ~atTaskPool();
+
+      u_long           getNumWorkers();
+
+      void             submit(atTask * task, atTaskGroup * group);
+      void             wait(atTaskGroup * group);
+
+      // Run body over [start, end) in pieces of (at most) grainSize
+      // indices, returning once all of them are done.  A grain size of
+      // zero picks one based on the number of workers
+      void             parallelFor(u_long start, u_long end,
+                                   u_long grainSize, atTaskRange * body);
+      void             parallelReduce(u_long start, u_long end,
+                                      u_long grainSize,
+                                      atTaskReduce * body);
+};
+
+
+#endif
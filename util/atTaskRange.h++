@@ -0,0 +1,68 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AT_TASK_RANGE_HPP
+#define AT_TASK_RANGE_HPP
+
+
+#include "atNotifier.h++"
+#include "atOSDefs.h++"
+
+
+// The body of a parallel loop.  atTaskPool::parallelFor() splits its
+// index range into pieces and calls runRange() on each one from whichever
+// thread picks it up, so runRange() has to be safe to call on different
+// pieces at the same time.  Each call covers [start, end).
+class ATLAS_SYM atTaskRange : public atNotifier
+{
+   public:
+      atTaskRange();
+      virtual ~atTaskRange();
+
+      virtual void   runRange(u_long start, u_long end) = 0;
+};
+
+
+// The body of a parallel reduction.  atTaskPool::parallelReduce() gives
+// each piece of the range its own copy of the body, made with split()
+// (which should start the copy off at the identity value, e.g. zero for
+// a sum).  Once all the pieces are done, the copies are folded into the
+// original with join(), in index order, so for a given grain size the
+// result is the same on every run, no matter which threads ran which
+// pieces.  The pool deletes the copies.
+class ATLAS_SYM atTaskReduce : public atNotifier
+{
+   public:
+      atTaskReduce();
+      virtual ~atTaskReduce();
+
+      virtual atTaskReduce *   split() = 0;
+      virtual void             runRange(u_long start, u_long end) = 0;
+      virtual void             join(atTaskReduce * other) = 0;
+};
+
+
+#endif
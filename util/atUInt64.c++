@@ -77,3 +77,9 @@ int atUInt64::compare(atItem * otherItem)
    }
 }
 
+
+u_long atUInt64::getHashCode()
+{
+   // Fold the upper half in, in case u_long is only 32 bits
+   return (u_long ) (int_value ^ (int_value >> 32));
+}
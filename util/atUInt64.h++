@@ -21,6 +21,7 @@ class ATLAS_SYM atUInt64 : public atItem
 
       virtual bool       equals(atItem * otherItem);
       virtual int        compare(atItem * otherItem);
+      virtual u_long     getHashCode();
 };
 
 
@@ -26,40 +26,27 @@
 
 
 #include <string.h>
+#include <libxml/SAX2.h>
+#include <libxml/parserInternals.h>
 #include "atXMLBuffer.h++"
+#include "atMetrics.h++"
 
 
 atXMLBuffer::atXMLBuffer(char * xmlName)
 {
-   // Save the header and footer for this overall XML document
-   sprintf(xml_header, "<%s>", xmlName);
-   sprintf(xml_footer, "</%s>", xmlName);
-
-   // Initialize the internal XML buffer
-   xml_buffer = (u_char *) calloc(INITIAL_XML_DOCUMENT_SIZE, sizeof(u_char));
-   xml_buffer_len = 0;
-   xml_buffer_size = sizeof(xml_buffer);
+   // Set up the buffer for documents with the given root element
+   initBuffer(xmlName);
 
    // Initialize the xml DTD (we aren't using one in this case and also
    // don't need a context then)
    xml_dtd = NULL;
-
-   // Initialize the documents buffer (we will collect any documents
-   // from the XML elements into this list and send them back)
-   xml_document_list = new atList();
 }
 
 
 atXMLBuffer::atXMLBuffer(char * xmlName, char * dtdFilename)
 {
-   // Save the header and footer for this overall XML document
-   sprintf((char *) xml_header, "<%s>", xmlName);
-   sprintf((char *) xml_footer, "</%s>", xmlName);
-
-   // Initialize the internal XML buffer
-   xml_buffer = (u_char *) calloc(INITIAL_XML_DOCUMENT_SIZE, sizeof(u_char));
-   xml_buffer_len = 0;
-   xml_buffer_size = sizeof(xml_buffer);
+   // Set up the buffer for documents with the given root element
+   initBuffer(xmlName);
 
    // Open and initialize the DTD file (used for validating XML)
    xml_dtd = xmlParseDTD(NULL, (const xmlChar *) dtdFilename);
@@ -69,18 +56,28 @@ atXMLBuffer::atXMLBuffer(char * xmlName, char * dtdFilename)
    xml_context.userData = stderr;
    xml_context.error = (xmlValidityErrorFunc ) fprintf;
    xml_context.warning = (xmlValidityWarningFunc ) fprintf;
-
-   // Initialize the documents buffer (we will collect any documents
-   // from the XML elements into this list and send them back)
-   xml_document_list = new atList();
 }
 
 
 atXMLBuffer::~atXMLBuffer()
 {
-   // Free up the buffer
-   if (xml_buffer != NULL)
-      free(xml_buffer);
+   // Free up the parser
+   if (push_context != NULL)
+   {
+      if (push_context->myDoc != NULL)
+         xmlFreeDoc(push_context->myDoc);
+      xmlFreeParserCtxt(push_context);
+   }
+
+   // Free up the buffers
+   if (ring_buffer != NULL)
+      free(ring_buffer);
+   if (doc_buffer != NULL)
+      free(doc_buffer);
+   if (attr_list != NULL)
+      free(attr_list);
+   if (attr_text != NULL)
+      free(attr_text);
 
    // Free up the DTD if we created it
    if (xml_dtd != NULL)
@@ -88,34 +85,242 @@ atXMLBuffer::~atXMLBuffer()
 
    // Free up XML document list
    if (xml_document_list != NULL)
+   {
+      clearDocumentList();
       delete xml_document_list;
+   }
 }
 
 
-void atXMLBuffer::checkBufferSize(u_long sizeNeeded)
+void atXMLBuffer::initBuffer(char * xmlName)
 {
-   // Check to make sure buffer is large enough for what is needed
-   if (xml_buffer_size < sizeNeeded)
+   u_long   i;
+   int      k;
+
+   // Save the header and footer for this overall XML document
+   sprintf(xml_header, "<%s>", xmlName);
+   sprintf(xml_footer, "</%s>", xmlName);
+   sprintf(xml_root, "%s", xmlName);
+   footer_len = strlen(xml_footer);
+
+   // Build the failure table for matching the footer (so the footer can
+   // be found a byte at a time, without ever going back over the data)
+   footer_table[0] = 0;
+   k = 0;
+   for (i = 1; i < footer_len; i++)
    {
-      // It isn't so re-allocate and track the new size (note that
-      // xml_buffer_len will remain the same)
-      xml_buffer = (u_char *) realloc(xml_buffer, 
-                                      2 * sizeNeeded * sizeof(u_char));
-      xml_buffer_size = sizeof(xml_buffer);
+      while ((k > 0) && (xml_footer[i] != xml_footer[k]))
+         k = footer_table[k - 1];
+      if (xml_footer[i] == xml_footer[k])
+         k++;
+      footer_table[i] = k;
    }
+   footer_matched = 0;
+
+   // Initialize the buffer of pending data (it's a ring, so data doesn't
+   // have to be moved as documents are taken off the front)
+   ring_buffer = (u_char *) malloc(INITIAL_XML_DOCUMENT_SIZE);
+   ring_size = INITIAL_XML_DOCUMENT_SIZE;
+   ring_head = 0;
+   ring_tail = 0;
+   scan_pos = 0;
+   between_documents = true;
+   doc_buffer = NULL;
+   doc_buffer_size = 0;
+
+   // Initialize the documents buffer (we will collect any documents
+   // from the XML elements into this list and send them back)
+   xml_document_list = new atList();
+
+   // Streaming mode is off until asked for
+   streaming_mode = false;
+   build_documents = true;
+   xml_handler = NULL;
+   push_context = NULL;
+   document_started = false;
+   document_wrong_type = false;
+   element_depth = 0;
+   attr_list = NULL;
+   attr_list_size = 0;
+   attr_text = NULL;
+   attr_text_size = 0;
 }
 
 
-void atXMLBuffer::processXMLDocument()
+void atXMLBuffer::enableStreaming(atXMLHandler * handler, bool buildDocuments)
 {
-   xmlDocPtr         doc;
-   xmlNodePtr        current;
-   char              fullHeader[256];
-   xmlChar *         version;
-   atXMLDocument *   xmlDoc;
+   // Throw away any parser we have (it'll be created again with the new
+   // settings at the start of the next document)
+   if ((push_context != NULL) && (!document_started))
+   {
+      xmlFreeParserCtxt(push_context);
+      push_context = NULL;
+   }
+   else if (push_context != NULL)
+      notify(AT_WARN, "Changing XML streaming mode in mid-document.\n");
+
+   // Save the settings
+   streaming_mode = true;
+   xml_handler = handler;
+   build_documents = buildDocuments;
+}
+
+
+void atXMLBuffer::disableStreaming()
+{
+   // Go back to collecting whole documents (any document in progress
+   // is lost, since the parser has already consumed it)
+   if (push_context != NULL)
+   {
+      if (push_context->myDoc != NULL)
+         xmlFreeDoc(push_context->myDoc);
+      xmlFreeParserCtxt(push_context);
+      push_context = NULL;
+   }
+   if (document_started)
+   {
+      ring_head = scan_pos;
+      footer_matched = 0;
+      between_documents = true;
+      document_started = false;
+   }
+   streaming_mode = false;
+   xml_handler = NULL;
+   build_documents = true;
+}
+
+
+bool atXMLBuffer::isStreaming()
+{
+   return streaming_mode;
+}
+
+
+void atXMLBuffer::appendToRing(u_char * data, u_long len)
+{
+   u_long     pending;
+   u_long     newSize;
+   u_char *   newRing;
+   u_long     index;
+   u_long     chunk;
+
+   // Grow the ring if the new data won't fit (the data is straightened
+   // out as it's copied, so it starts at the beginning of the new ring)
+   pending = ring_tail - ring_head;
+   if (pending + len > ring_size)
+   {
+      newSize = ring_size;
+      while (newSize < pending + len)
+         newSize *= 2;
+      newRing = (u_char *) malloc(newSize);
+      index = ring_head & (ring_size - 1);
+      chunk = ring_size - index;
+      if (chunk > pending)
+         chunk = pending;
+      memcpy(newRing, &ring_buffer[index], chunk);
+      memcpy(&newRing[chunk], ring_buffer, pending - chunk);
+      free(ring_buffer);
+      ring_buffer = newRing;
+      ring_size = newSize;
+      scan_pos -= ring_head;
+      ring_head = 0;
+      ring_tail = pending;
+   }
+
+   // Copy the data in (in two pieces if it wraps around the end)
+   index = ring_tail & (ring_size - 1);
+   chunk = ring_size - index;
+   if (chunk > len)
+      chunk = len;
+   memcpy(&ring_buffer[index], data, chunk);
+   memcpy(ring_buffer, &data[chunk], len - chunk);
+   ring_tail += len;
+}
+
+
+void atXMLBuffer::consumeRing(u_long endPos)
+{
+   // Drop everything before the given position
+   ring_head = endPos;
 
-   // Open the memory buffer as an XML document
-   doc = xmlParseMemory((const char *) xml_buffer, xml_buffer_len);
+   // Once the ring is empty, start over at the beginning (this keeps
+   // most documents from wrapping around the end)
+   if (ring_head == ring_tail)
+   {
+      scan_pos -= ring_head;
+      ring_head = 0;
+      ring_tail = 0;
+   }
+}
+
+
+void atXMLBuffer::pushToParser(u_long endPos, bool lastChunk)
+{
+   u_long   index;
+   u_long   chunk;
+   u_long   len;
+
+   // Time the parsing
+   AT_METRICS_TIMER(parseTimer, AT_METRIC_XML_PARSE_TIME);
+
+   // Hand the data from the head of the ring up to the given position to
+   // the parser (in two pieces if it wraps around the end)
+   len = endPos - ring_head;
+   index = ring_head & (ring_size - 1);
+   chunk = ring_size - index;
+   if (chunk >= len)
+   {
+      xmlParseChunk(push_context, (const char *) &ring_buffer[index], len,
+                    lastChunk);
+   }
+   else
+   {
+      xmlParseChunk(push_context, (const char *) &ring_buffer[index], chunk,
+                    0);
+      xmlParseChunk(push_context, (const char *) ring_buffer, len - chunk,
+                    lastChunk);
+   }
+
+   // The parser keeps its own copy, so we're done with this data
+   consumeRing(endPos);
+}
+
+
+u_char * atXMLBuffer::getDocumentText(u_long endPos, u_long * len)
+{
+   u_long   index;
+   u_long   chunk;
+
+   // If the document doesn't wrap around the end of the ring, it can be
+   // used right where it is
+   *len = endPos - ring_head;
+   index = ring_head & (ring_size - 1);
+   chunk = ring_size - index;
+   if (chunk >= *len)
+      return &ring_buffer[index];
+
+   // Otherwise, copy it out in one piece
+   if (doc_buffer_size < *len)
+   {
+      free(doc_buffer);
+      doc_buffer = (u_char *) malloc(*len);
+      doc_buffer_size = *len;
+   }
+   memcpy(doc_buffer, &ring_buffer[index], chunk);
+   memcpy(&doc_buffer[chunk], ring_buffer, *len - chunk);
+   return doc_buffer;
+}
+
+
+void atXMLBuffer::processXMLDocument(u_char * text, u_long len)
+{
+   xmlDocPtr   doc;
+
+   // Open the memory buffer as an XML document (timing the parsing)
+   {
+      AT_METRICS_TIMER(parseTimer, AT_METRIC_XML_PARSE_TIME);
+      doc = xmlParseMemory((const char *) text, len);
+   }
 
    // Check to make sure the XML library understood the buffer
    if (doc == NULL)
@@ -125,6 +330,19 @@ void atXMLBuffer::processXMLDocument()
       return;
    }
 
+   // Count the document, then check it and add it to the list
+   AT_METRICS_COUNT(AT_METRIC_XML_DOCUMENTS, 1);
+   finishXMLDocument(doc);
+}
+
+
+void atXMLBuffer::finishXMLDocument(xmlDocPtr doc)
+{
+   xmlNodePtr        current;
+   char              fullHeader[256];
+   xmlChar *         version;
+   atXMLDocument *   xmlDoc;
+
    // Check to see if we're checking the XML against the DTD
    if (xml_dtd != NULL)
    {
@@ -176,58 +394,11 @@ void atXMLBuffer::processXMLDocument()
 }
 
 
-atList * atXMLBuffer::processBuffer(atBufferHandler * packetBuffer)
+void atXMLBuffer::clearDocumentList()
 {
-   u_char *   buffer;
-   u_long     lengthRead;
-   u_char *   nextNull;
-   u_char *   newBuffer;
    atItem *   item;
-   u_char *   endTag;
-   int        partialChunkSize;
-   u_long     numWhiteSpace;
 
-   // Get the info from this buffer
-   packetBuffer->retrieveBuffer(&buffer, &lengthRead);
-
-   // Go through and eradicate NULL characters (the XML library will
-   // consider it the end of the document)
-   nextNull = (u_char *) memchr(buffer, '\0', lengthRead);
-   while (nextNull != NULL)
-   {
-      // Slide the buffer up one to get rid of this NULL
-      memmove(nextNull, nextNull+1, lengthRead - (nextNull - buffer));
-      lengthRead--;
- 
-      // Find the next NULL
-      nextNull = (u_char *) memchr(buffer, '\0', lengthRead);
-   }
-
-   // Allocate a buffer to hold this buffer and left over from the last pass
-   newBuffer = (u_char *) calloc(xml_buffer_len+lengthRead+1, sizeof(u_char));
-   if (newBuffer == NULL)
-   {
-      // We failed to allocate space (bad!) so assume we have nothing
-      notify(AT_WARN, "Failed to allocate space for combining buffers.\n");
-      lengthRead = 0;
-   }
-   else
-   {
-      // Stick any partial buffer that was saved last go around in front
-      // of the new buffer (this is necessary to cover the case when the
-      // end tag footer gets split between packets)
-      memcpy(newBuffer, xml_buffer, xml_buffer_len);
-      memcpy(&newBuffer[xml_buffer_len], buffer, lengthRead);
-      lengthRead += xml_buffer_len;
-      xml_buffer_len = 0;
-   }
-
-   // Make a string out of the buffer
-   newBuffer[lengthRead] = '\0';
-
-   // We will build up each recognized XML document and add it to a list
-   // to return to the user so we need to clear it first (so go through
-   // each list item in the list now and remove it)
+   // Go through each list item in the list now and remove it
    item = xml_document_list->getFirstEntry();
    while (item != NULL)
    {
@@ -241,78 +412,504 @@ atList * atXMLBuffer::processBuffer(atBufferHandler * packetBuffer)
       // Get the first node again (if there is one)
       item = xml_document_list->getFirstEntry();
    }
+}
 
-   // Check if we see the ending footer
-   endTag = (u_char *) strstr((const char *) newBuffer, xml_footer);
-   if (endTag != NULL)
+
+void atXMLBuffer::startPushDocument()
+{
+   xmlSAXHandler   sax;
+
+   // Reuse the parser from the last document if we have one
+   if (push_context != NULL)
+      xmlCtxtResetPush(push_context, NULL, 0, NULL, NULL);
+   else
    {
-      // We need to loop in case there are multiple documents within 
-      // the buffer
-      while (endTag != NULL)
+      // Start with libxml2's own handlers (which build the document tree)
+      // if we're building documents, or with nothing if we aren't, then
+      // add ours on top
+      if (build_documents)
+         xmlSAXVersion(&sax, 2);
+      else
       {
-         // Copy through the ending footer to the internal
-         // collected xml buffer
-         partialChunkSize = (int ) (endTag - &newBuffer[0]) + 
-                            (int ) strlen(xml_footer);
-         checkBufferSize(xml_buffer_len + partialChunkSize);
-         memcpy(&xml_buffer[xml_buffer_len], newBuffer, partialChunkSize);
-         xml_buffer_len += partialChunkSize;
-
-         // Delete the part we just used (+1 for the NULL we tacked on)
-         memmove(&newBuffer[0], &newBuffer[partialChunkSize], 
-                 lengthRead - partialChunkSize + 1);
-         lengthRead -= partialChunkSize;
-
-         // Eliminate any leading white space lines left in the buffer
-         numWhiteSpace = (u_long ) strspn((const char *) newBuffer, " \r\n\t");
-         if ( (numWhiteSpace > 0) && (numWhiteSpace <= lengthRead) )
-         {
-            // Move up the remaining part of the buffer (+1 for the NULL
-            // we tacked on)
-            memmove(&newBuffer[0], &newBuffer[numWhiteSpace],
-                    (lengthRead - numWhiteSpace + 1) * sizeof(u_char));
-            lengthRead -= numWhiteSpace;
-         }
+         memset(&sax, 0, sizeof(sax));
+         sax.initialized = XML_SAX2_MAGIC;
+         sax.error = xmlParserError;
+         sax.fatalError = xmlParserError;
+
+         // Keep track of entity declarations, though, so documents that
+         // declare entities still parse (references to them are just
+         // skipped, as there's no tree to put them in)
+         sax.entityDecl = xmlSAX2EntityDecl;
+         sax.getEntity = xmlSAX2GetEntity;
+      }
+      sax.startDocument = saxStartDocument;
+      sax.internalSubset = saxInternalSubset;
+      sax.startElementNs = saxStartElement;
+      sax.endElementNs = saxEndElement;
+      sax.characters = saxCharacters;
+      sax.cdataBlock = saxCDataBlock;
+
+      // Create the parser (we'll feed it data as it arrives)
+      push_context = xmlCreatePushParserCtxt(&sax, NULL, NULL, 0, NULL);
+      if (push_context == NULL)
+      {
+         notify(AT_ERROR, "Unable to create XML push parser.\n");
+         return;
+      }
+   }
+
+   // Let our handlers find us from the parser
+   push_context->_private = this;
+
+   // Start tracking the new document
+   document_started = true;
+   document_wrong_type = false;
+   element_depth = 0;
+}
+
+
+void atXMLBuffer::endPushDocument()
+{
+   xmlDocPtr         doc;
+   bool              wellFormed;
+   atXMLDocument *   xmlDoc;
+   u_long            numDocs;
+
+   // Take the document (if one was built) from the parser.  If we aren't
+   // building documents, any document the parser has is just there to
+   // hold the declarations, so we don't want it
+   doc = push_context->myDoc;
+   push_context->myDoc = NULL;
+   if ((!build_documents) && (doc != NULL))
+   {
+      xmlFreeDoc(doc);
+      doc = NULL;
+   }
+   wellFormed = (push_context->wellFormed != 0);
+   document_started = false;
 
-         // Process the document
-         processXMLDocument();
+   // Count the document (if the parser understood it)
+   if (wellFormed)
+      AT_METRICS_COUNT(AT_METRIC_XML_DOCUMENTS, 1);
 
-         // Clear the internal xml buffer
-         xml_buffer_len = 0;
+   // Make sure the document was good
+   xmlDoc = NULL;
+   if ((!wellFormed) || (document_wrong_type))
+   {
+      if (!wellFormed)
+         notify(AT_WARN, "XML document not parsed successfully.\n");
+      else
+         notify(AT_WARN, "XML document is of wrong type.\n");
+      if (doc != NULL)
+         xmlFreeDoc(doc);
+   }
+   else if (doc != NULL)
+   {
+      // Check it like any other document and see if it made it into
+      // the list
+      numDocs = xml_document_list->getNumEntries();
+      finishXMLDocument(doc);
+      if (xml_document_list->getNumEntries() > numDocs)
+         xmlDoc = (atXMLDocument *) xml_document_list->getLastEntry();
+   }
 
-         // See if there is another footer (in case there are two
-         // or more within the buffer)
-         endTag = (u_char *) strstr((const char *) newBuffer, xml_footer);
+   // Let the handler know the document is done
+   if ((xml_handler != NULL) && (wellFormed) && (!document_wrong_type))
+      xml_handler->endDocument(xmlDoc);
+}
+
+
+u_long atXMLBuffer::decodeAttributeValue(char * dest, const xmlChar * start,
+                                         const xmlChar * end)
+{
+   static const struct
+   {
+      const char *   name;
+      int            len;
+      char           value;
+   } predefined[] = { { "amp;", 4, '&' }, { "lt;", 3, '<' },
+                      { "gt;", 3, '>' }, { "quot;", 5, '"' },
+                      { "apos;", 5, '\'' } };
+   const xmlChar *   src;
+   const xmlChar *   semicolon;
+   u_long            len;
+   int               value;
+   int               digit;
+   int               i;
+
+   // The parser leaves some references in attribute values undecoded
+   // ("&amp;" comes through as "&#38;", for one).  We don't ask it to
+   // substitute entities itself, as that would also have it pull in
+   // external entities named by the document, so the predefined entities
+   // and character references are decoded here instead (none of them is
+   // shorter than what it decodes to, so the value never grows).  Any
+   // other reference is left as it is
+   src = start;
+   len = 0;
+   while (src < end)
+   {
+      // Copy anything that isn't the start of a reference
+      if (*src != '&')
+      {
+         dest[len++] = *src++;
+         continue;
       }
 
-      // Store remaining chunk (if any) in internal collected xml buffer
-      if (lengthRead > 0)
+      // Find the end of the reference
+      semicolon = src + 1;
+      while ((semicolon < end) && (*semicolon != ';'))
+         semicolon++;
+      if (semicolon >= end)
       {
-         // Copy remaining chunk into xml buffer and initialize
-         // size to size of that remaining chunk
-         checkBufferSize(lengthRead);
-         memcpy(&xml_buffer[0], &newBuffer[0], lengthRead);
-         xml_buffer_len = lengthRead;
+         dest[len++] = *src++;
+         continue;
+      }
+
+      // Decode character references (decimal or hex) into UTF-8
+      if (src[1] == '#')
+      {
+         value = 0;
+         if ((src + 2 < semicolon) && (src[2] == 'x'))
+         {
+            for (i = 3; (src + i < semicolon) && (value >= 0); i++)
+            {
+               if ((src[i] >= '0') && (src[i] <= '9'))
+                  digit = src[i] - '0';
+               else if ((src[i] >= 'a') && (src[i] <= 'f'))
+                  digit = src[i] - 'a' + 10;
+               else if ((src[i] >= 'A') && (src[i] <= 'F'))
+                  digit = src[i] - 'A' + 10;
+               else
+                  digit = -1;
+               if ((digit < 0) || (value > 0x10FFFF))
+                  value = -1;
+               else
+                  value = value * 16 + digit;
+            }
+            if (i == 3)
+               value = -1;
+         }
+         else
+         {
+            for (i = 2; (src + i < semicolon) && (value >= 0); i++)
+            {
+               if ((src[i] < '0') || (src[i] > '9') || (value > 0x10FFFF))
+                  value = -1;
+               else
+                  value = value * 10 + (src[i] - '0');
+            }
+            if (i == 2)
+               value = -1;
+         }
+
+         // Only pass along characters XML allows (anything else is left
+         // as the reference)
+         if ((value > 0) && (value <= 0x10FFFF) &&
+             ((value < 0xD800) || (value > 0xDFFF)))
+         {
+            len += xmlCopyCharMultiByte((xmlChar *) &dest[len], value);
+            src = semicolon + 1;
+            continue;
+         }
       }
       else
       {
-         // Nothing left in buffer so just initialize xml buffer
-         xml_buffer[0] = '\0';
-         xml_buffer_len = 0;
+         // Decode the predefined entities
+         for (i = 0; i < (int ) (sizeof(predefined) / sizeof(predefined[0]));
+              i++)
+         {
+            if ((semicolon - src == predefined[i].len) &&
+                (strncmp((const char *) src + 1, predefined[i].name,
+                         predefined[i].len) == 0))
+               break;
+         }
+         if (i < (int ) (sizeof(predefined) / sizeof(predefined[0])))
+         {
+            dest[len++] = predefined[i].value;
+            src = semicolon + 1;
+            continue;
+         }
       }
+
+      // Not something we decode, so keep the ampersand and carry on
+      dest[len++] = *src++;
    }
-   else
+
+   return len;
+}
+
+
+void atXMLBuffer::saxStartDocument(void * ctx)
+{
+   xmlParserCtxtPtr   context;
+   atXMLBuffer *      buffer;
+
+   // Build the document if asked to
+   context = (xmlParserCtxtPtr ) ctx;
+   buffer = (atXMLBuffer *) context->_private;
+   if (buffer->build_documents)
+      xmlSAX2StartDocument(ctx);
+
+   // Tell the handler
+   if (buffer->xml_handler != NULL)
+      buffer->xml_handler->startDocument();
+}
+
+
+void atXMLBuffer::saxInternalSubset(void * ctx, const xmlChar * name,
+                                    const xmlChar * externalID,
+                                    const xmlChar * systemID)
+{
+   xmlParserCtxtPtr   context;
+   atXMLBuffer *      buffer;
+
+   // The parser keeps the document's declarations in the document tree,
+   // so if we aren't building documents, start one now just to hold them
+   // (it's thrown away when the document ends)
+   context = (xmlParserCtxtPtr ) ctx;
+   buffer = (atXMLBuffer *) context->_private;
+   if ((!buffer->build_documents) && (context->myDoc == NULL))
+      xmlSAX2StartDocument(ctx);
+
+   // Record the declarations
+   xmlSAX2InternalSubset(ctx, name, externalID, systemID);
+}
+
+
+void atXMLBuffer::saxStartElement(void * ctx, const xmlChar * localName,
+                                  const xmlChar * prefix, const xmlChar * uri,
+                                  int numNamespaces,
+                                  const xmlChar ** namespaces,
+                                  int numAttributes, int numDefaulted,
+                                  const xmlChar ** attributes)
+{
+   xmlParserCtxtPtr   context;
+   atXMLBuffer *      buffer;
+   u_long             textSize;
+   u_long             offset;
+   u_long             valueLen;
+   int                i;
+
+   // Make sure the root element is the one we're expecting (we don't
+   // pass along anything from documents of the wrong type)
+   context = (xmlParserCtxtPtr ) ctx;
+   buffer = (atXMLBuffer *) context->_private;
+   if ((buffer->element_depth == 0) &&
+       (strcmp((char *) localName, buffer->xml_root) != 0))
+      buffer->document_wrong_type = true;
+   buffer->element_depth++;
+
+   // Build the document if asked to
+   if (buffer->build_documents)
+      xmlSAX2StartElementNs(ctx, localName, prefix, uri, numNamespaces,
+                            namespaces, numAttributes, numDefaulted,
+                            attributes);
+
+   // Nothing more to do without a handler
+   if ((buffer->xml_handler == NULL) || (buffer->document_wrong_type))
+      return;
+
+   // The parser gives attribute values as pointers to the start and end
+   // of the text, so copy them out into a NULL-terminated name/value
+   // list for the handler (the space is kept from call to call)
+   if (buffer->attr_list_size < (u_long ) (numAttributes * 2 + 2))
+   {
+      buffer->attr_list_size = numAttributes * 2 + 2;
+      buffer->attr_list = (char **) 
+         realloc(buffer->attr_list, buffer->attr_list_size * sizeof(char *));
+   }
+   textSize = 0;
+   for (i = 0; i < numAttributes; i++)
+      textSize += (attributes[i*5 + 4] - attributes[i*5 + 3]) + 1;
+   if (buffer->attr_text_size < textSize)
+   {
+      buffer->attr_text_size = textSize;
+      buffer->attr_text = (char *) realloc(buffer->attr_text, textSize);
+   }
+   offset = 0;
+   for (i = 0; i < numAttributes; i++)
    {
-      // No ending found so just add what we received to the
-      // internal collected xml buffer
-      checkBufferSize(xml_buffer_len + lengthRead);
-      memcpy(&xml_buffer[xml_buffer_len], newBuffer, lengthRead);
-      xml_buffer_len += lengthRead;
+      valueLen = decodeAttributeValue(&buffer->attr_text[offset],
+                                      attributes[i*5 + 3],
+                                      attributes[i*5 + 4]);
+      buffer->attr_text[offset + valueLen] = '\0';
+      buffer->attr_list[i*2] = (char *) attributes[i*5];
+      buffer->attr_list[i*2 + 1] = &buffer->attr_text[offset];
+      offset += valueLen + 1;
+   }
+   buffer->attr_list[numAttributes*2] = NULL;
+   buffer->attr_list[numAttributes*2 + 1] = NULL;
+
+   // Tell the handler
+   buffer->xml_handler->startElement((char *) localName, buffer->attr_list);
+}
+
+
+void atXMLBuffer::saxEndElement(void * ctx, const xmlChar * localName,
+                                const xmlChar * prefix, const xmlChar * uri)
+{
+   xmlParserCtxtPtr   context;
+   atXMLBuffer *      buffer;
+
+   // Build the document if asked to
+   context = (xmlParserCtxtPtr ) ctx;
+   buffer = (atXMLBuffer *) context->_private;
+   buffer->element_depth--;
+   if (buffer->build_documents)
+      xmlSAX2EndElementNs(ctx, localName, prefix, uri);
+
+   // Tell the handler
+   if ((buffer->xml_handler != NULL) && (!buffer->document_wrong_type))
+      buffer->xml_handler->endElement((char *) localName);
+}
+
+
+void atXMLBuffer::saxCharacters(void * ctx, const xmlChar * text, int len)
+{
+   xmlParserCtxtPtr   context;
+   atXMLBuffer *      buffer;
+
+   // Build the document if asked to
+   context = (xmlParserCtxtPtr ) ctx;
+   buffer = (atXMLBuffer *) context->_private;
+   if (buffer->build_documents)
+      xmlSAX2Characters(ctx, text, len);
+
+   // Tell the handler
+   if ((buffer->xml_handler != NULL) && (!buffer->document_wrong_type))
+      buffer->xml_handler->characters((char *) text, len);
+}
+
+
+void atXMLBuffer::saxCDataBlock(void * ctx, const xmlChar * text, int len)
+{
+   xmlParserCtxtPtr   context;
+   atXMLBuffer *      buffer;
+
+   // Build the document if asked to
+   context = (xmlParserCtxtPtr ) ctx;
+   buffer = (atXMLBuffer *) context->_private;
+   if (buffer->build_documents)
+      xmlSAX2CDataBlock(ctx, text, len);
+
+   // Tell the handler (CDATA is just more text as far as it's concerned)
+   if ((buffer->xml_handler != NULL) && (!buffer->document_wrong_type))
+      buffer->xml_handler->characters((char *) text, len);
+}
+
+
+atList * atXMLBuffer::processBuffer(atBufferHandler * packetBuffer)
+{
+   u_char *   buffer;
+   u_long     lengthRead;
+
+   // Get the info from this buffer and process it
+   packetBuffer->retrieveBuffer(&buffer, &lengthRead);
+   return processData(buffer, lengthRead);
+}
+
+
+atList * atXMLBuffer::processData(u_char * data, u_long len)
+{
+   u_char *   nextNull;
+   u_char *   end;
+   u_char     ch;
+   u_long     docLen;
+   u_char *   docText;
+   u_long     index;
+   u_long     chunk;
+   u_char *   next;
+
+   // We will build up each recognized XML document and add it to a list
+   // to return to the user so we need to clear it first
+   clearDocumentList();
+
+   // Add the data to the pending data, leaving out any NULL characters
+   // (the XML library will consider it the end of the document)
+   end = data + len;
+   while (data < end)
+   {
+      nextNull = (u_char *) memchr(data, '\0', end - data);
+      if (nextNull == NULL)
+         nextNull = end;
+      appendToRing(data, nextNull - data);
+      data = nextNull + 1;
+   }
+
+   // Go through the new data (each byte is only looked at once, no
+   // matter how many pieces the documents arrive in)
+   while (scan_pos < ring_tail)
+   {
+      // Skip any white space between documents
+      ch = ring_buffer[scan_pos & (ring_size - 1)];
+      if (between_documents)
+      {
+         if ((ch == ' ') || (ch == '\r') || (ch == '\n') || (ch == '\t'))
+         {
+            scan_pos++;
+            consumeRing(scan_pos);
+            continue;
+         }
+
+         // Something else, so this is the start of a document
+         between_documents = false;
+         if (streaming_mode)
+            startPushDocument();
+      }
+
+      // If we're not part way into the footer, skip straight to the next
+      // place it could start (as far as the ring goes without wrapping)
+      if (footer_matched == 0)
+      {
+         index = scan_pos & (ring_size - 1);
+         chunk = ring_size - index;
+         if (chunk > ring_tail - scan_pos)
+            chunk = ring_tail - scan_pos;
+         next = (u_char *) memchr(&ring_buffer[index], xml_footer[0], chunk);
+         if (next == NULL)
+         {
+            scan_pos += chunk;
+            continue;
+         }
+         scan_pos += next - &ring_buffer[index];
+         ch = *next;
+      }
+
+      // Track how much of the footer we've matched so far
+      while ((footer_matched > 0) && (ch != xml_footer[footer_matched]))
+         footer_matched = footer_table[footer_matched - 1];
+      if (ch == xml_footer[footer_matched])
+         footer_matched++;
+      scan_pos++;
+
+      // If we've seen the whole footer, the document is complete
+      if (footer_matched == footer_len)
+      {
+         if ((streaming_mode) && (push_context != NULL))
+         {
+            // Give the parser the rest of the document and finish it
+            pushToParser(scan_pos, true);
+            endPushDocument();
+         }
+         else
+         {
+            // Parse the whole document at once
+            docText = getDocumentText(scan_pos, &docLen);
+            processXMLDocument(docText, docLen);
+            consumeRing(scan_pos);
+         }
+
+         // Look for the next one
+         footer_matched = 0;
+         between_documents = true;
+      }
    }
 
-   // Free the temporary buffer
-   if (newBuffer != NULL)
-      free(newBuffer);
+   // In streaming mode, hand the parser whatever we have of the current
+   // document now rather than waiting for the end of it
+   if ((streaming_mode) && (push_context != NULL) && (document_started) &&
+       (ring_head < scan_pos))
+      pushToParser(scan_pos, false);
 
    // Return the list of documents that were collected
    return xml_document_list;
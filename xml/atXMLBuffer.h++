@@ -37,43 +37,108 @@
 #include "atOSDefs.h++"
 
 #include "atXMLDocument.h++"
+#include "atXMLHandler.h++"
 #include "atBufferHandler.h++"
 
 #include "atString.h++"
 
 
-#define INITIAL_XML_DOCUMENT_SIZE    2000000
+#define INITIAL_XML_DOCUMENT_SIZE    65536
 #define MAX_XML_TAG_SIZE         256
 
 
 class ATLAS_SYM atXMLBuffer : public atNotifier
 {
    protected:
-      u_char *       xml_buffer;
-      u_long         xml_buffer_len;
-      u_long         xml_buffer_size;
-
-      char           xml_header[MAX_XML_TAG_SIZE];
-      char           xml_footer[MAX_XML_TAG_SIZE];
-
-      xmlDtdPtr      xml_dtd;
-      xmlValidCtxt   xml_context;
-
-      atList *       xml_document_list;
+      u_char *           ring_buffer;
+      u_long             ring_size;
+      u_long             ring_head;
+      u_long             ring_tail;
+      u_long             scan_pos;
+      bool               between_documents;
+
+      u_char *           doc_buffer;
+      u_long             doc_buffer_size;
+
+      char               xml_header[MAX_XML_TAG_SIZE];
+      char               xml_footer[MAX_XML_TAG_SIZE];
+      char               xml_root[MAX_XML_TAG_SIZE];
+      u_long             footer_len;
+      int                footer_table[MAX_XML_TAG_SIZE];
+      u_long             footer_matched;
+
+      xmlDtdPtr          xml_dtd;
+      xmlValidCtxt       xml_context;
+
+      atList *           xml_document_list;
+
+      bool               streaming_mode;
+      bool               build_documents;
+      atXMLHandler *     xml_handler;
+      xmlParserCtxtPtr   push_context;
+      bool               document_started;
+      bool               document_wrong_type;
+      int                element_depth;
+
+      char **            attr_list;
+      u_long             attr_list_size;
+      char *             attr_text;
+      u_long             attr_text_size;
+
+      void           initBuffer(char * xmlName);
 
       float          xmlToFloat(xmlChar * tmpStr);
       int            xmlToInt(xmlChar * tmpStr);
 
-      void           checkBufferSize(u_long sizeNeeded);
-      void           processXMLDocument();
+      void           appendToRing(u_char * data, u_long len);
+      void           consumeRing(u_long endPos);
+      void           pushToParser(u_long endPos, bool lastChunk);
+      u_char *       getDocumentText(u_long endPos, u_long * len);
+
+      void           processXMLDocument(u_char * text, u_long len);
+      void           finishXMLDocument(xmlDocPtr doc);
+      void           clearDocumentList();
+
+      void           startPushDocument();
+      void           endPushDocument();
+
+      static u_long  decodeAttributeValue(char * dest,
+                                          const xmlChar * start,
+                                          const xmlChar * end);
+
+      static void    saxStartDocument(void * ctx);
+      static void    saxInternalSubset(void * ctx, const xmlChar * name,
+                                       const xmlChar * externalID,
+                                       const xmlChar * systemID);
+      static void    saxStartElement(void * ctx, const xmlChar * localName,
+                                     const xmlChar * prefix,
+                                     const xmlChar * uri, int numNamespaces,
+                                     const xmlChar ** namespaces,
+                                     int numAttributes, int numDefaulted,
+                                     const xmlChar ** attributes);
+      static void    saxEndElement(void * ctx, const xmlChar * localName,
+                                   const xmlChar * prefix,
+                                   const xmlChar * uri);
+      static void    saxCharacters(void * ctx, const xmlChar * text,
+                                   int len);
+      static void    saxCDataBlock(void * ctx, const xmlChar * text,
+                                   int len);
 
    public:
       atXMLBuffer(char * xmlName);
       atXMLBuffer(char * xmlName, char * dtdFilename);
       virtual ~atXMLBuffer();
 
+      // Streaming mode feeds the data to the XML parser as it arrives
+      // (instead of collecting each document and parsing it at the end),
+      // calling the handler (if any) as elements are parsed.  Documents
+      // are still returned from processBuffer() if buildDocuments is true
+      void       enableStreaming(atXMLHandler * handler, bool buildDocuments);
+      void       disableStreaming();
+      bool       isStreaming();
+
       atList *   processBuffer(atBufferHandler * packetBuffer);
+      atList *   processData(u_char * data, u_long len);
 };
 
 #endif
-
@@ -0,0 +1,86 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "atXMLHandler.h++"
+
+
+atXMLHandler::atXMLHandler()
+{
+}
+
+
+atXMLHandler::~atXMLHandler()
+{
+}
+
+
+void atXMLHandler::startDocument()
+{
+   // Called when a new document begins
+}
+
+
+void atXMLHandler::endDocument(atXMLDocument * doc)
+{
+   // Called when a document ends.  The document is only passed if the
+   // buffer was asked to build documents (and the document was valid);
+   // otherwise, it's NULL.  The buffer keeps ownership either way.
+}
+
+
+void atXMLHandler::startElement(char * name, char ** attributes)
+{
+   // The attributes come as a NULL-terminated list of name/value pairs,
+   // so pass each one along
+   if (attributes == NULL)
+      return;
+   while (attributes[0] != NULL)
+   {
+      attribute(name, attributes[0], attributes[1]);
+      attributes += 2;
+   }
+}
+
+
+void atXMLHandler::attribute(char * elementName, char * name, char * value)
+{
+   // Called for each attribute of an element (by startElement())
+}
+
+
+void atXMLHandler::endElement(char * name)
+{
+   // Called when an element ends
+}
+
+
+void atXMLHandler::characters(char * text, u_long len)
+{
+   // Called with text content (which isn't NULL-terminated and may come
+   // in more than one piece)
+}
+
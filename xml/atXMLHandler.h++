@@ -0,0 +1,60 @@
+
+// ATLAS: Adaptable Tool Library for Advanced Simulation
+//
+// Copyright 2015 University of Central Florida
+//
+//
+// This library provides many fundamental capabilities used in creating
+// virtual environment simulations.  It includes elements such as vectors,
+// matrices, quaternions, containers, communication schemes (UDP, TCP, DIS,
+// HLA, Bluetooth), and XML processing.  It also includes some extensions
+// to allow similar code to work in Linux and in Windows.  Note that support
+// for iOS and Android development is also included.
+//
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AT_XML_HANDLER_HPP
+#define AT_XML_HANDLER_HPP
+
+
+#include "atNotifier.h++"
+#include "atOSDefs.h++"
+#include "atXMLDocument.h++"
+
+
+// Receives parsing events from an atXMLBuffer in streaming mode.  Derive
+// from this class and override whichever calls are of interest (they all
+// do nothing by default, except startElement(), which hands each of the
+// element's attributes to attribute()).  Names and text are only valid
+// for the duration of the call.
+class ATLAS_SYM atXMLHandler : public atNotifier
+{
+   public:
+      atXMLHandler();
+      virtual ~atXMLHandler();
+
+      virtual void   startDocument();
+      virtual void   endDocument(atXMLDocument * doc);
+
+      virtual void   startElement(char * name, char ** attributes);
+      virtual void   attribute(char * elementName, char * name,
+                               char * value);
+      virtual void   endElement(char * name);
+      virtual void   characters(char * text, u_long len);
+};
+
+
+#endif
+